@@ -170,4 +170,14 @@ namespace RTT
         return Thread::setCpuAffinity(cpu);
     }
 
+    os::CpuSet Activity::getCpuSet() const
+    {
+        return Thread::getCpuSet();
+    }
+
+    bool Activity::setCpuSet(const os::CpuSet& cpus)
+    {
+        return Thread::setCpuSet(cpus);
+    }
+
 }
@@ -180,6 +180,10 @@ namespace RTT
 
         virtual bool setCpuAffinity(unsigned cpu);
 
+        virtual os::CpuSet getCpuSet() const;
+
+        virtual bool setCpuSet(const os::CpuSet& cpus);
+
         virtual os::ThreadInterface* thread();
 
         /**
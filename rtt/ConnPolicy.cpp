@@ -78,7 +78,7 @@ namespace RTT
     }
 
     ConnPolicy::ConnPolicy(int type /* = DATA*/, int lock_policy /*= LOCK_FREE*/)
-        : type(type), init(false), lock_policy(lock_policy), pull(false), size(0), transport(0), data_size(0) {}
+        : type(type), init(false), lock_policy(lock_policy), pull(false), oneway(false), size(0), transport(0), data_size(0) {}
 
     /** @cond */
     /** This is dead code. We use the boost::serialization now.
@@ -141,6 +141,13 @@ namespace RTT
             log(Error) <<"ConnPolicy: wrong property type of 'pull'."<<endlog();
             return false;
         }
+        b = bag.getProperty("oneway");
+        if ( b.ready() )
+            result.oneway = b.get();
+        else if ( bag.find("oneway") ){
+            log(Error) <<"ConnPolicy: wrong property type of 'oneway'."<<endlog();
+            return false;
+        }
 
         s = bag.getProperty("name_id");
         if ( s.ready() )
@@ -164,6 +171,7 @@ namespace RTT
         targetbag.ownProperty( new Property<bool>("init","Initialize flag", cp.init));
         targetbag.ownProperty( new Property<int>("lock_policy","Locking Policy", cp.lock_policy));
         targetbag.ownProperty( new Property<bool>("pull","Fetch data over network", cp.pull));
+        targetbag.ownProperty( new Property<bool>("oneway","Push data without waiting for each write", cp.oneway));
         targetbag.ownProperty( new Property<int>("size","The size of a buffered connection", cp.size));
         targetbag.ownProperty( new Property<int>("transport","The prefered transport. Set to zero if unsure.", cp.transport));
         targetbag.ownProperty( new Property<int>("data_size","A hint about the data size of a single data sample. Set to zero if unsure.", cp.transport));
@@ -55,11 +55,14 @@ namespace RTT {
      *       \a size number of elements can be stored until the reader reads
      *       them. BUFFER drops newer samples on full, CIRCULAR_BUFFER drops older samples on full.
      *       UNBUFFERED is only valid for output streaming connections.
-     *  <li> the locking policy: LOCKED, LOCK_FREE or UNSYNC. This defines how locking is done in the
-     *       connection. For now, only three policies are available. LOCKED uses
-     *       mutexes, LOCK_FREE uses a lock free method and UNSYNC means there's no
-     *       synchronisation at all (not thread safe). The latter should
+     *  <li> the locking policy: LOCKED, LOCK_FREE, LOCK_FREE_SPSC or UNSYNC. This defines how locking is done in the
+     *       connection. LOCKED uses mutexes, LOCK_FREE uses a lock free method,
+     *       LOCK_FREE_SPSC uses a wait-free method which only allows one writer and one reader thread
+     *       and UNSYNC means there's no synchronisation at all (not thread safe). The latter should
      *       be used only when there is no contention (simultaneous write-read).
+     *       LOCK_FREE_SPSC is never chosen for you: only request it if a single thread
+     *       calls OutputPort::write() and a single thread reads the InputPort, since two
+     *       threads writing the same port corrupt or lose samples.
      *
      *  <li> if, upon connection, the last value that has been written on the
      *       writer end should be written on the connection as well to
@@ -72,6 +75,12 @@ namespace RTT {
      *       default), new data is actively pushed to the reader's process. In
      *       the pulled case, data must be requested by the reader.
      *
+     *  <li> if pushed data is sent without waiting for the reader to
+     *       acknowledge each write (oneway). This has an effect only on
+     *       multi-process communication. The reader grants the writer credit
+     *       for a window of samples, such that a slow reader still slows down
+     *       the writer, and reports the samples it lost.
+     *
      *  <li> the transport type. Can be used to force a certain kind of transports.
      *       The number is a RTT transport id. When the transport type is zero,
      *       local in-process communication is used, unless one of the ports is
@@ -100,6 +109,7 @@ namespace RTT {
         static const int UNSYNC    = 0;
         static const int LOCKED    = 1;
         static const int LOCK_FREE = 2;
+        static const int LOCK_FREE_SPSC = 3;
 
         /**
          * Create a policy for a (lock-free) fifo buffer connection of a given size.
@@ -155,6 +165,12 @@ namespace RTT {
          * data is available by base::ChannelElementBase::signal()
          */
         bool   pull;
+        /** If true, pushed data is sent to the remote side without waiting for
+         * an acknowledgement of each write. The number of samples in flight is
+         * bounded by the buffer \a size, or by a transport specific default for
+         * data connections. Has no effect if \a pull is set.
+         */
+        bool   oneway;
         /** If the connection is a buffered connection, the size of the buffer */
         int    size;
         /**
@@ -42,15 +42,19 @@
 #include "base/TaskCore.hpp"
 #include "rtt-fwd.hpp"
 #include "os/MutexLock.hpp"
-#include "internal/MWSRQueue.hpp"
+#include "os/CAS.hpp"
+#include "internal/SegmentedMWSRQueue.hpp"
 #include "TaskContext.hpp"
 #include "internal/CatchConfig.hpp"
 #include "extras/SlaveActivity.hpp"
+#include "os/MainThread.hpp"
 
 #include <boost/bind.hpp>
 #include <algorithm>
+#include <sstream>
 
-#define ORONUM_EE_MQUEUE_SIZE 100
+#define ORONUM_EE_QUEUE_SEGMENT_SIZE 32
+#define ORONUM_EE_QUEUE_SPARE_SEGMENTS 2
 
 namespace RTT
 {
@@ -64,11 +68,31 @@ namespace RTT
     using namespace std;
     using namespace detail;
     using namespace boost;
+    using internal::ExecutionProfiler;
+
+    namespace {
+        /**
+         * Marks a use of the queues of an engine, during which
+         * setQueueSize() does not delete them. The queues must be read
+         * after it was created. The thread of the engine marks each
+         * access too, since its activity may be started while the
+         * queues are replaced, but not while it executes a message.
+         */
+        struct QueueUse
+        {
+            os::AtomicInt& users;
+            QueueUse(os::AtomicInt& u) : users(u) { users.inc(); }
+            ~QueueUse() { users.dec(); }
+        };
+    }
 
     ExecutionEngine::ExecutionEngine( TaskCore* owner )
         : taskc(owner),
-          mqueue(new MWSRQueue<DisposableInterface*>(ORONUM_EE_MQUEUE_SIZE) ),
-          f_queue( new MWSRQueue<ExecutableInterface*>(ORONUM_EE_MQUEUE_SIZE) ),
+          mqueue(new SegmentedMWSRQueue<DisposableInterface*>(ORONUM_EE_QUEUE_SEGMENT_SIZE, ORONUM_EE_QUEUE_SPARE_SEGMENTS) ),
+          uqueue(new SegmentedMWSRQueue<DisposableInterface*>(ORONUM_EE_QUEUE_SEGMENT_SIZE, ORONUM_EE_QUEUE_SPARE_SEGMENTS) ),
+          f_queue( new SegmentedMWSRQueue<ExecutableInterface*>(ORONUM_EE_QUEUE_SEGMENT_SIZE, ORONUM_EE_QUEUE_SPARE_SEGMENTS) ),
+          queue_users(0), msg_waiters(0), wake_pending(0), msg_count(0), wakeup_count(0), suppressed_count(0),
+          wake_time(0), msg_budget(0), msg_budget_time(0), msg_hwm(0), deferred_count(0),
           mmaster(0)
     {
     }
@@ -89,10 +113,13 @@ namespace RTT
             foo->unloaded();
 
         DisposableInterface* dis;
+        while ( uqueue->dequeue( dis ) )
+            dis->dispose();
         while ( mqueue->dequeue( dis ) )
             dis->dispose();
 
         delete f_queue;
+        delete uqueue;
         delete mqueue;
     }
 
@@ -102,31 +129,52 @@ namespace RTT
 
     void ExecutionEngine::addChild(TaskCore* tc) {
         children.push_back( tc );
+        // a TaskContext renames its entries once its name is known.
+        std::ostringstream name;
+        name << "child" << children.size();
+        profiler.addChild( tc, name.str() );
     }
 
     void ExecutionEngine::removeChild(TaskCore* tc) {
         vector<TaskCore*>::iterator it = find (children.begin(), children.end(), tc );
         if ( it != children.end() )
             children.erase(it);
+        profiler.removeChild( tc );
     }
 
     void ExecutionEngine::processFunctions()
     {
         // Execute all loaded Functions :
         ExecutableInterface* foo = 0;
-        int nbr = f_queue->size(); // nbr to process.
+        int nbr = 0; // nbr to process.
+        {
+            QueueUse use(queue_users);
+            nbr = f_queue->size();
+        }
         // 1. Fetch new ones from queue.
-        while ( f_queue->dequeue(foo) ) {
+        nsecs round = nbr ? profiler.start() : 0;
+        while ( true ) {
+            {
+                QueueUse use(queue_users);
+                if ( !f_queue->dequeue(foo) )
+                    break;
+            }
             assert(foo);
-            if ( foo->execute() == false ){
+            nsecs start = profiler.start();
+            bool again = foo->execute();
+            profiler.recordFunction( foo, start );
+            if ( again == false ){
+                profiler.releaseFunction( foo );
                 foo->unloaded();
                 msg_cond.broadcast(); // required for waitForFunctions() (3rd party thread)
             } else {
+                QueueUse use(queue_users);
                 f_queue->enqueue( foo );
             }
             if ( --nbr == 0) // we did a round-trip
                 break;
         }
+        profiler.record( ExecutionProfiler::Functions, round );
     }
 
     bool ExecutionEngine::runFunction( ExecutableInterface* f )
@@ -136,7 +184,11 @@ namespace RTT
             if (taskc && taskc->mTaskState == TaskCore::FatalError )
                 return false;
             f->loaded(this);
-            bool result = f_queue->enqueue( f );
+            bool result;
+            {
+                QueueUse use(queue_users);
+                result = f_queue->enqueue( f );
+            }
             // signal work is to be done:
             this->getActivity()->trigger();
             return result;
@@ -190,12 +242,14 @@ namespace RTT
         // since this function is executed in process messages, it is always safe to execute.
         if ( !f )
             return false;
+        QueueUse use(queue_users);
         int nbr = f_queue->size();
         while (nbr != 0) {
             ExecutableInterface* foo = 0;
             if ( !f_queue->dequeue(foo) )
                 return false;
             if ( f  == foo) {
+                profiler.releaseFunction( f );
                 return true;
             }
             f_queue->enqueue(foo);
@@ -211,18 +265,118 @@ namespace RTT
 
     bool ExecutionEngine::hasWork()
     {
-        return !mqueue->isEmpty();
+        QueueUse use(queue_users);
+        return !mqueue->isEmpty() || !uqueue->isEmpty();
+    }
+
+    namespace {
+        /**
+         * Moves the elements of \a q to \a nq and deletes \a q. Only
+         * called once no other thread uses \a q anymore.
+         */
+        template<class T>
+        void moveQueue(SegmentedMWSRQueue<T>* q, SegmentedMWSRQueue<T>* nq)
+        {
+            T item;
+            while ( q->dequeue(item) )
+                nq->enqueue(item);
+            delete q;
+        }
+    }
+
+    bool ExecutionEngine::setQueueSize(unsigned int segment_size, unsigned int spare_segments)
+    {
+        MutexLock locker( resize_lock );
+        if ( this->getActivity() && this->getActivity()->isActive() )
+            return false;
+        SegmentedMWSRQueue<DisposableInterface*>* nm = new SegmentedMWSRQueue<DisposableInterface*>(segment_size, spare_segments);
+        SegmentedMWSRQueue<DisposableInterface*>* nu = new SegmentedMWSRQueue<DisposableInterface*>(segment_size, spare_segments);
+        SegmentedMWSRQueue<ExecutableInterface*>* nf = new SegmentedMWSRQueue<ExecutableInterface*>(segment_size, spare_segments);
+        SegmentedMWSRQueue<DisposableInterface*>* om = mqueue;
+        SegmentedMWSRQueue<DisposableInterface*>* ou = uqueue;
+        SegmentedMWSRQueue<ExecutableInterface*>* of = f_queue;
+        // CAS orders these stores before the read of queue_users below,
+        // so a thread that is not counted there uses the new queues.
+        os::CAS(&mqueue, om, nm);
+        os::CAS(&uqueue, ou, nu);
+        os::CAS(&f_queue, of, nf);
+        while ( queue_users.read() != 0 )
+            os::MainThread::Instance()->yield();
+        moveQueue(om, nm);
+        moveQueue(ou, nu);
+        moveQueue(of, nf);
+        return true;
+    }
+
+    unsigned int ExecutionEngine::getMessageQueueCapacity() const
+    {
+        QueueUse use(queue_users);
+        return mqueue->capacity() + uqueue->capacity();
+    }
+
+    unsigned int ExecutionEngine::getAllocatedSegmentCount() const
+    {
+        QueueUse use(queue_users);
+        return mqueue->allocatedSegments() + uqueue->allocatedSegments() + f_queue->allocatedSegments();
+    }
+
+    void ExecutionEngine::setMessageBudget(unsigned int max_count, Seconds max_time)
+    {
+        msg_budget = max_count;
+        msg_budget_time = max_time > 0 ? Seconds_to_nsecs(max_time) : 0;
+    }
+
+    Seconds ExecutionEngine::getMessageBudgetTime() const
+    {
+        return nsecs_to_Seconds(msg_budget_time);
+    }
+
+    int ExecutionEngine::getPendingMessageCount() const
+    {
+        QueueUse use(queue_users);
+        return mqueue->size() + uqueue->size();
+    }
+
+    void ExecutionEngine::resetMessageStatistics()
+    {
+        msg_hwm.set(0);
+        deferred_count.set(0);
+        msg_wait.reset();
     }
 
     void ExecutionEngine::processMessages()
     {
-        // execute all commands from the AtomicQueue.
+        // execute all commands from the AtomicQueues, urgent ones first.
         // msg_lock may not be held when entering this function !
+        nsecs start = ExecutionProfiler::now();
+        // Clear the pending wake-up before emptying the queues, such that
+        // any message queued from now on wakes us up again.
+        if ( wake_pending ) {
+            nsecs woken = wake_time;
+            if ( os::CAS(&wake_pending, 1, 0) && woken != 0 && start >= woken )
+                msg_wait.record( start - woken );
+        }
+        int depth = getPendingMessageCount();
+        if ( depth > msg_hwm.read() )
+            msg_hwm.set( depth );
         DisposableInterface* com(0);
+        unsigned int count = 0;
+        bool spent = false;
         {
-            while ( mqueue->dequeue(com) ) {
+            while ( true ) {
+                {
+                    QueueUse use(queue_users);
+                    if ( !uqueue->dequeue(com) && !mqueue->dequeue(com) )
+                        break;
+                }
                 assert( com );
                 com->executeAndDispose();
+                ++count;
+                if ( (msg_budget && count >= msg_budget)
+                     || (msg_budget_time && ExecutionProfiler::now() - start >= msg_budget_time) ) {
+                    spent = true;
+                    break;
+                }
             }
             // there's no need to hold the lock during
             // emptying the queue. But we must hold the
@@ -232,8 +386,18 @@ namespace RTT
             // This allows us to recurse into processMessages.
             MutexLock locker( msg_lock );
         }
-        if ( com )
+        if ( com ) {
+            profiler.record( ExecutionProfiler::Messages, start );
             msg_cond.broadcast(); // required for waitForMessages() (3rd party thread)
+        }
+        // The remaining messages are processed in the next step, so we
+        // wake ourselves up unless a new message already did so.
+        if ( spent && getPendingMessageCount() != 0 ) {
+            deferred_count.inc();
+            wake_time = ExecutionProfiler::now();
+            if ( os::CAS(&wake_pending, 0, 1) && this->getActivity() )
+                this->getActivity()->trigger();
+        }
     }
 
     bool ExecutionEngine::process( DisposableInterface* c )
@@ -248,10 +412,35 @@ namespace RTT
             if (taskc && taskc->mTaskState == TaskCore::FatalError )
                 return false;
 
-            bool result = mqueue->enqueue( c );
+            bool result;
+            {
+                QueueUse use(queue_users);
+                result = c->isUrgent() ? uqueue->enqueue( c ) : mqueue->enqueue( c );
+            }
+            if ( !result )
+                return false;
+            msg_count.inc();
+            // Only the first message since the last processMessages() sets
+            // the time from which the waiting time of messages is measured.
+            if ( wake_pending == 0 )
+                wake_time = ExecutionProfiler::now();
+            // Only the first message since the last processMessages() needs
+            // to wake us up, the others will be processed in the same run.
+            if ( !os::CAS(&wake_pending, 0, 1) ) {
+                suppressed_count.inc();
+                return true;
+            }
+            wakeup_count.inc();
             this->getActivity()->trigger();
-            msg_cond.broadcast(); // required for waitAndProcessMessages() (EE thread)
-            return result;
+            // Only waitAndProcessMessages() (EE thread) waits for new messages.
+            // It registers in msg_waiters before checking the queues under
+            // msg_lock, so taking the lock guarantees that it either sees the
+            // message or is already waiting for the broadcast.
+            if ( msg_waiters.read() != 0 ) {
+                { MutexLock locker( msg_lock ); }
+                msg_cond.broadcast();
+            }
+            return true;
         }
         return false;
     }
@@ -293,6 +482,8 @@ namespace RTT
         } else {
             setMaster(0);
         }
+        // The new activity needs to be woken up for messages that are still queued.
+        wake_pending = 0;
         RTT::base::RunnableInterface::setActivity(task);
     }
 
@@ -318,7 +509,13 @@ namespace RTT
                 // We must lock because the cond variable will unlock msg_lock.
                 os::MutexLock lock(msg_lock);
                 if (!pred()) {
-                    msg_cond.wait(msg_lock); // now processMessages may run.
+                    // process() does not broadcast for messages that arrived
+                    // while an earlier one was still pending, nor when nobody
+                    // waits, so register first and then check the queue.
+                    msg_waiters.inc();
+                    if ( !hasWork() )
+                        msg_cond.wait(msg_lock); // now processMessages may run.
+                    msg_waiters.dec();
                 } else {
                     return; // do not process messages when pred() == true;
                 }
@@ -355,8 +552,12 @@ namespace RTT
         if ( taskc ) {
             // A trigger() in startHook() will be ignored, we trigger in TaskCore after startHook finishes.
             if ( taskc->mTaskState == TaskCore::Running && taskc->mTargetState == TaskCore::Running ) {
+                nsecs start = profiler.start();
+                nsecs update = 0;
                 TRY (
                     taskc->prepareUpdateHook();
+                    profiler.record( ExecutionProfiler::PrepareUpdateHook, start );
+                    update = profiler.start();
                     taskc->updateHook();
                 ) CATCH(std::exception const& e,
                     log(Error) << "in updateHook(): switching to exception state because of unhandled exception" << endlog();
@@ -366,9 +567,11 @@ namespace RTT
                     log(Error) << "in updateHook(): switching to exception state because of unhandled exception" << endlog();
                     taskc->exception(); // calls stopHook,cleanupHook
                 )
+                profiler.record( ExecutionProfiler::UpdateHook, update );
             }
             // in case start() or updateHook() called error(), this will be called:
             if (taskc->mTaskState == TaskCore::RunTimeError && taskc->mTargetState >= TaskCore::Running) {
+                nsecs start = profiler.start();
                 TRY (
                     taskc->errorHook();
                 ) CATCH(std::exception const& e,
@@ -379,6 +582,7 @@ namespace RTT
                     log(Error) << "in errorHook(): switching to exception state because of unhandled exception" << endlog();
                     taskc->exception(); // calls stopHook,cleanupHook
                 )
+                profiler.record( ExecutionProfiler::ErrorHook, start );
             }
         }
         if ( !this->getActivity() || ! this->getActivity()->isRunning() ) return;
@@ -386,8 +590,12 @@ namespace RTT
         // call all children as well.
         for (std::vector<TaskCore*>::iterator it = children.begin(); it != children.end();++it) {
             if ( (*it)->mTaskState == TaskCore::Running  && (*it)->mTargetState == TaskCore::Running  ){
+                nsecs start = profiler.start();
+                nsecs update = 0;
                 TRY (
                     (*it)->prepareUpdateHook();
+                    profiler.recordChild( *it, ExecutionProfiler::PrepareUpdateHook, start );
+                    update = profiler.start();
                     (*it)->updateHook();
                 ) CATCH(std::exception const& e,
                     log(Error) << "in updateHook(): switching to exception state because of unhandled exception" << endlog();
@@ -397,8 +605,10 @@ namespace RTT
                     log(Error) << "in updateHook(): switching to exception state because of unhandled exception" << endlog();
                     (*it)->exception(); // calls stopHook,cleanupHook
                 )
+                profiler.recordChild( *it, ExecutionProfiler::UpdateHook, update );
             }
             if ((*it)->mTaskState == TaskCore::RunTimeError && (*it)->mTargetState == TaskCore::RunTimeError){
+                nsecs start = profiler.start();
                 TRY (
                     (*it)->errorHook();
                 ) CATCH(std::exception const& e,
@@ -409,6 +619,7 @@ namespace RTT
                     log(Error) << "in errorHook(): switching to exception state because of unhandled exception" << endlog();
                     (*it)->exception(); // calls stopHook,cleanupHook
                 )
+                profiler.recordChild( *it, ExecutionProfiler::ErrorHook, start );
             }
             if ( !this->getActivity() || ! this->getActivity()->isRunning() ) return;
         }
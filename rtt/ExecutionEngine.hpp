@@ -42,11 +42,14 @@
 #include "os/Mutex.hpp"
 #include "os/MutexLock.hpp"
 #include "os/Condition.hpp"
+#include "os/Atomic.hpp"
 #include "base/RunnableInterface.hpp"
 #include "base/ActivityInterface.hpp"
 #include "base/DisposableInterface.hpp"
 #include "base/ExecutableInterface.hpp"
 #include "internal/List.hpp"
+#include "internal/ExecutionProfiler.hpp"
+#include "os/JitterHistogram.hpp"
 #include <vector>
 #include <boost/function.hpp>
 
@@ -111,9 +114,10 @@ namespace RTT
         /**
          * Queue and execute (process) a given message. The message is
          * executed in step() or loop() directly after all other
-         * queued ActionInterface objects. The constructor parameter
-         * \a queue_size limits how many messages can be queued in
-         * between step()s or loop().
+         * queued ActionInterface objects. The queue grows when a
+         * burst of messages arrives, see setQueueSize().
+         * Urgent messages are queued separately and executed before
+         * the others.
          *
          * @return true if the message got accepted, false otherwise.
          * @return false when the MessageProcessor is not running or does not accept messages.
@@ -121,6 +125,120 @@ namespace RTT
          */
         virtual bool process(base::DisposableInterface* c);
 
+        /**
+         * Returns the number of messages accepted by process() since
+         * this engine was created.
+         */
+        int getMessageCount() const { return msg_count.read(); }
+
+        /**
+         * Returns the number of times process() woke up the activity
+         * of this engine.
+         */
+        int getWakeupCount() const { return wakeup_count.read(); }
+
+        /**
+         * Returns the number of times process() did not need to wake up
+         * the activity of this engine, because an earlier message already
+         * did so and the engine did not process its messages yet.
+         * This is always getMessageCount() - getWakeupCount().
+         */
+        int getSuppressedWakeupCount() const { return suppressed_count.read(); }
+
+        /**
+         * Sets the size of the message and function queues. Each queue
+         * consists of segments of \a segment_size elements, and grows
+         * by one segment whenever it is full. The first segment and
+         * \a spare_segments more are allocated by this function, others
+         * are allocated while the queue grows and kept for later bursts.
+         * Queued messages and functions are preserved. Other threads may
+         * keep calling process() and runFunction() meanwhile: the queues
+         * are replaced atomically, and the old ones are only deleted when
+         * no thread uses them anymore. This includes the thread of this
+         * engine, so its activity may be started meanwhile. Messages which
+         * arrive while the queues are replaced may be processed before
+         * older ones.
+         * @return false if the activity of this engine is running.
+         */
+        bool setQueueSize(unsigned int segment_size, unsigned int spare_segments);
+
+        /**
+         * Returns the number of messages the message queues can hold
+         * without allocating more segments.
+         */
+        unsigned int getMessageQueueCapacity() const;
+
+        /**
+         * Returns the number of segments the queues of this engine
+         * allocated because a burst exceeded their spare segments.
+         * If this number keeps growing, increase the spare segments
+         * with setQueueSize().
+         */
+        unsigned int getAllocatedSegmentCount() const;
+
+        /**
+         * Limits the work processMessages() does in one step(). Messages
+         * beyond the budget stay queued and are processed in the next
+         * step(), such that a burst of operation calls can not delay the
+         * updateHook() of the owner for an unbounded time. At least one
+         * message is processed in each step. Urgent messages (see
+         * Operation::urgent()) are always processed before the others.
+         * @param max_count The maximum number of messages processed in
+         * one step, or zero for no limit.
+         * @param max_time The maximum time spent on messages in one step,
+         * or zero for no limit.
+         */
+        void setMessageBudget(unsigned int max_count, Seconds max_time = 0);
+
+        /**
+         * Returns the maximum number of messages processed in one step,
+         * zero if unlimited.
+         */
+        unsigned int getMessageBudgetCount() const { return msg_budget; }
+
+        /**
+         * Returns the maximum time spent on messages in one step,
+         * zero if unlimited.
+         */
+        Seconds getMessageBudgetTime() const;
+
+        /**
+         * Returns the number of messages that are queued and not yet processed.
+         */
+        int getPendingMessageCount() const;
+
+        /**
+         * Returns the largest number of queued messages a step() found
+         * since the creation of this engine or the last
+         * resetMessageStatistics().
+         */
+        int getPendingMessageHighWatermark() const { return msg_hwm.read(); }
+
+        /**
+         * Returns the number of steps that left messages queued because
+         * the message budget was spent.
+         */
+        int getDeferredCount() const { return deferred_count.read(); }
+
+        /**
+         * Returns the time messages waited between the wake-up of this
+         * engine and the start of their processing.
+         */
+        os::JitterStatistics getMessageWaitStatistics() const { return msg_wait.getStatistics(); }
+
+        /**
+         * Clears the high watermark, the deferred count and the wait
+         * time statistics.
+         */
+        void resetMessageStatistics();
+
+        /**
+         * Returns the execution times of the hooks of the owner of this
+         * engine, of the messages and of the functions it processed.
+         * The hooks of each child are measured separately.
+         */
+        internal::ExecutionProfiler& getProfiler() { return profiler; }
+
         /**
          * Run a given function in step() or loop(). The function may only
          * be destroyed after the
@@ -251,17 +369,59 @@ namespace RTT
         /**
          * Our Message queue
          */
-        internal::MWSRQueue<base::DisposableInterface*>* mqueue;
+        internal::SegmentedMWSRQueue<base::DisposableInterface*>* volatile mqueue;
+
+        /**
+         * Our queue for urgent messages, which are processed before
+         * those in mqueue.
+         */
+        internal::SegmentedMWSRQueue<base::DisposableInterface*>* volatile uqueue;
 
         std::vector<base::TaskCore*> children;
 
         /**
          * Stores all functions we're executing.
          */
-        internal::MWSRQueue<base::ExecutableInterface*>* f_queue;
+        internal::SegmentedMWSRQueue<base::ExecutableInterface*>* volatile f_queue;
+
+        /**
+         * The number of threads which use the queues from outside the
+         * thread of this engine. setQueueSize() only deletes a queue it
+         * replaced when this is zero.
+         */
+        mutable os::AtomicInt queue_users;
+        /// Serialises setQueueSize().
+        os::Mutex resize_lock;
 
         os::Mutex msg_lock;
         os::Condition msg_cond;
+        /// The number of threads in waitAndProcessMessages() which wait on msg_cond.
+        os::AtomicInt msg_waiters;
+
+        /**
+         * Set by the first process() call that wakes up the activity
+         * and cleared by processMessages(), such that a burst of
+         * messages causes only one trigger() and broadcast().
+         */
+        volatile int wake_pending;
+
+        os::AtomicInt msg_count;
+        os::AtomicInt wakeup_count;
+        os::AtomicInt suppressed_count;
+
+        /**
+         * The time at which wake_pending was set, used to measure the
+         * time messages wait before they are processed.
+         */
+        volatile nsecs wake_time;
+
+        unsigned int msg_budget;
+        nsecs msg_budget_time;
+        os::AtomicInt msg_hwm;
+        os::AtomicInt deferred_count;
+        os::JitterHistogram msg_wait;
+
+        internal::ExecutionProfiler profiler;
 
         /**
          * A master ExecutionEngine which should process our messages.
@@ -84,6 +84,30 @@ namespace RTT
             return false;
         }
 
+        bool do_read_shared(boost::shared_ptr<const T>& sample, FlowStatus& result, bool copy_old_data, const internal::ConnectionManager::ChannelDescriptor& descriptor)
+        {
+            typename base::ChannelElement<T>::shared_ptr input = static_cast< base::ChannelElement<T>* >( descriptor.get<1>().get() );
+            assert( result != NewData );
+            if ( input ) {
+                FlowStatus tresult = input->readShared(sample, copy_old_data);
+                if (tresult == NewData) {
+                    result = tresult;
+                    return true;
+                }
+                if (tresult > result)
+                    result = tresult;
+            }
+            return false;
+        }
+
+        bool do_read_many(std::vector<T>& samples, size_t& count, size_t max, const internal::ConnectionManager::ChannelDescriptor& descriptor)
+        {
+            typename base::ChannelElement<T>::shared_ptr input = static_cast< base::ChannelElement<T>* >( descriptor.get<1>().get() );
+            if ( input )
+                count = input->readMany(samples, max);
+            return count != 0;
+        }
+
         /**
          * You are not allowed to copy ports.
          * In case you want to create a container of ports,
@@ -157,6 +181,41 @@ namespace RTT
         }
 
 
+        /** Reads at most \a max new samples from this port, the oldest first.
+         * Buffered connections hand them over in one go, which is cheaper than
+         * calling read() for each sample. Reserve \a max elements in \a samples
+         * beforehand to keep this real-time.
+         *
+         * Only new data is returned. The last sample read can afterwards
+         * be read again as RTT::OldData with read().
+         * @return the number of samples stored in \a samples.
+         */
+        size_t readMany(std::vector<T>& samples, size_t max)
+        {
+            size_t count = 0;
+            samples.clear();
+            cmanager.select_reader_channel( boost::bind( &InputPort::do_read_many, this, boost::ref(samples), boost::ref(count), max, _2 ), false );
+            return count;
+        }
+
+        /** Reads a sample from the connection without copying it, if the
+         * connection's buffer allows it (a buffered connection with the
+         * LOCK_FREE or LOCK_FREE_SPSC policy). \a sample then points
+         * directly to the data written by the OutputPort. Otherwise, \a sample
+         * points to a copy. The return value and \a copy_old_data behave as in read().
+         *
+         * The sample is read-only and remains valid for as long as it is
+         * referenced. While it is referenced, its slot in the buffer cannot be
+         * reused. So holding on to many samples reduces the buffer size
+         * available to the writer.
+         */
+        FlowStatus readShared(boost::shared_ptr<const T>& sample, bool copy_old_data = true)
+        {
+            FlowStatus result = NoData;
+            cmanager.select_reader_channel( boost::bind( &InputPort::do_read_shared, this, boost::ref(sample), boost::ref(result), _1, _2 ), copy_old_data );
+            return result;
+        }
+
         /** Read all new samples that are available on this port, and returns
          * the last one.
          *
@@ -43,7 +43,14 @@
 #include "os/TimeService.hpp"
 
 #include "Logger.hpp"
+#include "Activity.hpp"
+#include "os/Atomic.hpp"
+#include "os/Semaphore.hpp"
+#include "internal/TsPool.hpp"
+#include "internal/AtomicMWSRQueue.hpp"
 #include <iomanip>
+#include <cstdio>
+#include <cstring>
 
 #ifdef OROSEM_PRINTF_LOGGING
 #  include <stdio.h>
@@ -65,6 +72,13 @@
 #include "rtt-config.h"
 #include "rtt-fwd.hpp"
 
+// The asynchronous logger needs thread-local storage for the line each thread composes.
+#if defined(__GNUC__)
+#  define ORO_LOGGER_THREAD __thread
+#elif defined(_MSC_VER)
+#  define ORO_LOGGER_THREAD __declspec(thread)
+#endif
+
 namespace RTT
 {
     using namespace std;
@@ -122,6 +136,25 @@ namespace RTT
         return Instance()->operator<<( ll );
     }
 
+    /**
+     * A log line, as composed by one thread and queued for the writer thread.
+     */
+    struct Logger::Record
+    {
+        enum { Size = 1024, HeadSize = 128 };
+        LogLevel level;
+        bool tostd, tofile, flush;
+        /// The length of \a text.
+        int length;
+        /// The stream state of the composing thread, see AsyncLine.
+        std::ios_base::fmtflags flags;
+        std::streamsize precision, width;
+        char fill;
+        /// The time, level and module.
+        char head[HeadSize];
+        char text[Size];
+    };
+
     /**
      * This hidden struct stores all data structures required for logging.
      */
@@ -147,13 +180,22 @@ namespace RTT
               timestamp(0),
               started(false), showtime(true), allowRT(false),
               mlogStdOut(true), mlogFile(true),
-              moduleptr("Logger")
+              moduleptr("Logger"),
+              async(false), writer(0), records(0), queue(0),
+              dropped(0), reported_dropped(0), pool_id(0)
         {
 #if defined(OROSEM_FILE_LOGGING) && !defined(OROSEM_LOG4CPP_LOGGING) && defined(OROSEM_PRINTF_LOGGING)
             logfile = fopen(logfile_name ? logfile_name : "orocos.log","w");
 #endif
         }
 
+        ~D()
+        {
+            delete writer;
+            delete queue;
+            delete records;
+        }
+
         bool maylog() const {
             if (!started || (outloglevel == RealTime && allowRT == false))
                 return false;
@@ -161,13 +203,21 @@ namespace RTT
         }
 
         bool maylogStdOut() const {
-            if ( inloglevel <= outloglevel && outloglevel != Never && inloglevel != Never && mlogStdOut)
+            return maylogStdOut(inloglevel);
+        }
+
+        bool maylogStdOut(LogLevel ll) const {
+            if ( ll <= outloglevel && outloglevel != Never && ll != Never && mlogStdOut)
                 return true;
             return false;
         }
 
         bool maylogFile() const {
-            if ( (inloglevel <= Info || inloglevel <= outloglevel)  && mlogFile)
+            return maylogFile(inloglevel);
+        }
+
+        bool maylogFile(LogLevel ll) const {
+            if ( (ll <= Info || ll <= outloglevel)  && mlogFile)
                 return true;
             return false;
         }
@@ -180,6 +230,10 @@ namespace RTT
         void logit(std::ostream& (*pf)(std::ostream&))
         {
             // only on Logger::nl or Logger::endl, a time+log-line is written.
+#ifdef ORO_LOGGER_THREAD
+            // a line begun while logging asynchronously is not finished.
+            dropLine();
+#endif
             os::MutexLock lock( inpguard );
             std:: string res = showTime() +" " + showLevel(inloglevel) + showModule() + " ";
 
@@ -212,6 +266,186 @@ namespace RTT
             }
         }
 
+        /**
+         * The low priority thread that writes the queued records.
+         */
+        struct Writer : public Activity
+        {
+            D& d;
+            os::Semaphore sem;
+            volatile bool do_exit;
+
+            Writer(D& d)
+                : Activity(ORO_SCHED_OTHER, os::LowestPriority, 0.0, 0, "LogWriter"),
+                  d(d), sem(0), do_exit(false)
+            {}
+
+            bool initialize() { do_exit = false; return true; }
+
+            void loop() {
+                while ( !do_exit ) {
+                    sem.wait();
+                    d.drain();
+                }
+            }
+
+            bool breakLoop() { do_exit = true; sem.signal(); return true; }
+        };
+
+#ifdef ORO_LOGGER_THREAD
+        /**
+         * Returns the line the calling thread composes, or null.
+         */
+        Record* thisLine() const
+        {
+            return ( line && line_pool == pool_id ) ? line : 0;
+        }
+
+        LogLevel lineLevel() const
+        {
+            return line_level < 0 ? inloglevel : LogLevel(line_level);
+        }
+
+        /**
+         * Returns the line the calling thread composes, and takes a new
+         * record for it if it has none. Returns null if the line is not
+         * logged or no record is free.
+         */
+        Record* beginLine()
+        {
+            Record* rec = thisLine();
+            if ( rec || (line_dropped && line_pool == pool_id) )
+                return rec;
+            LogLevel level = lineLevel();
+            if ( !maylogStdOut(level) && !maylogFile(level) )
+                return 0;
+            line_pool = pool_id;
+            rec = records->allocate();
+            if ( rec == 0 ) {
+                dropped.inc();
+                line_dropped = true;
+                return 0;
+            }
+            rec->length = 0;
+            rec->flags = std::ios_base::skipws | std::ios_base::dec;
+            rec->precision = 6;
+            rec->width = 0;
+            rec->fill = ' ';
+            line = rec;
+            return rec;
+        }
+
+        /**
+         * Queues the line the calling thread composed for the writer
+         * thread. The level, module and time are those at the end of the line.
+         */
+        void endLine(bool flush)
+        {
+            Record* rec = beginLine();
+            line = 0;
+            line_dropped = false;
+            if ( rec == 0 )
+                return;
+            rec->level = lineLevel();
+            rec->tostd = maylogStdOut(rec->level);
+            rec->tofile = maylogFile(rec->level);
+            rec->flush = flush;
+            if ( !rec->tostd && !rec->tofile ) {
+                records->deallocate( rec );
+                return;
+            }
+            rec->text[rec->length] = 0;
+            prefix( *rec, line_module[0] ? line_module : "Logger" );
+            if ( !queue->enqueue( rec ) ) {
+                records->deallocate( rec );
+                dropped.inc();
+                return;
+            }
+            writer->sem.signal();
+        }
+
+        /**
+         * Forgets the line the calling thread composed, if any.
+         */
+        void dropLine()
+        {
+            Record* rec = thisLine();
+            line = 0;
+            line_dropped = false;
+            if ( rec )
+                records->deallocate( rec );
+        }
+
+#endif
+
+        /**
+         * Writes the time, level and module of \a rec in its head, as logit() does.
+         */
+        void prefix(Record& rec, const char* module) const
+        {
+            int n = 0;
+            if ( showtime )
+                n = snprintf( rec.head, Record::HeadSize, "%.3f", TimeService::Instance()->secondsSince(timestamp) );
+            if ( n < 0 || n >= Record::HeadSize )
+                n = 0;
+            snprintf( rec.head + n, Record::HeadSize - n, " %s[%s] ", levelName(rec.level), module );
+        }
+
+        /**
+         * Writes all queued records. Only called by the writer thread,
+         * or with inpguard locked once the writer thread is stopped.
+         */
+        void drain()
+        {
+            Record* rec;
+            while ( queue->dequeue( rec ) ) {
+                write( *rec );
+                records->deallocate( rec );
+            }
+            int count = dropped.read();
+            if ( count != reported_dropped ) {
+                Record msg;
+                msg.level = Warning;
+                msg.tostd = mlogStdOut && outloglevel >= Warning;
+                msg.tofile = mlogFile;
+                msg.flush = true;
+                prefix( msg, "Logger" );
+                snprintf( msg.text, Record::Size, "Dropped %d log messages because the log buffer was full.", count - reported_dropped );
+                write( msg );
+                reported_dropped = count;
+            }
+        }
+
+        void write(const Record& rec)
+        {
+            if ( rec.tostd ) {
+#ifndef OROSEM_PRINTF_LOGGING
+                *stdoutput << rec.head << rec.text << '\n';
+                if ( rec.flush )
+                    stdoutput->flush();
+#else
+                printf("%s%s\n", rec.head, rec.text );
+#endif
+            }
+#ifdef OROSEM_FILE_LOGGING
+            if ( rec.tofile ) {
+#if     defined(OROSEM_LOG4CPP_LOGGING)
+                category.log(level2Priority(rec.level), rec.text);
+#elif   !defined(OROSEM_PRINTF_LOGGING)
+                logfile << rec.head << rec.text << '\n';
+                if ( rec.flush )
+                    logfile.flush();
+#else
+                fprintf( logfile, "%s%s\n", rec.head, rec.text );
+#endif
+            }
+#endif
+#ifdef OROSEM_REMOTE_LOGGING
+            if ( rec.tofile )
+                remotestring.Push( std::string(rec.head) + rec.text );
+#endif
+        }
+
 #ifndef OROSEM_PRINTF_LOGGING
         std::ostream* stdoutput;
 #endif
@@ -270,38 +504,32 @@ namespace RTT
         /**
          * Convert a loglevel to a string representation.
          */
-        std::string showLevel( LogLevel ll) const {
-            std::string prefix;
+        static const char* levelName( LogLevel ll) {
             switch (ll)
                 {
                 case Fatal:
-                    prefix="[ FATAL  ]";
-                    break;
+                    return "[ FATAL  ]";
                 case Critical:
-                    prefix="[CRITICAL]";
-                    break;
+                    return "[CRITICAL]";
                 case Error:
-                    prefix="[ ERROR  ]";
-                    break;
+                    return "[ ERROR  ]";
                 case Warning:
-                    prefix="[ Warning]";
-                    break;
+                    return "[ Warning]";
                 case Info:
-                    prefix="[ Info   ]";
-                    break;
+                    return "[ Info   ]";
                 case Debug:
-                    prefix="[ Debug  ]";
-                    break;
+                    return "[ Debug  ]";
                 case RealTime:
-                    prefix="[RealTime]";
-                    break;
+                    return "[RealTime]";
                 case Never:
                     break;
                 }
-            return prefix;
+            return "";
         }
 
-
+        std::string showLevel( LogLevel ll) const {
+            return levelName(ll);
+        }
 
         std::string showModule() const
         {
@@ -320,8 +548,43 @@ namespace RTT
         std::string moduleptr;
 
         os::Mutex inpguard;
+
+        /// True if logit() queues the log lines for the writer thread.
+        bool async;
+        Writer* writer;
+        internal::TsPool<Record>* records;
+        internal::AtomicMWSRQueue<Record*>* queue;
+        os::AtomicInt dropped;
+        /// Only accessed by drain().
+        int reported_dropped;
+        /// Tells the records of this Logger apart from those of an earlier one.
+        int pool_id;
+        static int pools;
+
+#ifdef ORO_LOGGER_THREAD
+        enum { ModuleSize = 64 };
+        /// The line the calling thread composes, see beginLine().
+        static ORO_LOGGER_THREAD Record* line;
+        /// The pool_id of the Logger that \a line belongs to.
+        static ORO_LOGGER_THREAD int line_pool;
+        /// True if no record was free for the calling thread's line.
+        static ORO_LOGGER_THREAD bool line_dropped;
+        /// The level the calling thread set last, or -1.
+        static ORO_LOGGER_THREAD int line_level;
+        /// The module of the calling thread, see Logger::in().
+        static ORO_LOGGER_THREAD char line_module[ModuleSize];
+#endif
     };
 
+    int Logger::D::pools = 0;
+#ifdef ORO_LOGGER_THREAD
+    ORO_LOGGER_THREAD Logger::Record* Logger::D::line = 0;
+    ORO_LOGGER_THREAD int Logger::D::line_pool = 0;
+    ORO_LOGGER_THREAD bool Logger::D::line_dropped = false;
+    ORO_LOGGER_THREAD int Logger::D::line_level = -1;
+    ORO_LOGGER_THREAD char Logger::D::line_module[Logger::D::ModuleSize];
+#endif
+
     Logger::Logger(std::ostream& str)
         :d ( new Logger::D(str, getenv("ORO_LOGFILE")) ),
          inpguard(d->inpguard), logline(d->logline), fileline(d->fileline)
@@ -364,6 +627,45 @@ namespace RTT
         d->allowRT = false;
     }
 
+    void Logger::setAsynchronous(bool tf) {
+        if ( tf == d->async )
+            return;
+        if ( tf ) {
+#ifndef ORO_LOGGER_THREAD
+            *this << Logger::Error << "Asynchronous logging needs thread-local storage, which this compiler does not offer." << Logger::endl;
+            return;
+#endif
+            if ( d->writer == 0 ) {
+                enum { Records = 512 };
+                d->records = new internal::TsPool<Record>( Records );
+                d->queue = new internal::AtomicMWSRQueue<Record*>( Records );
+                d->writer = new D::Writer( *d );
+                d->pool_id = ++D::pools;
+            }
+            // don't hold inpguard: starting a thread logs.
+            if ( !d->writer->start() ) {
+                *this << Logger::Error << "Could not start the asynchronous log writer thread." << Logger::endl;
+                return;
+            }
+            os::MutexLock lock( d->inpguard );
+            d->async = true;
+        } else {
+            // lines logged while the writer stops are written below.
+            d->writer->stop();
+            os::MutexLock lock( d->inpguard );
+            d->async = false;
+            d->drain();
+        }
+    }
+
+    bool Logger::isAsynchronous() const {
+        return d->async;
+    }
+
+    unsigned int Logger::getDroppedMessages() const {
+        return d->dropped.read();
+    }
+
     TimeService::ticks Logger::getReferenceTime()const
     {
         return d->timestamp;
@@ -415,6 +717,14 @@ namespace RTT
     {
         if ( !d->maylog() )
             return *this;
+#ifdef ORO_LOGGER_THREAD
+        // asynchronously, each thread has a module of its own.
+        if ( d->async ) {
+            strncpy( D::line_module, modname.c_str(), D::ModuleSize - 1 );
+            D::line_module[D::ModuleSize - 1] = 0;
+            return *this;
+        }
+#endif
         os::MutexLock lock( d->inpguard );
         d->moduleptr = modname.c_str();
         return *this;
@@ -422,16 +732,16 @@ namespace RTT
 
     Logger& Logger::out(const std::string& oldmod)
     {
-        if ( !d->maylog() )
-            return *this;
-        os::MutexLock lock( d->inpguard );
-        d->moduleptr = oldmod.c_str();
-        return *this;
+        return this->in( oldmod );
     }
 
     std::string Logger::getLogModule() const {
         if ( !d->maylog() )
             return "";
+#ifdef ORO_LOGGER_THREAD
+        if ( d->async )
+            return D::line_module[0] ? D::line_module : "Logger";
+#endif
         os::MutexLock lock( d->inpguard );
         std::string ret = d->moduleptr.c_str();
         return ret;
@@ -495,6 +805,7 @@ namespace RTT
         if (!d->started)
             return;
         *this<<Logger::Info<<"Orocos Logging Deactivated." << Logger::endl;
+        this->setAsynchronous(false);
         this->logflush();
         d->started = false;
     }
@@ -525,6 +836,13 @@ namespace RTT
         if ( !d->maylog() )
             return *this;
 
+        if ( d->async ) {
+            AsyncLine line( *this );
+            if ( line.stream() )
+                *line.stream() << t;
+            return *this;
+        }
+
         os::MutexLock lock( d->inpguard );
         if ( d->maylogStdOut() )
             d->logline << t;
@@ -545,6 +863,9 @@ namespace RTT
         if ( !d->maylog() )
             return *this;
         d->inloglevel = ll;
+#ifdef ORO_LOGGER_THREAD
+        D::line_level = ll;
+#endif
         return *this;
     }
 
@@ -558,6 +879,11 @@ namespace RTT
             this->lognl();
         else if ( pf == Logger::flush )
             this->logflush();
+        else if ( d->async ) {
+            AsyncLine line( *this );
+            if ( line.stream() )
+                *line.stream() << pf;
+        }
         else {
             os::MutexLock lock( d->inpguard );
             if ( d->maylogStdOut() )
@@ -573,6 +899,9 @@ namespace RTT
     void Logger::logflush() {
         if (!d->maylog())
             return;
+        // the writer thread flushes after each completed line.
+        if ( d->async )
+            return;
         {
             // just flush all buffers, do not produce a new logline
             os::MutexLock lock( d->inpguard );
@@ -594,15 +923,54 @@ namespace RTT
     void Logger::lognl() {
         if (!d->maylog())
             return;
+#ifdef ORO_LOGGER_THREAD
+        if ( d->async ) {
+            d->endLine( false );
+            return;
+        }
+#endif
         d->logit( Logger::nl );
      }
 
     void Logger::logendl() {
         if (!d->maylog())
             return;
+#ifdef ORO_LOGGER_THREAD
+        if ( d->async ) {
+            d->endLine( true );
+            return;
+        }
+#endif
         d->logit( Logger::endl );
      }
 
+    Logger::AsyncLine::AsyncLine(Logger& logger)
+#ifdef ORO_LOGGER_THREAD
+        : rec( logger.d->beginLine() ), out( this )
+#else
+        : rec( 0 ), out( this )
+#endif
+    {
+        if ( rec == 0 )
+            return;
+        setp( rec->text + rec->length, rec->text + Record::Size - 1 );
+        out.flags( rec->flags );
+        out.precision( rec->precision );
+        out.width( rec->width );
+        out.fill( rec->fill );
+    }
+
+    Logger::AsyncLine::~AsyncLine()
+    {
+        if ( rec == 0 )
+            return;
+        rec->length = pptr() - rec->text;
+        rec->flags = out.flags();
+        rec->precision = out.precision();
+        rec->width = out.width();
+        rec->fill = out.fill();
+    }
+
     void Logger::setLogLevel( LogLevel ll ) {
         d->outloglevel = ll;
 #if defined(OROSEM_LOG4CPP_LOGGING)
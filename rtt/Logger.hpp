@@ -43,6 +43,7 @@
 #ifndef OROBLD_DISABLE_LOGGING
 #include <ostream>
 #include <sstream>
+#include <streambuf>
 #else
 #include <iosfwd>
 #endif
@@ -85,6 +86,11 @@ namespace RTT
      * to determine the output level until overriden by the application (if so).
      * The \a ORO_LOGLEVEL has the same effect on the 'orocos.log' file, but can not lower it below "Info".
      *
+     * With setAsynchronous(), each thread composes its lines in a preallocated
+     * record of its own, without taking a lock or allocating, and a low priority
+     * thread writes the completed lines. A thread that logs then never waits
+     * for another thread, the console or the disk.
+     *
      * @warning
      * Use Logger::RealTime to log from real-time threads. As long as the output LogLevel
      * is 6 or lower, these messages will not appear and do no harm to real-time performance.
@@ -142,6 +148,35 @@ namespace RTT
          */
         void mayLogFile(bool tf);
 
+        /**
+         * Toggles asynchronous logging. When enabled, each thread formats
+         * its line into a record taken from a lock-free pool, without the
+         * Logger's mutex or a heap allocation. Completed lines are queued
+         * in a lock-free buffer and a low priority thread writes them to
+         * the standard output stream and the log file, such that the
+         * logging thread never waits for I/O. Lines longer than 1024
+         * characters are truncated and lines are dropped when no record
+         * is free.
+         * The level set with log(LogLevel) and the module set with
+         * Logger::In then apply to the calling thread only. The level,
+         * module and time of a line are those at its end.
+         * Disabling it, or shutdown(), first writes all queued lines.
+         * This requires a compiler with thread-local storage.
+         */
+        void setAsynchronous(bool tf);
+
+        /**
+         * Returns true if log lines are written by a separate thread.
+         * @see setAsynchronous()
+         */
+        bool isAsynchronous() const;
+
+        /**
+         * Returns the number of log lines that were dropped because the
+         * buffer of the asynchronous logger was full.
+         */
+        unsigned int getDroppedMessages() const;
+
         /**
          * Notify the Logger in which 'module' the message occured. This returns an object
          * whose scope (i.e. {...} ) is indicative for the boundaries of the module.
@@ -319,6 +354,24 @@ namespace RTT
 #endif
 
     private:
+        struct Record;
+
+        /**
+         * Formats into the line the calling thread composes while logging
+         * asynchronously, with that thread's stream state. It takes no lock
+         * and writes into the line's preallocated record.
+         */
+        class RTT_API AsyncLine : public std::streambuf
+        {
+            Record* rec;
+            std::ostream out;
+        public:
+            AsyncLine(Logger& logger);
+            ~AsyncLine();
+            /// The stream to format into, or null if the line is not logged.
+            std::ostream* stream() { return rec ? &out : 0; }
+        };
+
         /**
          * Returns true if the next message will be logged.
          * Returns false if the LogLevel is RealTime and
@@ -17,6 +17,13 @@ namespace RTT
         if ( !mayLog() )
             return *this;
 
+        if ( isAsynchronous() ) {
+            AsyncLine line( *this );
+            if ( line.stream() )
+                *line.stream() << t;
+            return *this;
+        }
+
         os::MutexLock lock( inpguard );
         if ( this->mayLogStdOut() )
             logline << t;
@@ -51,6 +58,17 @@ namespace RTT
     inline void Logger::mayLogFile(bool ) {
     }
 
+    inline void Logger::setAsynchronous(bool) {
+    }
+
+    inline bool Logger::isAsynchronous() const {
+        return false;
+    }
+
+    inline unsigned int Logger::getDroppedMessages() const {
+        return 0;
+    }
+
     inline void Logger::allowRealTime() {
     }
 
@@ -136,6 +136,22 @@ namespace RTT
          */
         Operation<Signature>& arg(const std::string& name, const std::string& description) { marg(name, description); return *this; }
 
+        /**
+         * Marks this operation as urgent. When it is executed in the
+         * OwnThread, its calls are processed by the owner's ExecutionEngine
+         * before all non-urgent operation calls, even if these were
+         * queued earlier.
+         * @param u true to make this operation urgent, false to make it normal.
+         * @return A reference to this object.
+         * @see ExecutionEngine::setMessageBudget()
+         */
+        Operation<Signature>& urgent(bool u = true) { impl->setUrgent(u); return *this; }
+
+        /**
+         * Returns true if this operation was marked as urgent.
+         */
+        bool isUrgent() const { return impl->isUrgent(); }
+
         /**
          * Indicate that this operation calls a given function.
          * This will replace any previously registered function present in this operation.
@@ -147,7 +163,9 @@ namespace RTT
         Operation& calls(boost::function<Signature> func, ExecutionThread et = ClientThread, ExecutionEngine* ownerEngine = NULL ) {
             // creates a Local OperationCaller
             ExecutionEngine* null_caller = 0;
+            bool u = impl && impl->isUrgent();
             impl = boost::make_shared<internal::LocalOperationCaller<Signature> >(func, ownerEngine ? ownerEngine : this->mowner, null_caller, et);
+            impl->setUrgent(u);
 #ifdef ORO_SIGNALLING_OPERATIONS
             if (signal)
                 impl->setSignal(signal);
@@ -168,7 +186,9 @@ namespace RTT
         Operation& calls(Function func, Object o, ExecutionThread et = ClientThread, ExecutionEngine* ownerEngine = NULL ) {
             // creates a Local OperationCaller or sets function
             ExecutionEngine* null_caller = 0;
+            bool u = impl && impl->isUrgent();
             impl = boost::make_shared<internal::LocalOperationCaller<Signature> >(func, o, ownerEngine ? ownerEngine : this->mowner, null_caller, et);
+            impl->setUrgent(u);
 #ifdef ORO_SIGNALLING_OPERATIONS
             if (signal)
                 impl->setSignal(signal);
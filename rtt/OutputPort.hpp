@@ -44,6 +44,7 @@
 #include "internal/DataObjectDataSource.hpp"
 #include "internal/Channels.hpp"
 #include "internal/ConnFactory.hpp"
+#include "os/CAS.hpp"
 #include "Service.hpp"
 #include "OperationCaller.hpp"
 
@@ -97,6 +98,11 @@ namespace RTT
             }
         }
 
+        bool do_remove(base::ChannelElementBase* channel, const internal::ConnectionManager::ChannelDescriptor& descriptor)
+        {
+            return descriptor.get<1>().get() == channel;
+        }
+
         virtual bool connectionAdded( base::ChannelElementBase::shared_ptr channel_input, ConnPolicy const& policy ) {
             // Initialize the new channel with last written data if requested
             // (and available)
@@ -135,6 +141,12 @@ namespace RTT
         // This is used to allow the use of the 'init' connection policy option
         bool keeps_last_written_value;
         typename base::DataObjectInterface<T>::shared_ptr sample;
+        /// The sample handed out by loan(), or null if none is loaned. Claimed with os::CAS.
+        T* volatile loaned_sample;
+        /// The channel which loaned \c loaned_sample, or null if it is \c loan_fallback.
+        typename base::ChannelElement<T>::shared_ptr loan_channel;
+        /// Loaned if no channel can loan a sample, and then written with write().
+        T loan_fallback;
 
         /**
          * You are not allowed to copy ports.
@@ -169,6 +181,7 @@ namespace RTT
             , keeps_next_written_value(false)
             , keeps_last_written_value(false)
             , sample( new base::DataObject<T>() )
+            , loaned_sample(0)
         {
             if (keep_last_written_value)
                 keepLastWrittenValue(true);
@@ -257,6 +270,79 @@ namespace RTT
                     );
         }
 
+        /**
+         * Returns a sample which can be filled in and then be sent out with
+         * commit(), without copying it. If this port has a single
+         * connection whose buffer supports it (for example a buffered
+         * connection with the LOCK_FREE policy), the sample is the
+         * connection's own storage and reaches the reader without any copy.
+         * Otherwise, the sample belongs to this port and commit() falls back
+         * to write().
+         *
+         * The returned sample holds arbitrary data from earlier writes. Each
+         * loan() must be followed by exactly one commit(), from the same thread.
+         * If this port keeps its last written value (see keepLastWrittenValue()),
+         * commit() still copies the sample once for that purpose.
+         *
+         * Unlike write(), loan() and commit() are meant for a single writer:
+         * a port has only one outstanding loan. A loan() while another one
+         * is not yet committed, from this or any other thread, is refused.
+         * @return A sample to be filled in, or null if a loan is outstanding.
+         */
+        T* loan()
+        {
+            if ( !os::CAS(&loaned_sample, (T*)0, &loan_fallback) ) {
+                assert( false && "OutputPort::loan() called twice without commit()." );
+                log(Error) << "OutputPort " << getName() << ": loan() called while a loan is outstanding." << endlog();
+                return 0;
+            }
+            loan_channel = boost::static_pointer_cast< base::ChannelElement<T> >( cmanager.getSingleChannel() );
+            if (loan_channel) {
+                T* loaned = loan_channel->loan();
+                if (loaned)
+                    loaned_sample = loaned;
+                else
+                    loan_channel = 0;
+            }
+            return loaned_sample;
+        }
+
+        /**
+         * Sends out the sample returned by loan() to all receivers (if any).
+         */
+        void commit()
+        {
+            T* committed = loaned_sample;
+            if (!committed) {
+                log(Error) << "OutputPort " << getName() << ": commit() called without loan()." << endlog();
+                return;
+            }
+            typename base::ChannelElement<T>::shared_ptr channel = loan_channel;
+            loan_channel = 0;
+            if (!channel) {
+                write(*committed);
+                loaned_sample = 0;
+                return;
+            }
+
+            if (keeps_last_written_value || keeps_next_written_value)
+            {
+                keeps_next_written_value = false;
+                has_initial_sample = true;
+                this->sample->Set(*committed);
+            }
+            has_last_written_value = keeps_last_written_value;
+
+            bool committed_ok = channel->commit(committed);
+            loaned_sample = 0;
+            if ( !committed_ok ) {
+                log(Error) << "A channel of port " << getName() << " has been invalidated during commit(), it will be removed" << endlog();
+                cmanager.delete_if( boost::bind(
+                            &OutputPort<T>::do_remove, this, channel.get(), _1 )
+                        );
+            }
+        }
+
         void write(base::DataSourceBase::shared_ptr source)
         {
             typename internal::AssignableDataSource<T>::shared_ptr ds =
@@ -50,6 +50,7 @@
 #include "internal/DataSource.hpp"
 #include "internal/mystd.hpp"
 #include "internal/MWSRQueue.hpp"
+#include "internal/ProfilerService.hpp"
 #include "OperationCaller.hpp"
 
 #include "rtt-config.h"
@@ -90,6 +91,8 @@ namespace RTT
            ,our_act( parent ? 0 : new Activity( this->engine(), name ) )
 #endif
     {
+        if (parent)
+            parent->getProfiler().addChild(this, name);
         this->setup();
     }
 
@@ -118,6 +121,7 @@ namespace RTT
 
         this->addOperation("trigger", &TaskContext::trigger, this, ClientThread).doc("Trigger the update method for execution in the thread of this task.\n Only succeeds if the task isRunning() and allowed by the Activity executing this task.");
         this->addOperation("loadService", &TaskContext::loadService, this, ClientThread).doc("Loads a service known to RTT into this component.").arg("service_name","The name with which the service is registered by in the PluginLoader.");
+        internal::ProfilerService::Create(this);
         // activity runs from the start.
         if (our_act)
             our_act->start();
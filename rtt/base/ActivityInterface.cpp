@@ -67,6 +67,16 @@ bool ActivityInterface::run(RunnableInterface* _r)
     return true;
 }
 
+os::CpuSet ActivityInterface::getCpuSet() const
+{
+    return os::CpuSet( getCpuAffinity() );
+}
+
+bool ActivityInterface::setCpuSet(const os::CpuSet& cpus)
+{
+    return cpus.fitsMask() && setCpuAffinity( cpus.toMask() );
+}
+
 RunnableInterface* ActivityInterface::getRunner() const
 {
     return runner;
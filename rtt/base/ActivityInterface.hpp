@@ -175,6 +175,20 @@ namespace RTT
          */
         virtual bool setCpuAffinity(unsigned cpu)  = 0;
 
+        /**
+         * Get the CPUs this activity may run on. By default,
+         * this is the set of getCpuAffinity().
+         */
+        virtual os::CpuSet getCpuSet() const;
+
+        /**
+         * Set the CPUs this activity may run on, which may include CPUs
+         * above 31. By default, this is forwarded to setCpuAffinity() if
+         * the set fits in its mask.
+         * @return true if it could be updated, false otherwise.
+         */
+        virtual bool setCpuSet(const os::CpuSet& cpus);
+
         /**
          * Execute this activity such that it \a executes a step or loop of the RunnableInterface.
          * When you invoke execute() you intend to call the step() or loop() methods.
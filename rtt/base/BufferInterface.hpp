@@ -85,6 +85,25 @@ namespace RTT
          */
         virtual size_type Pop( std::vector<value_t>& items ) = 0;
 
+        /**
+         * Read at most \a max values from the buffer.
+         * @param items is to be filled with the values read,
+         * with \a items.begin() the oldest value. Reserve \a max
+         * elements in \a items beforehand to keep this real-time.
+         * @param max the maximum number of values to read.
+         * @return the number of items read.
+         * @cts
+         * @rt
+         */
+        virtual size_type Pop( std::vector<value_t>& items, size_type max )
+        {
+            items.clear();
+            value_t item;
+            while ( (size_type)items.size() != max && Pop( item ) )
+                items.push_back( item );
+            return items.size();
+        }
+
 	/**
 	 * Returns a pointer to the first element in the buffer.
 	 * The pointer is only garanteed to stay valid until 
@@ -102,7 +121,33 @@ namespace RTT
 	 * @param item pointer aquired using PopWithoutRelease()
 	 **/
 	virtual void Release(value_t *item) = 0;
-	
+
+        /**
+         * Returns true if the samples returned by PopWithoutRelease() remain
+         * valid until they are released, even when more samples are popped
+         * in the meantime, and if Release() may be called from any thread and
+         * in any order. Only then can read samples be shared without copying them.
+         */
+        virtual bool supportsZeroCopy() const { return false; }
+
+        /**
+         * Returns a pointer to a free element of this buffer, which can be
+         * filled in and then added to the buffer with Commit(), without
+         * copying the sample. At most one element may be loaned at a time.
+         *
+         * @return zero if the buffer is full or if it does not support loaning elements.
+         * @rt
+         */
+        virtual value_t* Loan() { return 0; }
+
+        /**
+         * Adds an element acquired with Loan() to the end of the buffer.
+         * @param item the pointer returned by Loan().
+         * @return false if the element could not be added, the sample is dropped in that case.
+         * @rt
+         */
+        virtual bool Commit(value_t* item) { return false; }
+
         /**
          * Write a single value to the buffer.
          * @param item the value to write
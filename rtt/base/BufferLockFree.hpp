@@ -45,6 +45,7 @@
 #include "../internal/AtomicMWSRQueue.hpp"
 #include "../internal/TsPool.hpp"
 #include <vector>
+#include <limits>
 
 #ifdef ORO_PRAGMA_INTERFACE
 #pragma interface
@@ -61,6 +62,8 @@ namespace RTT
      * data of type \a T in a FIFO way.
      * No memory allocation is done during read or write.
      * One thread may read and any number of threads may write this buffer.
+     * Samples can be written in place with Loan() and Commit(), and samples
+     * obtained with PopWithoutRelease() may be released from any thread.
      * @param T The value type to be stored in the Buffer.
      * Example : BufferLockFree<A> is a buffer which holds values of type A.
      * @ingroup PortBuffers
@@ -76,6 +79,8 @@ namespace RTT
         typedef T value_t;
     private:
         typedef T Item;
+        /// The number of samples that Push() and Pop() of a sequence move per CAS.
+        enum { BATCH_SIZE = 32 };
         internal::AtomicMWSRQueue<Item*> bufs;
         // is mutable because of reference counting.
         mutable internal::TsPool<Item> mpool;
@@ -148,31 +153,42 @@ namespace RTT
         }
         
         bool Push( param_t item)
+        {
+            Item* mitem = this->Loan();
+            if ( mitem == 0 ) {
+                droppedSamples.inc();
+                return false;
+            }
+            // copy over.
+            *mitem = item;
+            return this->Commit( mitem );
+        }
+
+        virtual bool supportsZeroCopy() const
+        {
+            return true;
+        }
+
+        value_t* Loan()
         {
             if ( capacity() == (size_type)bufs.size() ) {
-                if (!mcircular) {
-                    droppedSamples.inc();
-                    return false;
-                }
+                if (!mcircular)
+                    return 0;
                 // we will recover below in case of circular
             }
             Item* mitem = mpool.allocate();
             if ( mitem == 0 ) { // queue full ( rare but possible in race with PopWithoutRelease )
-                if (!mcircular) {
-                    droppedSamples.inc();
-                    return false;
-                }
-                else {
-                    if (bufs.dequeue( mitem ) == false ) {
-                        droppedSamples.inc();
-                        return false; // assert(false) ???
-                    }
-                    // we keep mitem to write item to next
-                }
+                if (!mcircular)
+                    return 0;
+                if (bufs.dequeue( mitem ) == false )
+                    return 0; // assert(false) ???
+                // we keep mitem to write item to next
             }
+            return mitem;
+        }
 
-            // copy over.
-            *mitem = item;
+        bool Commit( value_t* mitem )
+        {
             if (bufs.enqueue( mitem ) == false ) {
                 //got memory, but buffer is full
                 //this can happen, as the memory pool is
@@ -203,21 +219,48 @@ namespace RTT
 
         size_type Push(const std::vector<T>& items)
         {
-            // @todo Make this function more efficient as in BufferLocked.
-            int towrite  = items.size();
+            if (mcircular) {
+                // Dropping older samples is done one by one.
+                size_type written = 0;
+                typename std::vector<T>::const_iterator it;
+                for(  it = items.begin(); it != items.end(); ++it) {
+                    if ( this->Push( *it ) == false ) {
+                        // Push() counted this sample already.
+                        droppedSamples.add(items.end() - it - 1);
+                        break;
+                    }
+                    written++;
+                }
+                return written;
+            }
+            // Reserve the pool items and queue places per batch,
+            // instead of with two CAS loops per sample.
+            Item* batch[BATCH_SIZE];
             size_type written = 0;
-            typename std::vector<T>::const_iterator it;
-            for(  it = items.begin(); it != items.end(); ++it) {
-                if ( this->Push( *it ) == false ) {
-                    break; // will only happen in non-circular case !
+            while ( written != (size_type)items.size() ) {
+                size_type room = capacity() - (size_type)bufs.size();
+                size_type todo = (size_type)items.size() - written;
+                if (todo > room)
+                    todo = room;
+                if (todo > BATCH_SIZE)
+                    todo = BATCH_SIZE;
+                size_type n = todo ? mpool.allocate( batch, todo ) : 0;
+                if (n == 0)
+                    break;
+                for (size_type i = 0; i != n; ++i)
+                    *batch[i] = items[written + i];
+                size_type queued = bufs.enqueue( batch, n );
+                written += queued;
+                if (queued != n) {
+                    // other writers filled the queue in the meantime.
+                    mpool.deallocate( batch + queued, n - queued );
+                    break;
                 }
-                written++;
             }
-            droppedSamples.add(towrite - written);
+            droppedSamples.add(items.size() - written);
             return written;
         }
 
-
         bool Pop( reference_t item )
         {
             Item* ipop;
@@ -231,16 +274,25 @@ namespace RTT
 
         size_type Pop(std::vector<T>& items )
         {
-            Item* ipop;
+            return Pop( items, std::numeric_limits<size_type>::max() );
+        }
+
+        size_type Pop(std::vector<T>& items, size_type max )
+        {
+            Item* batch[BATCH_SIZE];
             items.clear();
-            while( bufs.dequeue(ipop) ) {
-                items.push_back( *ipop );
-                if (mpool.deallocate(ipop) == false)
-                    assert(false);
+            while ( (size_type)items.size() != max ) {
+                size_type todo = max - (size_type)items.size();
+                size_type n = bufs.dequeue( batch, todo > BATCH_SIZE ? (size_type)BATCH_SIZE : todo );
+                if (n == 0)
+                    break;
+                for (size_type i = 0; i != n; ++i)
+                    items.push_back( *batch[i] );
+                mpool.deallocate( batch, n );
             }
             return items.size();
         }
-        
+
         value_t* PopWithoutRelease()
 	{
             Item* ipop;
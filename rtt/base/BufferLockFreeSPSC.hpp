@@ -0,0 +1,316 @@
+/***************************************************************************
+  tag: agent  Sat Oct 17 23:46:07 UTC 2026  BufferLockFreeSPSC.hpp
+
+                        BufferLockFreeSPSC.hpp -  description
+                           -------------------
+    begin                : Sat October 17 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef ORO_BUFFER_LOCK_FREE_SPSC_HPP
+#define ORO_BUFFER_LOCK_FREE_SPSC_HPP
+
+#include "../os/oro_arch.h"
+#include "../os/Atomic.hpp"
+#include "BufferInterface.hpp"
+#include <vector>
+#include <limits>
+#include <cassert>
+
+#ifdef ORO_PRAGMA_INTERFACE
+#pragma interface
+#endif
+
+namespace RTT
+{ namespace base {
+
+    namespace detail {
+        /** Load with acquire semantics: later reads can not move before it. */
+        inline int spsc_load(const volatile int* value) {
+#if defined(__ATOMIC_ACQUIRE)
+            return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#else
+            // A CAS that never changes the value acts as a full barrier.
+            return oro_cmpxchg(const_cast<volatile int*>(value), 0, 0);
+#endif
+        }
+
+        /** Store with release semantics: earlier writes can not move after it. */
+        inline void spsc_store(volatile int* value, int v) {
+#if defined(__ATOMIC_RELEASE)
+            __atomic_store_n(value, v, __ATOMIC_RELEASE);
+#else
+            int old = *value;
+            while ( oro_cmpxchg(value, old, v) != old )
+                old = *value;
+#endif
+        }
+
+        /**
+         * Index that is written by one thread and read by another.
+         * It is padded to a full cache line such that the producer
+         * and consumer indexes never share a cache line.
+         */
+        struct SPSCIndex
+        {
+            enum { CACHE_LINE_SIZE = 64 };
+            volatile int value;
+            char pad[CACHE_LINE_SIZE - sizeof(int)];
+
+            SPSCIndex() : value(0) {}
+
+            int load() const { return spsc_load(&value); }
+
+            void store(int v) { spsc_store(&value, v); }
+        };
+    }
+
+    /**
+     * A wait-free buffer implementation for exactly one writer and
+     * one reader thread, storing data of type \a T in a FIFO way.
+     * The samples are stored in a pre-allocated ring, so no memory
+     * allocation is done during read or write, and neither side does
+     * atomic read-modify-write operations: the producer and consumer
+     * only publish their ring index with a release store and read the
+     * other side's index with an acquire load.
+     *
+     * Samples can also be written in place with Loan() and Commit().
+     * Samples returned by PopWithoutRelease() remain valid until they
+     * are released with Release(), which may be done from any thread and
+     * in any order. The writer does not overwrite a slot that is still in
+     * use, so holding on to popped samples may cause writes to be dropped.
+     *
+     * This buffer does not support the circular mode. Use BufferLockFree
+     * if more than one thread may write or if older samples must be dropped.
+     * @param T The value type to be stored in the Buffer.
+     * @ingroup PortBuffers
+     */
+    template< class T>
+    class BufferLockFreeSPSC
+        : public BufferInterface<T>
+    {
+    public:
+        typedef typename BufferInterface<T>::reference_t reference_t;
+        typedef typename BufferInterface<T>::param_t param_t;
+        typedef typename BufferInterface<T>::size_type size_type;
+        typedef T value_t;
+    private:
+        const int cap;
+        // The ring has room for cap queued samples, one sample that is popped
+        // but not yet released, and one empty slot to tell full from empty.
+        const int ring_size;
+        // Not a std::vector, since we hand out pointers into the ring, also for bool.
+        T* ring;
+        /// Per slot, non-zero while the sample is popped but not yet released.
+        volatile int* in_use;
+        T initial;
+        /// Next slot to be written. Written by the producer only.
+        detail::SPSCIndex write_index;
+        /// Next slot to be popped. Written by the consumer only.
+        detail::SPSCIndex read_index;
+        RTT::os::AtomicInt droppedSamples;
+
+        int next(int i) const { return i + 1 == ring_size ? 0 : i + 1; }
+
+        int distance(int from, int to) const { return to >= from ? to - from : to + ring_size - from; }
+
+        BufferLockFreeSPSC(const BufferLockFreeSPSC&);
+        BufferLockFreeSPSC& operator=(const BufferLockFreeSPSC&);
+    public:
+        /**
+         * Create a lock-free buffer wich can store \a bufsize elements.
+         * @param bufsize the capacity of the buffer.
+         * @param circular Must be false, a circular SPSC buffer is not supported.
+         */
+        BufferLockFreeSPSC( unsigned int bufsize, const T& initial_value = T(), bool circular = false)
+            : cap(bufsize), ring_size(bufsize + 2), ring(new T[bufsize + 2]), in_use(new int[bufsize + 2]()),
+              initial(initial_value), droppedSamples(0)
+        {
+            assert( !circular && "BufferLockFreeSPSC does not support the circular mode." );
+            (void)circular;
+            data_sample( initial_value );
+        }
+
+        ~BufferLockFreeSPSC()
+        {
+            delete[] ring;
+            delete[] in_use;
+        }
+
+        /**
+         * Initializes all slots with \a sample, such that no memory allocation
+         * happens in later writes. Must not be called concurrently with Push() or Pop().
+         */
+        virtual void data_sample( const T& sample )
+        {
+            initial = sample;
+            for (int i = 0; i != ring_size; ++i)
+                ring[i] = sample;
+        }
+
+        virtual T data_sample() const
+        {
+            return initial;
+        }
+
+        size_type capacity() const
+        {
+            return cap;
+        }
+
+        size_type size() const
+        {
+            return distance( read_index.load(), write_index.load() );
+        }
+
+        bool empty() const
+        {
+            return read_index.load() == write_index.load();
+        }
+
+        bool full() const
+        {
+            return size() == (size_type)cap;
+        }
+
+        /**
+         * Drops all queued samples. May only be called by the consumer.
+         */
+        void clear()
+        {
+            read_index.store( write_index.load() );
+        }
+
+        virtual size_type dropped() const
+        {
+            return droppedSamples.read();
+        }
+
+        bool Push( param_t item )
+        {
+            value_t* slot = this->Loan();
+            if ( slot == 0 ) {
+                droppedSamples.inc();
+                return false;
+            }
+            *slot = item;
+            return this->Commit( slot );
+        }
+
+        virtual bool supportsZeroCopy() const
+        {
+            return true;
+        }
+
+        value_t* Loan()
+        {
+            int w = write_index.value;
+            if ( distance( read_index.load(), w ) >= cap || detail::spsc_load( &in_use[w] ) )
+                return 0;
+            return &ring[w];
+        }
+
+        bool Commit( value_t* item )
+        {
+            int w = write_index.value;
+            assert( item == &ring[w] && "BufferLockFreeSPSC: Commit() without Loan()." );
+            (void)item;
+            write_index.store( next(w) );
+            return true;
+        }
+
+        size_type Push( const std::vector<T>& items )
+        {
+            size_type written = 0;
+            typename std::vector<T>::const_iterator it;
+            for( it = items.begin(); it != items.end(); ++it) {
+                if ( this->Push( *it ) == false )
+                    break;
+                ++written;
+            }
+            // Push() already counted the first dropped sample.
+            if ( written != (size_type)items.size() )
+                droppedSamples.add( items.size() - written - 1 );
+            return written;
+        }
+
+        bool Pop( reference_t item )
+        {
+            int r = read_index.value;
+            if ( r == write_index.load() )
+                return false;
+            item = ring[r];
+            read_index.store( next(r) );
+            return true;
+        }
+
+        size_type Pop( std::vector<T>& items )
+        {
+            return Pop( items, std::numeric_limits<size_type>::max() );
+        }
+
+        size_type Pop( std::vector<T>& items, size_type max )
+        {
+            items.clear();
+            // Copy out everything that is available, then free it at once.
+            int r = read_index.value;
+            int w = write_index.load();
+            while ( r != w && (size_type)items.size() != max ) {
+                items.push_back( ring[r] );
+                r = next(r);
+            }
+            read_index.store( r );
+            return items.size();
+        }
+
+        value_t* PopWithoutRelease()
+        {
+            int r = read_index.value;
+            if ( r == write_index.load() )
+                return 0;
+            // Published to the producer by the release store of read_index.
+            in_use[r] = 1;
+            read_index.store( next(r) );
+            return &ring[r];
+        }
+
+        void Release( value_t* item )
+        {
+            int i = item - ring;
+            assert( i >= 0 && i < ring_size );
+            assert( in_use[i] && "BufferLockFreeSPSC: released a sample that was not popped." );
+            detail::spsc_store( &in_use[i], 0 );
+        }
+    };
+}}
+
+#endif
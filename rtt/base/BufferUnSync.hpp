@@ -160,6 +160,18 @@ namespace RTT
             return quant;
         }
 
+        size_type Pop(std::vector<T>& items, size_type max )
+        {
+            int quant = 0;
+            items.clear();
+            while ( !buf.empty() && quant != max ) {
+                items.push_back( buf.front() );
+                buf.pop_front();
+                ++quant;
+            }
+            return quant;
+        }
+
 	value_t* PopWithoutRelease()
 	{
 	    if(buf.empty())
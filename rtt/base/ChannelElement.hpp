@@ -41,8 +41,12 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/call_traits.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <vector>
 #include "ChannelElementBase.hpp"
 #include "../FlowStatus.hpp"
+#include "../os/oro_allocator.hpp"
 
 namespace RTT { namespace base {
 
@@ -121,6 +125,62 @@ namespace RTT { namespace base {
             else
                 return NoData;
         }
+
+        /** Reads at most \a max new samples from the connection, the oldest
+         * first. Old data is never returned. This default implementation
+         * calls read() for each sample.
+         *
+         * @returns the number of samples stored in \a samples.
+         */
+        virtual size_t readMany(std::vector<value_t>& samples, size_t max)
+        {
+            value_t sample = value_t();
+            samples.clear();
+            while ( samples.size() != max && this->read( sample, false ) == NewData )
+                samples.push_back( sample );
+            return samples.size();
+        }
+
+        /** Returns a pointer to a free sample in the data storage of this
+         * connection, which can be filled in and then be published with
+         * commit(), such that the sample is not copied.
+         *
+         * @returns zero if the connection does not support this or has no room
+         * for a new sample. Use write() in that case.
+         */
+        virtual value_t* loan()
+        {
+            typename ChannelElement<T>::shared_ptr output = this->getOutput();
+            if (output)
+                return output->loan();
+            return 0;
+        }
+
+        /** Publishes a sample obtained with loan() on this connection.
+         *
+         * @returns false if an error occured that requires the channel to be invalidated.
+         */
+        virtual bool commit(value_t* sample)
+        {
+            typename ChannelElement<T>::shared_ptr output = this->getOutput();
+            if (output)
+                return output->commit(sample);
+            return false;
+        }
+
+        /** Reads a sample from the connection, without copying it if the
+         * data storage of the connection allows it. \a sample will point to
+         * a read-only sample that remains valid as long as it is referenced.
+         * This default implementation reads a copy of the sample with read().
+         */
+        virtual FlowStatus readShared(boost::shared_ptr<const T>& sample, bool copy_old_data)
+        {
+            boost::shared_ptr<T> copy = boost::allocate_shared<T>( os::rt_allocator<T>() );
+            FlowStatus result = this->read(*copy, copy_old_data);
+            if ( result == NewData || (result == OldData && copy_old_data) )
+                sample = copy;
+            return result;
+        }
     };
 }}
 
@@ -72,6 +72,12 @@ namespace RTT
              * Just free this object without executing it.
              */
             virtual void dispose() = 0;
+
+            /**
+             * Returns true if an ExecutionEngine must process this
+             * object before the other objects it has queued.
+             */
+            virtual bool isUrgent() const { return false; }
         };
     }
 }
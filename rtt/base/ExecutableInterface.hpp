@@ -41,6 +41,7 @@
 
 #include "../rtt-fwd.hpp"
 #include "../rtt-config.h"
+#include <string>
 
 namespace RTT
 {
@@ -109,6 +110,13 @@ namespace RTT
              */
             virtual bool execute() = 0;
 
+            /**
+             * Returns a name which identifies this object in the
+             * measurements of the engine, or an empty string if
+             * it has none.
+             */
+            virtual std::string getExecutableName() const { return std::string(); }
+
             /**
              * Informs this object that it got unloaded
              * from an ExecutionEngine.
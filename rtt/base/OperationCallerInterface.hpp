@@ -66,6 +66,16 @@ namespace RTT
 
             ExecutionThread getThread() const { return met; }
 
+            /**
+             * Sets the priority class of the messages sent by this object
+             * to the ExecutionEngine of the owner.
+             * @param u true if these messages are processed before
+             * all non-urgent messages.
+             */
+            void setUrgent(bool u) { murgent = u; }
+
+            virtual bool isUrgent() const { return murgent; }
+
             /**
              * Executed when the operation execution resulted in a
              * C++ exception. Must report the error to the ExecutionEngine
@@ -84,6 +94,7 @@ namespace RTT
             ExecutionEngine* myengine;
             ExecutionEngine* caller;
             ExecutionThread met;
+            bool murgent;
         };
     }
 }
@@ -289,6 +289,16 @@ namespace RTT {
         return this->engine()->getActivity() ? this->engine()->getActivity()->setCpuAffinity(cpu) : false;
     }
 
+    os::CpuSet TaskCore::getCpuSet() const
+    {
+        return this->engine()->getActivity() ? this->engine()->getActivity()->getCpuSet() : os::CpuSet(~0u);
+    }
+
+    bool TaskCore::setCpuSet(const os::CpuSet& cpus)
+    {
+        return this->engine()->getActivity() ? this->engine()->getActivity()->setCpuSet(cpus) : false;
+    }
+
     bool TaskCore::configureHook() {
         return true;
     }
@@ -43,6 +43,7 @@
 #include "../rtt-fwd.hpp"
 #include "../rtt-config.h"
 #include "../Time.hpp"
+#include "../os/CpuSet.hpp"
 
 namespace RTT
 { namespace base {
@@ -256,6 +257,19 @@ namespace RTT
          */
         virtual bool setCpuAffinity(unsigned cpu);
 
+        /**
+         * Get the CPUs this component may run on.
+         * @see ActivityInterface::getCpuSet()
+         */
+        virtual os::CpuSet getCpuSet() const;
+
+        /**
+         * Sets the CPUs this component may run on, which may include CPUs above 31.
+         * @return false if not allowed by the component's activity.
+         * @see ActivityInterface::setCpuSet()
+         */
+        virtual bool setCpuSet(const os::CpuSet& cpus);
+
         /**
          * Inspect if the component is in the FatalError state.
          * There is no possibility to recover from this state.
@@ -48,6 +48,8 @@
  */
 #include "SlaveActivity.hpp"
 #include "SequentialActivity.hpp"
+#include "ThreadPoolActivity.hpp"
+#include "ExecutionGraph.hpp"
 #include "PeriodicActivity.hpp"
 #include "../Activity.hpp"
 #include "../base/RunnableInterface.hpp"
@@ -0,0 +1,400 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:45:32 UTC 2026  ExecutionGraph.cpp
+
+                        ExecutionGraph.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "ExecutionGraph.hpp"
+#include "../TaskContext.hpp"
+#include "../base/OutputPortInterface.hpp"
+#include "../base/InputPortInterface.hpp"
+#include "../internal/ConnFactory.hpp"
+#include "../os/MutexLock.hpp"
+#include "../os/TimeService.hpp"
+#include "../Logger.hpp"
+#include <sstream>
+
+namespace RTT {
+    using namespace extras;
+    using namespace base;
+    using os::MutexLock;
+
+    /**
+     * A thread which helps the graph's thread during each period.
+     */
+    class ExecutionGraph::Worker
+        : public os::Thread
+    {
+        ExecutionGraph& graph;
+    public:
+        Worker(ExecutionGraph& g, int scheduler, int priority, const std::string& name)
+            : os::Thread(scheduler, priority, 0.0, 0, name), graph(g)
+        {}
+
+        ~Worker()
+        {
+            this->stop();
+        }
+
+        void loop()
+        {
+            while ( graph.work(this) )
+                ;
+        }
+
+        bool breakLoop()
+        {
+            MutexLock locker(graph.lock);
+            graph.do_exit = true;
+            graph.cond.broadcast();
+            return true;
+        }
+    };
+
+    /**
+     * The activity of a component in the graph. Like ThreadPoolActivity,
+     * it reports the thread which updates the component, and otherwise
+     * a thread of the graph which is not the caller.
+     */
+    class ExecutionGraph::Slave
+        : public SlaveActivity
+    {
+        ExecutionGraph& graph;
+    public:
+        /// The thread which updates the component, or null.
+        os::ThreadInterface* volatile mworker;
+
+        Slave(ExecutionGraph& g)
+            : SlaveActivity(&g), graph(g), mworker(0)
+        {}
+
+        os::ThreadInterface* thread()
+        {
+            os::ThreadInterface* w = mworker;
+            if ( w )
+                return w;
+            // Without workers, all components are updated by the graph's thread.
+            if ( !graph.isSelf() || graph.workers.empty() )
+                return &graph;
+            return graph.workers[0];
+        }
+    };
+
+    /**
+     * A component in the graph.
+     */
+    struct ExecutionGraph::Node
+    {
+        TaskContext* component;
+        Slave* slave;
+        /// The indexes of the nodes which must be updated first.
+        std::vector<int> preds;
+        /// The indexes of the nodes which wait for this one.
+        std::vector<int> succs;
+        /// The number of preds which were not updated yet in this period.
+        unsigned int pending;
+
+        // Only written by the thread which updated the node last.
+        unsigned long count;
+        nsecs last;
+        nsecs total;
+        nsecs max;
+
+        Node(TaskContext* c, Slave* s)
+            : component(c), slave(s), pending(0), count(0), last(0), total(0), max(0)
+        {}
+    };
+
+    ExecutionGraph::Statistics::Statistics()
+        : count(0), last(0), mean(0), max(0)
+    {
+    }
+
+    ExecutionGraph::ExecutionGraph(int scheduler, int priority, Seconds period,
+                                   unsigned int nworkers, const std::string& name)
+        : Activity(scheduler, priority, period, 0, name),
+          remaining(0), do_exit(false)
+    {
+        for (unsigned int i = 0; i != nworkers; ++i) {
+            std::stringstream wname;
+            wname << name << ".worker" << i;
+            workers.push_back( new Worker(*this, scheduler, priority, wname.str()) );
+        }
+    }
+
+    ExecutionGraph::~ExecutionGraph()
+    {
+        stop();
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            delete workers[i];
+        for (unsigned int i = 0; i != nodes.size(); ++i)
+            delete nodes[i];
+    }
+
+    int ExecutionGraph::find(TaskContext* component) const
+    {
+        for (unsigned int i = 0; i != nodes.size(); ++i)
+            if ( nodes[i]->component == component )
+                return i;
+        return -1;
+    }
+
+    bool ExecutionGraph::addComponent(TaskContext* component)
+    {
+        if ( isActive() || !component || find(component) != -1 )
+            return false;
+        Slave* slave = new Slave(*this);
+        if ( !component->setActivity(slave) ) {
+            delete slave;
+            return false;
+        }
+        nodes.push_back( new Node(component, slave) );
+        return true;
+    }
+
+    bool ExecutionGraph::reaches(int from, int to) const
+    {
+        if ( from == to )
+            return true;
+        const std::vector<int>& succs = nodes[from]->succs;
+        for (unsigned int i = 0; i != succs.size(); ++i)
+            if ( reaches(succs[i], to) )
+                return true;
+        return false;
+    }
+
+    bool ExecutionGraph::link(int before, int after)
+    {
+        if ( reaches(after, before) )
+            return false;
+        std::vector<int>& succs = nodes[before]->succs;
+        for (unsigned int i = 0; i != succs.size(); ++i)
+            if ( succs[i] == after )
+                return true;
+        succs.push_back(after);
+        nodes[after]->preds.push_back(before);
+        return true;
+    }
+
+    bool ExecutionGraph::addDependency(TaskContext* before, TaskContext* after)
+    {
+        int b = find(before), a = find(after);
+        if ( isActive() || b == -1 || a == -1 )
+            return false;
+        if ( !link(b, a) ) {
+            log(Error) << "ExecutionGraph: " << before->getName() << " can not run before "
+                       << after->getName() << ": the graph would have a cycle." << endlog();
+            return false;
+        }
+        return true;
+    }
+
+    bool ExecutionGraph::deriveDependencies()
+    {
+        if ( isActive() )
+            return false;
+        bool result = true;
+        for (unsigned int b = 0; b != nodes.size(); ++b) {
+            DataFlowInterface::Ports ports = nodes[b]->component->ports()->getPorts();
+            for (unsigned int p = 0; p != ports.size(); ++p) {
+                OutputPortInterface* out = dynamic_cast<OutputPortInterface*>(ports[p]);
+                if ( !out )
+                    continue;
+                std::list<internal::ConnectionManager::ChannelDescriptor> channels = out->getManager()->getChannels();
+                for (std::list<internal::ConnectionManager::ChannelDescriptor>::iterator it = channels.begin(); it != channels.end(); ++it) {
+                    // local connections are identified by the input port.
+                    internal::LocalConnID* id = dynamic_cast<internal::LocalConnID*>( it->get<0>().get() );
+                    DataFlowInterface* iface = id && id->ptr ? id->ptr->getInterface() : 0;
+                    int a = iface ? find( iface->getOwner() ) : -1;
+                    if ( a == -1 || a == int(b) )
+                        continue;
+                    if ( !link(b, a) ) {
+                        log(Warning) << "ExecutionGraph: ignoring the connection from " << nodes[b]->component->getName()
+                                     << "." << out->getName() << " to " << nodes[a]->component->getName()
+                                     << ": the graph would have a cycle." << endlog();
+                        result = false;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    unsigned int ExecutionGraph::size() const
+    {
+        return nodes.size();
+    }
+
+    unsigned int ExecutionGraph::getWorkerCount() const
+    {
+        return workers.size();
+    }
+
+    std::vector<TaskContext*> ExecutionGraph::getSchedule() const
+    {
+        std::vector<unsigned int> pending(nodes.size());
+        std::deque<int> order;
+        for (unsigned int i = 0; i != nodes.size(); ++i) {
+            pending[i] = nodes[i]->preds.size();
+            if ( pending[i] == 0 )
+                order.push_back(i);
+        }
+        std::vector<TaskContext*> result;
+        while ( !order.empty() ) {
+            Node& node = *nodes[ order.front() ];
+            order.pop_front();
+            result.push_back(node.component);
+            for (unsigned int s = 0; s != node.succs.size(); ++s)
+                if ( --pending[ node.succs[s] ] == 0 )
+                    order.push_back( node.succs[s] );
+        }
+        return result;
+    }
+
+    ExecutionGraph::Statistics ExecutionGraph::getStatistics(TaskContext* component) const
+    {
+        Statistics stats;
+        int i = find(component);
+        if ( i == -1 )
+            return stats;
+        const Node& node = *nodes[i];
+        stats.count = node.count;
+        stats.last = node.last;
+        stats.max = node.max;
+        stats.mean = stats.count ? node.total / nsecs(stats.count) : 0;
+        return stats;
+    }
+
+    void ExecutionGraph::resetStatistics()
+    {
+        MutexLock locker(lock);
+        for (unsigned int i = 0; i != nodes.size(); ++i) {
+            nodes[i]->count = 0;
+            nodes[i]->last = 0;
+            nodes[i]->total = 0;
+            nodes[i]->max = 0;
+        }
+    }
+
+    void ExecutionGraph::schedule()
+    {
+        MutexLock locker(lock);
+        remaining = nodes.size();
+        for (unsigned int i = 0; i != nodes.size(); ++i) {
+            nodes[i]->pending = nodes[i]->preds.size();
+            if ( nodes[i]->pending == 0 )
+                ready.push_back(i);
+        }
+        cond.broadcast();
+    }
+
+    void ExecutionGraph::step()
+    {
+        if ( nodes.empty() )
+            return;
+        schedule();
+        while ( work(this) )
+            ;
+    }
+
+    bool ExecutionGraph::work(os::ThreadInterface* self)
+    {
+        bool master = self == this;
+        int next;
+        {
+            MutexLock locker(lock);
+            while ( ready.empty() && !(master ? remaining == 0 : do_exit) )
+                cond.wait(lock);
+            if ( ready.empty() )
+                return false;
+            next = ready.front();
+            ready.pop_front();
+        }
+
+        Node& node = *nodes[next];
+        execute(node, self);
+
+        MutexLock locker(lock);
+        for (unsigned int s = 0; s != node.succs.size(); ++s)
+            if ( --nodes[ node.succs[s] ]->pending == 0 )
+                ready.push_back( node.succs[s] );
+        if ( --remaining == 0 || !ready.empty() )
+            cond.broadcast();
+        return true;
+    }
+
+    void ExecutionGraph::execute(Node& node, os::ThreadInterface* self)
+    {
+        os::TimeService::ticks start = os::TimeService::Instance()->getTicks();
+        node.slave->mworker = self;
+        bool executed = node.slave->execute();
+        node.slave->mworker = 0;
+        // stopped components are skipped, but still release their successors.
+        if ( !executed )
+            return;
+        nsecs elapsed = os::TimeService::ticks2nsecs( os::TimeService::Instance()->getTicks(start) );
+        node.last = elapsed;
+        node.total += elapsed;
+        if ( elapsed > node.max )
+            node.max = elapsed;
+        ++node.count;
+    }
+
+    bool ExecutionGraph::initialize()
+    {
+        if ( !Activity::initialize() )
+            return false;
+        {
+            MutexLock locker(lock);
+            do_exit = false;
+        }
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            workers[i]->start();
+        // a slave can not be started before its master is.
+        for (unsigned int i = 0; i != nodes.size(); ++i)
+            if ( !nodes[i]->slave->isActive() )
+                nodes[i]->slave->start();
+        return true;
+    }
+
+    void ExecutionGraph::finalize()
+    {
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            workers[i]->stop();
+        Activity::finalize();
+    }
+}
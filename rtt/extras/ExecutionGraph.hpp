@@ -0,0 +1,206 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:45:32 UTC 2026  ExecutionGraph.hpp
+
+                        ExecutionGraph.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_EXECUTION_GRAPH_HPP
+#define ORO_EXECUTION_GRAPH_HPP
+
+#include "../Activity.hpp"
+#include "../os/Mutex.hpp"
+#include "../os/Condition.hpp"
+#include "SlaveActivity.hpp"
+#include "../rtt-fwd.hpp"
+#include "rtt-extras-fwd.hpp"
+#include <deque>
+#include <vector>
+
+namespace RTT
+{ namespace extras {
+
+    /**
+     * @brief An activity which executes a graph of components in
+     * the order of their data flow.
+     *
+     * Each component added to the graph gets a SlaveActivity of which
+     * this activity is the master. While a component is updated, its
+     * activity's thread() is the thread which updates it, such that the
+     * component can call its own operations from updateHook(). Each period (or trigger, if the
+     * graph is not periodic), every running component is updated once,
+     * after all components it depends on. Components which do not depend
+     * on each other are updated in parallel by the graph's thread and a
+     * fixed set of worker threads. Without workers, the components are
+     * updated in the same order every period.
+     *
+     * Dependencies are declared with addDependency() or derived from the
+     * connections between the ports of the components with
+     * deriveDependencies(). Dependencies which would create a cycle are
+     * refused.
+     *
+     * The graph must be stopped to change it and must outlive the
+     * components it executes, like any master of a SlaveActivity.
+     *
+     * @ingroup CoreLibActivities
+     */
+    class RTT_API ExecutionGraph
+        : public Activity
+    {
+    public:
+        /**
+         * The execution time of a component in the graph.
+         * All times are in nanoseconds.
+         */
+        struct Statistics
+        {
+            Statistics();
+
+            /** The number of times the component was updated. */
+            unsigned long count;
+            nsecs last;
+            nsecs mean;
+            nsecs max;
+        };
+
+        /**
+         * Create a graph with its own thread.
+         * @param scheduler The scheduler of the graph's thread and its workers.
+         * @param priority The priority of the graph's thread and its workers.
+         * @param period The period of the graph, or zero if it is triggered.
+         * @param workers The number of threads which, in addition to the
+         * graph's thread, update independent components in parallel.
+         * @param name The name of the graph's thread.
+         */
+        ExecutionGraph(int scheduler, int priority, Seconds period,
+                       unsigned int workers = 0, const std::string& name = "ExecutionGraph");
+
+        /**
+         * Stops the graph and its workers. The slave activities of the
+         * components refer to this graph, so the components must be
+         * deleted before it, or get another activity.
+         */
+        ~ExecutionGraph();
+
+        /**
+         * Adds \a component to the graph, which gives it a SlaveActivity.
+         * The component can be started once the graph is started.
+         * @return false if the graph or the component is running,
+         * or if the component is already in the graph.
+         */
+        bool addComponent(TaskContext* component);
+
+        /**
+         * Declares that \a after must be updated after \a before in
+         * each period. Both must be in the graph.
+         * @return false if the graph is running, if one of the components
+         * is not in the graph or if the dependency creates a cycle.
+         */
+        bool addDependency(TaskContext* before, TaskContext* after);
+
+        /**
+         * Adds a dependency from each component in the graph to each other
+         * component in the graph of which an input port is connected to
+         * one of its output ports. Connections creating a cycle are skipped.
+         * @return false if the graph is running or a connection was skipped.
+         */
+        bool deriveDependencies();
+
+        /**
+         * Returns the number of components in the graph.
+         */
+        unsigned int size() const;
+
+        /**
+         * Returns the number of threads that help the graph's thread.
+         */
+        unsigned int getWorkerCount() const;
+
+        /**
+         * Returns the components in the order they would be updated
+         * without workers.
+         */
+        std::vector<TaskContext*> getSchedule() const;
+
+        /**
+         * Returns the execution time of \a component.
+         */
+        Statistics getStatistics(TaskContext* component) const;
+
+        /**
+         * Restarts the measurement of getStatistics() of all components.
+         */
+        void resetStatistics();
+
+        /**
+         * Updates each component in the graph once, in dependency order.
+         */
+        void step();
+
+        bool initialize();
+
+        void finalize();
+
+    private:
+        class Worker;
+        class Slave;
+        struct Node;
+
+        int find(TaskContext* component) const;
+        bool reaches(int from, int to) const;
+        bool link(int before, int after);
+        void schedule();
+        /**
+         * Takes a ready node and updates it in thread \a self, which is
+         * the graph's thread or one of its workers, or waits for one.
+         * @return false if the period is over, or the worker must exit.
+         */
+        bool work(os::ThreadInterface* self);
+        void execute(Node& node, os::ThreadInterface* self);
+
+        std::vector<Node*> nodes;
+        std::vector<Worker*> workers;
+
+        /// Guards ready, remaining and the pending counters of the nodes.
+        mutable os::Mutex lock;
+        os::Condition cond;
+        std::deque<int> ready;
+        unsigned int remaining;
+        bool do_exit;
+    };
+}}
+
+#endif
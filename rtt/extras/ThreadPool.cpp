@@ -0,0 +1,259 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:07:58 UTC 2026  ThreadPool.cpp
+
+                        ThreadPool.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "ThreadPool.hpp"
+#include "ThreadPoolActivity.hpp"
+#include "../os/MutexLock.hpp"
+#include "../Logger.hpp"
+
+#include <sstream>
+#include <unistd.h>
+
+/**
+ * The number of activities each worker queue holds without
+ * taking the overflow lock.
+ */
+#ifndef ORONUM_THREADPOOL_QUEUE_SIZE
+#define ORONUM_THREADPOOL_QUEUE_SIZE 64
+#endif
+
+namespace RTT {
+    using namespace extras;
+    using os::MutexLock;
+
+    /**
+     * A worker thread of a ThreadPool. It executes the activities of its
+     * own queue, takes those of the others when that is empty and
+     * sleeps when there is no work left at all.
+     */
+    class ThreadPool::Worker
+        : public os::Thread
+    {
+        ThreadPool& pool;
+        unsigned int index;
+        bool do_exit;
+    public:
+        Worker(ThreadPool& p, unsigned int i, int scheduler, int priority, const std::string& name)
+            : os::Thread(scheduler, priority, 0.0, 0, name), pool(p), index(i), do_exit(false)
+        {}
+
+        ~Worker()
+        {
+            this->stop();
+        }
+
+        bool initialize()
+        {
+            do_exit = false;
+            return true;
+        }
+
+        void loop()
+        {
+            while (true) {
+                ThreadPoolActivity* act = pool.pop(index);
+                if (act) {
+                    act->work(this);
+                    continue;
+                }
+                MutexLock locker(pool.lock);
+                if (do_exit)
+                    return;
+                // push() increases queued before it reads sleeping,
+                // so either it wakes us up or we see its activity.
+                pool.sleeping.inc();
+                if ( pool.queued.read() == 0 )
+                    pool.work_cond.wait(pool.lock);
+                pool.sleeping.dec();
+            }
+        }
+
+        bool breakLoop()
+        {
+            MutexLock locker(pool.lock);
+            do_exit = true;
+            pool.work_cond.broadcast();
+            return true;
+        }
+    };
+
+    ThreadPool::ThreadPoolList ThreadPool::ThreadPools;
+
+    ThreadPoolPtr ThreadPool::Instance(int scheduler, int priority)
+    {
+        return Instance(scheduler, priority, 0);
+    }
+
+    ThreadPoolPtr ThreadPool::Instance(int scheduler, int priority, unsigned int workers)
+    {
+        os::CheckPriority(scheduler, priority);
+        ThreadPoolList::iterator it = ThreadPools.begin();
+        while ( it != ThreadPools.end() ) {
+            ThreadPoolPtr tptr = it->lock();
+            // detect old pointer.
+            if ( !tptr ) {
+                ThreadPools.erase(it);
+                it = ThreadPools.begin();
+                continue;
+            }
+            if ( tptr->getScheduler() == scheduler &&
+                 tptr->getPriority() == priority &&
+                 (workers == 0 || tptr->size() == workers) ) {
+                return tptr;
+            }
+            ++it;
+        }
+        ThreadPoolPtr ret( new ThreadPool(scheduler, priority, workers, "ThreadPool") );
+        ThreadPools.push_back( ret );
+        return ret;
+    }
+
+    ThreadPool::ThreadPool(int scheduler, int priority, unsigned int nworkers, const std::string& name)
+        : msched(scheduler), mprio(priority)
+    {
+        os::CheckPriority(msched, mprio);
+        if (nworkers == 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            nworkers = cpus > 0 ? cpus : 1;
+#else
+            nworkers = 1;
+#endif
+        }
+        for (unsigned int i = 0; i != nworkers; ++i)
+            queues.push_back( new Queue(ORONUM_THREADPOOL_QUEUE_SIZE) );
+        // all queues exist before the first worker runs.
+        for (unsigned int i = 0; i != nworkers; ++i) {
+            std::stringstream wname;
+            wname << name << i;
+            workers.push_back( new Worker(*this, i, msched, mprio, wname.str()) );
+        }
+        for (unsigned int i = 0; i != nworkers; ++i)
+            workers[i]->start();
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            delete workers[i];
+        for (unsigned int i = 0; i != queues.size(); ++i)
+            delete queues[i];
+    }
+
+    void ThreadPool::push(ThreadPoolActivity* act)
+    {
+        int i = self();
+        if (i < 0) {
+            next.inc();
+            i = (unsigned int)next.read() % workers.size();
+        }
+        // a full queue only costs the next one a try.
+        bool done = false;
+        for (unsigned int n = 0; !done && n != queues.size(); ++n)
+            done = queues[ (i + n) % queues.size() ]->enqueue(act);
+        if ( !done ) {
+            MutexLock locker(overflow_lock);
+            overflow.push_back(act);
+            overflowed.inc();
+        }
+        queued.inc();
+        if ( sleeping.read() != 0 ) {
+            MutexLock locker(lock);
+            work_cond.broadcast();
+        }
+    }
+
+    ThreadPoolActivity* ThreadPool::pop(unsigned int me)
+    {
+        ThreadPoolActivity* act = 0;
+        if ( !queues[me]->dequeue(act) ) {
+            act = 0;
+            // take the oldest activity of another worker.
+            for (unsigned int n = 1; act == 0 && n != queues.size(); ++n) {
+                if ( queues[ (me + n) % queues.size() ]->dequeue(act) )
+                    migrated.inc();
+                else
+                    act = 0;
+            }
+        }
+        if ( act == 0 && overflowed.read() != 0 ) {
+            MutexLock locker(overflow_lock);
+            if ( !overflow.empty() ) {
+                act = overflow.front();
+                overflow.pop_front();
+                overflowed.dec();
+            }
+        }
+        if (act)
+            queued.dec();
+        return act;
+    }
+
+    int ThreadPool::self() const
+    {
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            if ( workers[i]->isSelf() )
+                return i;
+        return -1;
+    }
+
+    unsigned int ThreadPool::size() const
+    {
+        return workers.size();
+    }
+
+    os::ThreadInterface* ThreadPool::worker(unsigned int i) const
+    {
+        return i < workers.size() ? workers[i] : 0;
+    }
+
+    int ThreadPool::getMigratedCount() const
+    {
+        return migrated.read();
+    }
+
+    int ThreadPool::getScheduler() const
+    {
+        return msched;
+    }
+
+    int ThreadPool::getPriority() const
+    {
+        return mprio;
+    }
+}
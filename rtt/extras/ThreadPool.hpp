@@ -0,0 +1,172 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:07:58 UTC 2026  ThreadPool.hpp
+
+                        ThreadPool.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef ORO_EXTRAS_THREADPOOL_HPP
+#define ORO_EXTRAS_THREADPOOL_HPP
+
+#include <deque>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "../os/Thread.hpp"
+#include "../os/Mutex.hpp"
+#include "../os/Condition.hpp"
+#include "../os/Atomic.hpp"
+#include "../internal/AtomicQueue.hpp"
+#include "rtt-extras-fwd.hpp"
+
+namespace RTT
+{ namespace extras {
+
+    /**
+     * ThreadPool objects are reference counted such that
+     * when the last ThreadPoolActivity which uses it is deleted,
+     * the worker threads are deleted as well.
+     */
+    typedef boost::shared_ptr<ThreadPool> ThreadPoolPtr;
+
+    /**
+     * A fixed set of worker threads which execute triggered
+     * ThreadPoolActivity objects.
+     *
+     * Each worker has its own lock-free FIFO queue of activities. An activity
+     * triggered from a worker is queued with that worker, other
+     * triggers are spread over the workers. A worker that has
+     * nothing to do takes the oldest activity of another worker's queue
+     * before it goes to sleep. The queues stay FIFO, such that an activity
+     * which keeps triggering itself can not starve the others of its worker.
+     * Queueing an activity only takes a lock to wake up a sleeping worker,
+     * or when all queues are full. A completed step takes no lock.
+     *
+     * @see ThreadPoolActivity
+     */
+    class RTT_API ThreadPool
+    {
+    public:
+        /**
+         * Create a pool of \a workers non periodic threads.
+         * @param workers The number of threads, or zero for one thread per processor.
+         */
+        ThreadPool(int scheduler, int priority, unsigned int workers, const std::string& name);
+
+        /**
+         * Stops and deletes all workers. No activity may be queued anymore.
+         */
+        ~ThreadPool();
+
+        /**
+         * Returns the pool for the given scheduler and priority,
+         * with one worker per processor.
+         */
+        static ThreadPoolPtr Instance(int scheduler, int priority);
+
+        /**
+         * Returns the pool for the given scheduler, priority and
+         * number of workers.
+         */
+        static ThreadPoolPtr Instance(int scheduler, int priority, unsigned int workers);
+
+        /**
+         * Queues \a act for execution by a worker.
+         */
+        void push(ThreadPoolActivity* act);
+
+        /**
+         * The number of worker threads.
+         */
+        unsigned int size() const;
+
+        /**
+         * Returns worker \a i.
+         */
+        os::ThreadInterface* worker(unsigned int i) const;
+
+        /**
+         * Returns the number of activities that were executed by
+         * another worker than the one they were queued with.
+         */
+        int getMigratedCount() const;
+
+        int getScheduler() const;
+
+        int getPriority() const;
+
+    private:
+        friend class ThreadPoolActivity;
+        class Worker;
+
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        /**
+         * Returns the next activity for worker \a self, from its
+         * own queue or else from another worker's queue, or zero.
+         */
+        ThreadPoolActivity* pop(unsigned int self);
+
+        /**
+         * Returns the index of the calling worker, or -1.
+         */
+        int self() const;
+
+        std::vector<Worker*> workers;
+        typedef internal::AtomicQueue<ThreadPoolActivity*> Queue;
+        /// One queue per worker.
+        std::vector<Queue*> queues;
+        /// Activities which did not fit in any queue.
+        std::deque<ThreadPoolActivity*> overflow;
+        os::Mutex overflow_lock;
+        os::AtomicInt overflowed;
+        os::AtomicInt queued;
+        os::AtomicInt next;
+        os::AtomicInt migrated;
+        /// The number of workers which are going to sleep or sleeping.
+        os::AtomicInt sleeping;
+        /// Guards sleeping and waking up of the workers.
+        os::Mutex lock;
+        os::Condition work_cond;
+        int msched;
+        int mprio;
+
+        typedef std::vector< boost::weak_ptr<ThreadPool> > ThreadPoolList;
+        static ThreadPoolList ThreadPools;
+    };
+}}
+
+#endif
@@ -0,0 +1,256 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:07:58 UTC 2026  ThreadPoolActivity.cpp
+
+                        ThreadPoolActivity.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "ThreadPoolActivity.hpp"
+#include "../os/MainThread.hpp"
+#include "../os/CAS.hpp"
+
+namespace RTT {
+    using namespace extras;
+    using namespace base;
+
+    ThreadPoolActivity::ThreadPoolActivity( RunnableInterface* run /*= 0*/ )
+        : ActivityInterface(run), mpool( ThreadPool::Instance(ORO_SCHED_OTHER, os::LowestPriority) ),
+          state(Idle), done(0), mworker(0), active(false), stopping(false)
+    {
+    }
+
+    ThreadPoolActivity::ThreadPoolActivity( int scheduler, int priority, RunnableInterface* run /*= 0*/ )
+        : ActivityInterface(run), mpool( ThreadPool::Instance(scheduler, priority) ),
+          state(Idle), done(0), mworker(0), active(false), stopping(false)
+    {
+    }
+
+    ThreadPoolActivity::ThreadPoolActivity( ThreadPoolPtr pool, RunnableInterface* run /*= 0*/ )
+        : ActivityInterface(run), mpool( pool ),
+          state(Idle), done(0), mworker(0), active(false), stopping(false)
+    {
+    }
+
+    ThreadPoolActivity::~ThreadPoolActivity()
+    {
+        stop();
+    }
+
+    ThreadPoolPtr ThreadPoolActivity::getThreadPool() const
+    {
+        return mpool;
+    }
+
+    Seconds ThreadPoolActivity::getPeriod() const
+    {
+        return 0.0;
+    }
+
+    bool ThreadPoolActivity::setPeriod(Seconds s) {
+        if ( s == 0.0)
+            return true;
+        return false;
+    }
+
+    unsigned ThreadPoolActivity::getCpuAffinity() const
+    {
+      return ~0;
+    }
+
+    bool ThreadPoolActivity::setCpuAffinity(unsigned cpu)
+    {
+      return false;
+    }
+
+    os::ThreadInterface* ThreadPoolActivity::thread()
+    {
+        os::ThreadInterface* w = mworker;
+        if ( w )
+            return w;
+        // Any thread but the caller, such that the caller does not
+        // mistake itself for the thread of this activity.
+        for (unsigned int i = 0; i != mpool->size(); ++i)
+            if ( !mpool->worker(i)->isSelf() )
+                return mpool->worker(i);
+        return os::MainThread::Instance();
+    }
+
+    bool ThreadPoolActivity::initialize()
+    {
+        return true;
+    }
+
+    void ThreadPoolActivity::step()
+    {
+    }
+
+    void ThreadPoolActivity::loop()
+    {
+        this->step();
+    }
+
+    bool ThreadPoolActivity::breakLoop()
+    {
+        return false;
+    }
+
+    void ThreadPoolActivity::finalize()
+    {
+    }
+
+    bool ThreadPoolActivity::start()
+    {
+        if ( active == true )
+            return false;
+
+        active = true;
+
+        if ( runner ? runner->initialize() : this->initialize() ) {
+        } else {
+            active = false;
+        }
+        return active;
+    }
+
+    bool ThreadPoolActivity::stop()
+    {
+        if ( !active )
+            return false;
+
+        stopping = true;
+        // A step() that stops its own activity can not wait for itself.
+        os::ThreadInterface* w = mworker;
+        if ( !w || !w->isSelf() )
+            waitIdle();
+
+        if (runner)
+            runner->finalize();
+        else
+            this->finalize();
+        active = false;
+        stopping = false;
+        return true;
+    }
+
+    bool ThreadPoolActivity::isRunning() const
+    {
+        return mworker != 0;
+    }
+
+    bool ThreadPoolActivity::isPeriodic() const
+    {
+        return false;
+    }
+
+    bool ThreadPoolActivity::isActive() const
+    {
+        return active;
+    }
+
+    bool ThreadPoolActivity::trigger()
+    {
+        if ( !active || stopping )
+            return false;
+        while (true) {
+            int s = state;
+            if ( s == Idle ) {
+                if ( os::CAS(&state, (int)Idle, (int)Queued) ) {
+                    mpool->push(this);
+                    return true;
+                }
+            } else if ( s == Running ) {
+                // the worker executes step() again when it returns.
+                if ( os::CAS(&state, (int)Running, (int)Retriggered) )
+                    return true;
+            } else {
+                // Queued or Retriggered: step() will be executed.
+                return true;
+            }
+        }
+    }
+
+    void ThreadPoolActivity::work(os::ThreadInterface* w)
+    {
+        if ( active && !stopping ) {
+            // keeps Waiting, if stop() was called meanwhile.
+            int s = state;
+            while ( !os::CAS(&state, s, (s & Waiting) | Running) )
+                s = state;
+            mworker = w;
+            if (runner) runner->step(); else this->step();
+            mworker = 0;
+        }
+        // once idle() returns true, stop() may return and this object may be gone.
+        if ( !this->idle() )
+            mpool->push(this);
+    }
+
+    bool ThreadPoolActivity::idle()
+    {
+        while (true) {
+            int s = state;
+            if ( s == Retriggered && active && !stopping ) {
+                if ( os::CAS(&state, s, (int)Queued) )
+                    return false;
+                continue;
+            }
+            // Running, or Retriggered or Queued while being stopped.
+            if ( os::CAS(&state, s, (int)Idle) ) {
+                // stop() blocks in waitIdle() until this signal, so this object still exists.
+                if ( s & Waiting )
+                    done.signal();
+                return true;
+            }
+        }
+    }
+
+    void ThreadPoolActivity::waitIdle()
+    {
+        while (true) {
+            int s = state;
+            if ( s == Idle )
+                return;
+            if ( (s & Waiting) || os::CAS(&state, s, s | Waiting) ) {
+                done.wait();
+                return;
+            }
+        }
+    }
+
+    bool ThreadPoolActivity::execute()
+    {
+        return false;
+    }
+
+}
@@ -0,0 +1,185 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:07:58 UTC 2026  ThreadPoolActivity.hpp
+
+                        ThreadPoolActivity.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef ORO_THREADPOOL_ACTIVITY_HPP
+#define ORO_THREADPOOL_ACTIVITY_HPP
+
+#include "../base/ActivityInterface.hpp"
+#include "../base/RunnableInterface.hpp"
+#include "ThreadPool.hpp"
+#include "../os/Semaphore.hpp"
+
+namespace RTT
+{ namespace extras {
+
+    /**
+     * @brief A non periodic activity which is executed by a shared pool of threads.
+     *
+     * Instead of creating a thread for each component, as Activity does,
+     * all ThreadPoolActivity objects with the same scheduler and priority
+     * share one ThreadPool, which has by default one worker thread per
+     * processor. This is meant for the many event driven components which
+     * are idle most of the time.
+     *
+     * An activity is never executed by two workers at the same time: a
+     * trigger() during step() only causes step() to be executed once more
+     * afterwards, possibly by another worker.
+     *
+     * @warning A step() that blocks, for example on an operation of another
+     * component in the same pool, blocks its worker. If all workers block,
+     * the pool deadlocks, so use Activity for such components.
+     *
+     * \section ExecReact Reactions to execute():
+     * Always returns false.
+     *
+     * \section TrigReact Reactions to trigger():
+     * This causes step() to be executed by one of the workers.
+     *
+     * @ingroup CoreLibActivities
+     */
+    class RTT_API ThreadPoolActivity
+        :public base::ActivityInterface
+    {
+    public:
+        /**
+         * Create an activity which is executed by the default pool
+         * of ORO_SCHED_OTHER threads with the lowest priority.
+         * @param run Run this instance.
+         */
+        ThreadPoolActivity( base::RunnableInterface* run = 0 );
+
+        /**
+         * Create an activity which is executed by the pool with
+         * the given scheduler and priority.
+         * @param run Run this instance.
+         */
+        ThreadPoolActivity( int scheduler, int priority, base::RunnableInterface* run = 0 );
+
+        /**
+         * Create an activity which is executed by \a pool.
+         * @param run Run this instance.
+         */
+        ThreadPoolActivity( ThreadPoolPtr pool, base::RunnableInterface* run = 0 );
+
+        /**
+         * Cleanup and notify the base::RunnableInterface that we are gone.
+         */
+        ~ThreadPoolActivity();
+
+        /**
+         * Returns the pool that executes this activity.
+         */
+        ThreadPoolPtr getThreadPool() const;
+
+        Seconds getPeriod() const;
+
+        bool setPeriod(Seconds s);
+
+        unsigned getCpuAffinity() const;
+
+        bool setCpuAffinity(unsigned cpu);
+
+        /**
+         * Returns the worker that is executing this activity or, if it
+         * is not running, a worker that is not the calling thread.
+         * As such, thread()->isSelf() is only true from within step().
+         */
+        os::ThreadInterface* thread();
+
+        bool initialize();
+        void step();
+        void loop();
+        bool breakLoop();
+        void finalize();
+
+        bool start();
+
+        bool stop();
+
+        bool isRunning() const;
+
+        bool isPeriodic() const;
+
+        bool isActive() const;
+
+        bool execute();
+
+        bool trigger();
+
+    private:
+        friend class ThreadPool;
+
+        /**
+         * The states of an activity. stop() adds \a Waiting to the state
+         * while it waits for the activity to become Idle.
+         */
+        enum State { Idle, Queued, Running, Retriggered, Waiting = 4 };
+
+        /**
+         * Called by worker \a w of the pool to execute this activity,
+         * which is in the Queued state.
+         */
+        void work(os::ThreadInterface* w);
+
+        /**
+         * Called by the worker which executed this activity to make it Idle.
+         * Once this returns true, this activity may be deleted.
+         * @return false if this activity was triggered while it was
+         * running, and is Queued again.
+         */
+        bool idle();
+
+        /**
+         * Waits until this activity is not running nor queued anymore.
+         */
+        void waitIdle();
+
+        ThreadPoolPtr mpool;
+        volatile int state;
+        /// Signalled by idle() if stop() waits for this activity.
+        os::Semaphore done;
+        os::ThreadInterface* volatile mworker;
+        bool active;
+        /// Set during stop(), such that no new steps are executed.
+        volatile bool stopping;
+    };
+
+}}
+
+
+#endif
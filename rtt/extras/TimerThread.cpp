@@ -45,6 +45,8 @@
 #include <algorithm>
 #include "../os/MutexLock.hpp"
 #include "../os/MainThread.hpp"
+#include "../os/CAS.hpp"
+#include <sstream>
 
 namespace RTT {
     using namespace extras;
@@ -92,106 +94,256 @@ namespace RTT {
         return ret;
     }
 
+    /**
+     * A thread which steps activities of the current phase
+     * together with the TimerThread.
+     */
+    class TimerThread::Worker
+        : public os::Thread
+    {
+        TimerThread& timer;
+        int executor;
+        unsigned int seen;
+    public:
+        Worker(TimerThread& t, int exec, const std::string& name)
+            : os::Thread(t.getScheduler(), t.getPriority(), 0.0, 0, name),
+              timer(t), executor(exec), seen(0)
+        {}
+
+        ~Worker()
+        {
+            this->stop();
+        }
+
+        bool initialize()
+        {
+            MutexLock locker(timer.work_lock);
+            seen = timer.generation;
+            return true;
+        }
+
+        void loop()
+        {
+            while (true) {
+                {
+                    MutexLock locker(timer.work_lock);
+                    while ( seen == timer.generation && !timer.do_exit )
+                        timer.work_cond.wait(timer.work_lock);
+                    if ( timer.do_exit )
+                        return;
+                    seen = timer.generation;
+                }
+                timer.stepSlots(executor);
+                MutexLock locker(timer.work_lock);
+                if ( --timer.working == 0 )
+                    timer.work_cond.broadcast();
+            }
+        }
+
+        bool breakLoop()
+        {
+            MutexLock locker(timer.work_lock);
+            timer.do_exit = true;
+            timer.work_cond.broadcast();
+            return true;
+        }
+    };
+
     TimerThread::TimerThread(int priority, const std::string& name, double periodicity, unsigned cpu_affinity)
-        : Thread( ORO_SCHED_RT, priority, periodicity, cpu_affinity, name), cleanup(false)
+        : Thread( ORO_SCHED_RT, priority, periodicity, cpu_affinity, name),
+          phases(1), generation(0), working(0), do_exit(false), cur_phase(0), next_slot(0),
+          foreign_step(false)
     {
-    	tasks.reserve(MAX_ACTIVITIES);
+        for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i) {
+            slots[i] = 0;
+            phase_of[i] = 0;
+            busy[i] = 0;
+        }
     }
 
     TimerThread::TimerThread(int scheduler, int priority, const std::string& name, double periodicity, unsigned cpu_affinity)
-        : Thread(scheduler, priority, periodicity, cpu_affinity, name), cleanup(false)
+        : Thread(scheduler, priority, periodicity, cpu_affinity, name),
+          phases(1), generation(0), working(0), do_exit(false), cur_phase(0), next_slot(0),
+          foreign_step(false)
     {
-    	tasks.reserve(MAX_ACTIVITIES);
+        for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i) {
+            slots[i] = 0;
+            phase_of[i] = 0;
+            busy[i] = 0;
+        }
     }
 
     TimerThread::~TimerThread()
     {
         // make sure the thread does not run when we start deleting clocks...
         this->stop();
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            delete workers[i];
     }
 
-    bool TimerThread::addActivity( PeriodicActivity* t ) {
+    bool TimerThread::addActivity( PeriodicActivity* t, int phase ) {
         MutexLock lock(mutex);
-        if ( tasks.size() == MAX_ACTIVITIES ) {
-//             Logger::log() << Logger:: << "TimerThread : tasks queue full, failed to add Activity : "<< t << Logger::endl;
-            return false;
+        if ( phase < 0 ) {
+            // the phase with the least activities.
+            std::vector<unsigned int> load(phases, 0);
+            for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i)
+                if ( slots[i] )
+                    ++load[ phase_of[i] % phases ];
+            phase = min_element(load.begin(), load.end()) - load.begin();
         }
-        tasks.push_back( t );
-//         Logger::log() << Logger::Debug << "TimerThread : successfully started Activity : "<< t  << Logger::endl;
-        return true;
+        for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i)
+            if ( slots[i] == 0 ) {
+                phase_of[i] = phase;
+                // publishes the phase together with the activity.
+                PeriodicActivity* none = 0;
+                os::CAS(&slots[i], none, t);
+                return true;
+            }
+//             Logger::log() << Logger:: << "TimerThread : tasks queue full, failed to add Activity : "<< t << Logger::endl;
+        return false;
     }
 
     bool TimerThread::removeActivity( PeriodicActivity* t ) {
         MutexLock lock(mutex);
-        ActivityList::iterator it = find(tasks.begin(), tasks.end(), t);
-        if ( it != tasks.end() ) {
-            *it = 0; // clear task away
-            cleanup = true;
-            return true;
-        }
+        for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i)
+            if ( slots[i] == t ) {
+                // stepSlots() marks a slot busy before it reads the activity,
+                // we clear the activity before we check if it is busy.
+                PeriodicActivity* none = 0;
+                os::CAS(&slots[i], t, none);
+                int self = executorOf();
+                while ( busy[i] != 0 && busy[i] != self )
+                    this->yield();
+                return true;
+            }
 //         Logger::log() << Logger::Debug << "TimerThread : failed to stop Activity : "<< t->getPeriod() << Logger::endl;
         return false;
     }
 
+    bool TimerThread::setPhases( unsigned int n ) {
+        if ( n == 0 )
+            return false;
+        phases = n;
+        return true;
+    }
+
+    unsigned int TimerThread::getPhases() const {
+        return phases;
+    }
+
+    int TimerThread::getPhase( PeriodicActivity* t ) const {
+        for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i)
+            if ( slots[i] == t )
+                return phase_of[i] % phases;
+        return -1;
+    }
+
+    bool TimerThread::setWorkers( unsigned int n ) {
+        MutexLock lock(mutex);
+        if ( this->isActive() )
+            return false;
+        while ( workers.size() > n ) {
+            delete workers.back();
+            workers.pop_back();
+        }
+        while ( workers.size() < n ) {
+            std::stringstream name;
+            name << getName() << ".worker" << workers.size();
+            workers.push_back( new Worker(*this, workers.size() + 2, name.str()) );
+        }
+        return true;
+    }
+
+    unsigned int TimerThread::getWorkers() const {
+        return workers.size();
+    }
+
+    int TimerThread::executorOf() const {
+        if ( this->isSelf() || foreign_step )
+            return 1;
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            if ( workers[i]->isSelf() )
+                return i + 2;
+        return 0;
+    }
+
     bool TimerThread::initialize() {
+        {
+            MutexLock locker(work_lock);
+            do_exit = false;
+        }
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            if ( !workers[i]->start() )
+                return false;
     	return true;
     }
 
     void TimerThread::finalize() {
         MutexLock lock(mutex);
 
-        for( ActivityList::iterator t_iter = tasks.begin(); t_iter != tasks.end(); ++t_iter)
-            if ( *t_iter )
-                (*t_iter)->stop(); // stop() calls us back to removeActivity (recursive mutex).
-        if ( cleanup )
-            this->reorderList();
+        for (unsigned int i = 0; i != MAX_ACTIVITIES; ++i)
+            if ( slots[i] )
+                slots[i]->stop(); // stop() calls us back to removeActivity (recursive mutex).
+        for (unsigned int i = 0; i != workers.size(); ++i)
+            workers[i]->stop();
     }
 
     void TimerThread::step() {
-        MutexLock lock(mutex);
-
-        // The size of the tasks vector does not change during add/remove, thus
-        // t_iter is never invalidated.
-        for( ActivityList::iterator t_iter = tasks.begin(); t_iter != tasks.end(); ++t_iter)
-        	if ( *t_iter )
-        		(*t_iter)->step();
-
-        if ( cleanup )
-            this->reorderList();
-    }
-
-    void TimerThread::reorderList() {
-        // reorder the list to remove clear'ed tasks
-        ActivityList::iterator begin = tasks.begin();
-        // first zero :
-        PeriodicActivity* nullActivity = 0;
-        ActivityList::iterator it = tasks.begin();
-
-        it = find( tasks.begin(), tasks.end(), nullActivity); // First zero
-        begin = it+1;
-        while ( it != tasks.end() ) {
-            // Look for first non-zero after 'it' :
-            while ( begin != tasks.end() &&  *begin == 0  )
-                ++begin;
-            if ( begin == tasks.end() )  { // if no task found after zero :
-//                 Logger::log() << Logger::Error << "beginBefore resize :"<< tasks.size() << Logger::endl;
-                tasks.resize( it - tasks.begin() ); // cut out the items after 'it'
-//                 Logger::log() << Logger::Error << "beginAfter resize :"<< tasks.size() << Logger::endl;
-                break; // This is our exit condition !
-            }
-            // first zero after begin :
-            ActivityList::iterator end = find ( begin, tasks.end(), nullActivity);
-            // if end == tasks.end() ==> next while will copy all
-            // if end != tasks.end() ==> next while will copy first zero's
-            while ( begin != end ) {
-                *it = *begin; // copy operation
-                ++begin;
-                ++it; // go to next slot to inspect.
+        // SimulationThread steps us from another thread.
+        foreign_step = !this->isSelf();
+        nsecs start = rtos_get_time_ns();
+        unsigned int n = phases;
+        for (unsigned int p = 0; p != n; ++p) {
+            bool empty = true;
+            for (unsigned int i = 0; i != MAX_ACTIVITIES && empty; ++i)
+                empty = slots[i] == 0 || phase_of[i] % n != p;
+            if ( empty )
+                continue;
+            // sleep until the start of this phase.
+            nsecs left = start + getPeriodNS() * p / n - rtos_get_time_ns();
+            if ( p != 0 && left > 0 ) {
+                TIME_SPEC ts = ticks2timespec( nano2ticks(left) );
+                rtos_nanosleep( &ts, 0 );
             }
+            stepPhase(p);
         }
-
-        cleanup = false;
+        foreign_step = false;
     }
 
+    void TimerThread::stepPhase( unsigned int phase ) {
+        cur_phase = phase;
+        next_slot = 0;
+        if ( workers.empty() || !workers[0]->isActive() ) {
+            stepSlots(1);
+            return;
+        }
+        {
+            MutexLock locker(work_lock);
+            working = workers.size();
+            ++generation;
+            work_cond.broadcast();
+        }
+        stepSlots(1);
+        MutexLock locker(work_lock);
+        while ( working != 0 )
+            work_cond.wait(work_lock);
+    }
 
+    void TimerThread::stepSlots( int executor ) {
+        unsigned int n = phases;
+        while (true) {
+            int i = next_slot;
+            if ( i >= int(MAX_ACTIVITIES) )
+                return;
+            if ( !os::CAS(&next_slot, i, i + 1) )
+                continue;
+            if ( slots[i] == 0 || phase_of[i] % n != cur_phase )
+                continue;
+            os::CAS(&busy[i], 0, executor);
+            PeriodicActivity* t = slots[i];
+            if ( t )
+                t->step();
+            os::CAS(&busy[i], executor, 0);
+        }
+    }
 }
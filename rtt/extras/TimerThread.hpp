@@ -48,6 +48,7 @@
 
 #include "../os/Thread.hpp"
 #include "../os/Mutex.hpp"
+#include "../os/Condition.hpp"
 #include "rtt-extras-fwd.hpp"
 
 namespace RTT
@@ -64,14 +65,23 @@ namespace RTT
      * This Periodic Thread is meant for executing a PeriodicActivity
      * object periodically.
      *
+     * The activities are kept in a fixed array of slots, which step()
+     * walks without taking a lock. Adding or removing an activity
+     * therefore never waits for a slow activity, except that
+     * removeActivity() waits until the activity it removes finished
+     * its current step().
+     *
+     * The period can be divided in phases with setPhases(): each
+     * activity is assigned to one phase and stepped at the start of its
+     * part of the period, which spreads activities that share a period
+     * over time. Worker threads, added with setWorkers(), step the
+     * activities of a phase in parallel with this thread.
+     *
      * @see PeriodicActivity
      */
     class RTT_API TimerThread
         : public os::Thread
     {
-        typedef std::vector<PeriodicActivity*> ActivityList ;
-        ActivityList tasks;
-        bool cleanup;
     public:
     	static const unsigned int MAX_ACTIVITIES = 64;
         /**
@@ -102,13 +112,50 @@ namespace RTT
         virtual ~TimerThread();
 
         /**
-         * Add an Timer that will be ticked every execution period
-         * Once added, a timer can not be removed.
+         * Add an Timer that will be ticked every execution period.
+         * @param t The activity to add.
+         * @param phase The phase of the period in which \a t is stepped, or
+         * -1 to choose the phase with the least activities.
+         * @return false if MAX_ACTIVITIES activities were added already.
          */
-        bool addActivity( PeriodicActivity* t );
+        bool addActivity( PeriodicActivity* t, int phase = -1 );
 
+        /**
+         * Removes \a t and waits until it finished its current step(),
+         * unless it is called from that step().
+         */
         bool removeActivity( PeriodicActivity* t );
 
+        /**
+         * Divides each period in \a n phases of equal length.
+         * Activities assigned to phase \a p are stepped \a p / \a n of
+         * a period after the start of the period.
+         * @return false if \a n is zero.
+         */
+        bool setPhases( unsigned int n );
+
+        /**
+         * Returns the number of phases of each period.
+         */
+        unsigned int getPhases() const;
+
+        /**
+         * Returns the phase of \a t, or -1 if it was not added.
+         */
+        int getPhase( PeriodicActivity* t ) const;
+
+        /**
+         * Creates \a n threads which step activities in parallel with this
+         * thread, using the same scheduler and priority.
+         * @return false if this thread is running.
+         */
+        bool setWorkers( unsigned int n );
+
+        /**
+         * Returns the number of worker threads.
+         */
+        unsigned int getWorkers() const;
+
         /**
          * Create a TimerThread with a given priority and periodicity,
          * using the default scheduler, ORO_SCHED_RT.
@@ -126,13 +173,69 @@ namespace RTT
         virtual bool initialize();
         virtual void step();
         virtual void finalize();
-        void reorderList();
+
         /**
+         * Steps the activities of \a phase, together with the workers.
+         */
+        void stepPhase( unsigned int phase );
+
+        /**
+         * Claims and steps activities of the current phase until none
+         * are left.
+         * @param executor 1 for this thread, 2 and up for the workers.
+         */
+        void stepSlots( int executor );
+
+        /**
+         * Returns the executor number of the calling thread, or 0 if it
+         * is not this thread nor a worker.
+         */
+        int executorOf() const;
+
+        /**
+         * Serialises addActivity(), removeActivity() and setWorkers().
+         * step() does not take it.
          * A Activity can not create a activity of same priority from step().
          * If so a deadlock will occur.
          */
         mutable os::MutexRecursive mutex;
 
+        /**
+         * The activities, or zero for free slots.
+         */
+        PeriodicActivity* volatile slots[MAX_ACTIVITIES];
+
+        /**
+         * The phase of each slot.
+         */
+        unsigned int phase_of[MAX_ACTIVITIES];
+
+        /**
+         * The executor stepping each slot, or zero.
+         */
+        volatile int busy[MAX_ACTIVITIES];
+
+        unsigned int phases;
+
+        class Worker;
+        std::vector<Worker*> workers;
+
+        /// Hands the phases to the workers, guards the fields below.
+        os::Mutex work_lock;
+        os::Condition work_cond;
+        /// Incremented for every phase handed to the workers.
+        unsigned int generation;
+        /// The number of workers still stepping the current phase.
+        unsigned int working;
+        bool do_exit;
+
+        /// The phase being stepped and the next slot to claim in it.
+        unsigned int cur_phase;
+        volatile int next_slot;
+
+        /// True while step() is called by another thread than this one.
+        bool foreign_step;
+
         /**
          * A Boost weak pointer is used to store non-owning pointers
          * to shared objects.
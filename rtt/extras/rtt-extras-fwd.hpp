@@ -3,6 +3,7 @@
 
 namespace RTT {
     namespace extras {
+        class ExecutionGraph;
         class FileDescriptorActivity;
         class IRQActivity;
         class PeriodicActivity;
@@ -10,6 +11,8 @@ namespace RTT {
         class SimulationActivity;
         class SimulationThread;
         class SlaveActivity;
+        class ThreadPool;
+        class ThreadPoolActivity;
         class TimerThread;
         struct Provider;
         struct RT_INTR;
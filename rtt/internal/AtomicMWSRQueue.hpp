@@ -254,6 +254,68 @@ namespace RTT
                 return false;
             }
 
+            /**
+             * Enqueue up to \a n items, reserving their places with a single CAS.
+             * @param values The values to enqueue, none of them may be null.
+             * @param n The number of items in \a values.
+             * @return the number of items queued, which is less than \a n
+             * if the queue got full.
+             */
+            size_type enqueue(const T* values, size_type n)
+            {
+                SIndexes oldval, newval;
+                size_type count;
+                do
+                {
+                    oldval._value = _indxes._value;
+                    newval._value = oldval._value;
+                    int room = (oldval._index[1] - oldval._index[0] - 1);
+                    if (room < 0)
+                        room += _size;
+                    count = (size_type)room < n ? room : n;
+                    if (count == 0)
+                        return 0;
+                    newval._index[0] = (oldval._index[0] + count) % _size;
+                } while (!os::CAS(&_indxes._value, oldval._value, newval._value));
+                // the reader stops at the first place we did not fill in yet.
+                for (size_type i = 0; i != count; ++i)
+                    _buf[(oldval._index[0] + i) % _size] = values[i];
+                return count;
+            }
+
+            /**
+             * Dequeue up to \a n items, with a single CAS for moving the read pointer.
+             * Only one thread may call this.
+             * @param results Stores the dequeued values.
+             * @param n The maximum number of items to dequeue.
+             * @return the number of items written to \a results.
+             */
+            size_type dequeue(T* results, size_type n)
+            {
+                SIndexes oldval, newval;
+                oldval._value = _indxes._value;
+                int index = oldval._index[1];
+                size_type count = 0;
+                // stop at the write pointer or at a place that is not yet written.
+                while (count != n && _buf[index])
+                {
+                    results[count++] = _buf[index];
+                    _buf[index] = 0;
+                    if (++index == _size)
+                        index = 0;
+                }
+                if (count == 0)
+                    return 0;
+                do
+                {
+                    oldval._value = _indxes._value;
+                    newval._value = oldval._value;
+                    newval._index[1] = index;
+                    // we need to CAS since the write pointer may have moved.
+                } while (!os::CAS(&_indxes._value, oldval._value, newval._value));
+                return count;
+            }
+
             /**
              * Return the next to be read value.
              */
@@ -41,6 +41,7 @@
 
 #include "../base/ChannelElement.hpp"
 #include "../base/BufferInterface.hpp"
+#include "../os/oro_allocator.hpp"
 
 namespace RTT { namespace internal {
 
@@ -60,6 +61,24 @@ namespace RTT { namespace internal {
     {
         typename base::BufferInterface<T>::shared_ptr buffer;
         typename base::ChannelElement<T>::value_t *last_sample_p;
+        /// The last sample returned by readShared(), in case OldData is read.
+        boost::shared_ptr<const T> last_shared;
+
+        /**
+         * Deleter of the shared samples, which gives the sample back to the
+         * buffer. It keeps the buffer alive as long as the sample is used.
+         */
+        struct SampleReleaser
+        {
+            typename base::BufferInterface<T>::shared_ptr buffer;
+            SampleReleaser(typename base::BufferInterface<T>::shared_ptr buffer) : buffer(buffer) {}
+            void operator()(const T* sample) { buffer->Release( const_cast<T*>(sample) ); }
+        };
+
+        boost::shared_ptr<const T> share(T* sample)
+        {
+            return boost::shared_ptr<const T>( sample, SampleReleaser(buffer), os::rt_allocator<T>() );
+        }
     public:
         typedef typename base::ChannelElement<T>::param_t param_t;
         typedef typename base::ChannelElement<T>::reference_t reference_t;
@@ -100,6 +119,18 @@ namespace RTT { namespace internal {
             return true;
         }
 
+        virtual value_t* loan()
+        {
+            return buffer->Loan();
+        }
+
+        virtual bool commit(value_t* sample)
+        {
+            if (buffer->Commit(sample))
+                return this->signal();
+            return true;
+        }
+
         /** Pops and returns the first element of the FIFO
          *
          * @return false if the FIFO was empty, and true otherwise
@@ -110,6 +141,7 @@ namespace RTT { namespace internal {
             if ( (new_sample_p = buffer->PopWithoutRelease()) ) {
 		if(last_sample_p)
 		    buffer->Release(last_sample_p);
+		last_shared.reset();
 		
 		last_sample_p = new_sample_p;
 		sample = *new_sample_p;
@@ -120,6 +152,68 @@ namespace RTT { namespace internal {
 		    sample = *(last_sample_p);
                 return OldData;
             }
+            if (last_shared) {
+                if(copy_old_data)
+                    sample = *last_shared;
+                return OldData;
+            }
+            return NoData;
+        }
+
+        /** Pops at most \a max elements from the FIFO at once. The last one
+         * is kept for returning OldData in a later read().
+         *
+         * @return the number of elements stored in \a samples
+         */
+        virtual size_t readMany(std::vector<T>& samples, size_t max)
+        {
+            size_t available = buffer->size();
+            if (available > max)
+                available = max;
+            samples.clear();
+            if (available == 0)
+                return 0;
+            if (available > 1)
+                buffer->Pop(samples, available - 1);
+            value_t *new_sample_p = buffer->PopWithoutRelease();
+            if (new_sample_p) {
+                if(last_sample_p)
+                    buffer->Release(last_sample_p);
+                last_shared.reset();
+                last_sample_p = new_sample_p;
+                samples.push_back(*new_sample_p);
+            }
+            return samples.size();
+        }
+
+        /** Pops the first element of the FIFO and hands it out without copying it.
+         * The sample is given back to the buffer when the last reference to it is
+         * dropped. Falls back to copying if the buffer can not share its samples.
+         */
+        virtual FlowStatus readShared(boost::shared_ptr<const T>& sample, bool copy_old_data)
+        {
+            if ( !buffer->supportsZeroCopy() )
+                return base::ChannelElement<T>::readShared(sample, copy_old_data);
+
+            value_t *new_sample_p;
+            if ( (new_sample_p = buffer->PopWithoutRelease()) ) {
+                if(last_sample_p)
+                    buffer->Release(last_sample_p);
+                last_sample_p = 0;
+                last_shared = share(new_sample_p);
+                sample = last_shared;
+                return NewData;
+            }
+            // hand over the sample kept by read() for returning it as OldData.
+            if (last_sample_p) {
+                last_shared = share(last_sample_p);
+                last_sample_p = 0;
+            }
+            if (last_shared) {
+                if(copy_old_data)
+                    sample = last_shared;
+                return OldData;
+            }
             return NoData;
         }
 
@@ -132,6 +226,7 @@ namespace RTT { namespace internal {
 	    if(last_sample_p)
 		buffer->Release(last_sample_p);
 	    last_sample_p = 0;
+            last_shared.reset();
             buffer->clear();
             base::ChannelElement<T>::clear();
         }
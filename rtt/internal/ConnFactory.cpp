@@ -41,6 +41,8 @@
 #include "../base/InputPortInterface.hpp"
 #include "../DataFlowInterface.hpp"
 #include "../types/TypeMarshaller.hpp"
+#include "../TaskContext.hpp"
+#include "../base/ActivityInterface.hpp"
 
 using namespace std;
 using namespace RTT;
@@ -70,6 +72,15 @@ ConnID* StreamConnID::clone() const {
     return new StreamConnID(this->name_id);
 }
 
+int ConnFactory::numaNodeOf(base::PortInterface const& port)
+{
+    DataFlowInterface* iface = port.getInterface();
+    TaskContext* owner = iface ? iface->getOwner() : 0;
+    base::ActivityInterface* activity = owner ? owner->engine()->getActivity() : 0;
+    os::ThreadInterface* thread = activity ? activity->thread() : 0;
+    return thread ? thread->getNumaNode() : -1;
+}
+
 base::ChannelElementBase::shared_ptr RTT::internal::ConnFactory::createRemoteConnection(base::OutputPortInterface& output_port, base::InputPortInterface& input_port, const ConnPolicy& policy)
 {
     // Remote connection
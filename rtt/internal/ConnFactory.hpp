@@ -52,7 +52,11 @@
 #include "../base/DataObjectUnSync.hpp"
 #include "../base/Buffer.hpp"
 #include "../base/BufferUnSync.hpp"
+#ifndef OROBLD_OS_NO_ASM
+#include "../base/BufferLockFreeSPSC.hpp"
+#endif
 #include "../Logger.hpp"
+#include "../os/NumaScope.hpp"
 
 namespace RTT
 { namespace internal {
@@ -145,10 +149,12 @@ namespace RTT
                 {
 #ifndef OROBLD_OS_NO_ASM
                 case ConnPolicy::LOCK_FREE:
+                case ConnPolicy::LOCK_FREE_SPSC: // the lock-free data object is already wait-free for one writer.
                     data_object.reset( new base::DataObjectLockFree<T>(initial_value) );
                     break;
 #else
 		case ConnPolicy::LOCK_FREE:
+		case ConnPolicy::LOCK_FREE_SPSC:
 		    RTT::log(Warning) << "lock free connection policy is unavailable on this system, defaulting to LOCKED" << RTT::endlog();
 #endif
                 case ConnPolicy::LOCKED:
@@ -168,11 +174,21 @@ namespace RTT
                 switch (policy.lock_policy)
                 {
 #ifndef OROBLD_OS_NO_ASM
+                case ConnPolicy::LOCK_FREE_SPSC:
+                    if (policy.type == ConnPolicy::BUFFER) {
+                        buffer_object = new base::BufferLockFreeSPSC<T>(policy.size, initial_value);
+                    } else {
+                        // Dropping the oldest sample needs the consumer side, so circular buffers remain multi-writer.
+                        RTT::log(Warning) << "LOCK_FREE_SPSC is not available for a CIRCULAR_BUFFER, defaulting to LOCK_FREE" << RTT::endlog();
+                        buffer_object = new base::BufferLockFree<T>(policy.size, initial_value, true);
+                    }
+                    break;
                 case ConnPolicy::LOCK_FREE:
                     buffer_object = new base::BufferLockFree<T>(policy.size, initial_value, policy.type == ConnPolicy::CIRCULAR_BUFFER);
                     break;
 #else
 		case ConnPolicy::LOCK_FREE:
+		case ConnPolicy::LOCK_FREE_SPSC:
 		    RTT::log(Warning) << "lock free connection policy is unavailable on this system, defaulting to LOCKED" << RTT::endlog();
 #endif
                 case ConnPolicy::LOCKED:
@@ -256,6 +272,8 @@ namespace RTT
         {
             assert(conn_id);
             base::ChannelElementBase::shared_ptr endpoint = new ConnOutputEndpoint<T>(&port, conn_id);
+            // the storage is read by the thread of the input port's component.
+            os::NumaScope numa( numaNodeOf(port) );
             base::ChannelElementBase::shared_ptr data_object = buildDataStorage<T>(policy, initial_value);
             data_object->setOutput(endpoint);
             return data_object;
@@ -353,6 +371,12 @@ namespace RTT
         }
 
     protected:
+        /**
+         * Returns the NUMA node of the thread which runs the component
+         * of \a port, or -1 if it was not placed on a node.
+         */
+        static int numaNodeOf(base::PortInterface const& port);
+
         static bool createAndCheckConnection(base::OutputPortInterface& output_port, base::InputPortInterface& input_port, base::ChannelElementBase::shared_ptr channel_input, ConnPolicy policy);
 
         static bool createAndCheckStream(base::InputPortInterface& input_port, ConnPolicy const& policy, base::ChannelElementBase::shared_ptr outhalf, StreamConnID* conn_id);
@@ -97,6 +97,27 @@ namespace RTT
         virtual bool write(typename base::ChannelElement<T>::param_t sample)
         { return false; }
 
+        /** Forwards to the data storage element, such that it can share
+         * its samples with the port instead of copying them. */
+        virtual FlowStatus readShared(boost::shared_ptr<const T>& sample, bool copy_old_data)
+        {
+            typename base::ChannelElement<T>::shared_ptr input = this->getInput();
+            if (input)
+                return input->readShared(sample, copy_old_data);
+            return NoData;
+        }
+
+        /** Forwards to the data storage element, such that it can read
+         * the samples in one go. */
+        virtual size_t readMany(std::vector<T>& samples, size_t max)
+        {
+            typename base::ChannelElement<T>::shared_ptr input = this->getInput();
+            if (input)
+                return input->readMany(samples, max);
+            samples.clear();
+            return 0;
+        }
+
         virtual void disconnect(bool forward)
         {
             // Call the base class: it does the common cleanup
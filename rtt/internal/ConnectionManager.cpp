@@ -48,9 +48,20 @@
 #include <boost/scoped_ptr.hpp>
 #include "../base/PortInterface.hpp"
 #include "../os/MutexLock.hpp"
+#include "../os/MainThread.hpp"
+#include "../os/CAS.hpp"
 #include "../base/InputPortInterface.hpp"
+#include <algorithm>
 #include <cassert>
 
+/**
+ * The number of times publish() yields while waiting for the port operations
+ * which use a replaced snapshot, before leaving its deletion to a later call.
+ */
+#ifndef ORONUM_CONNECTION_GRACE_YIELDS
+#define ORONUM_CONNECTION_GRACE_YIELDS 100
+#endif
+
 namespace RTT
 {
     using namespace detail;
@@ -60,6 +71,7 @@ namespace RTT
 
         ConnectionManager::ConnectionManager(PortInterface* port)
             : mport(port)
+            , channels(NULL)
             , cur_channel(NULL)
         {
         }
@@ -67,32 +79,110 @@ namespace RTT
         ConnectionManager::~ConnectionManager()
         {
             this->disconnect();
+            // no port operations can be in progress anymore.
+            for (std::vector<ChannelSnapshot*>::iterator it = retired.begin(); it != retired.end(); ++it)
+                delete *it;
         }
 
         /**
          * Helper function to clear a connection.
          * @param descriptor
          */
-        void clearChannel(ConnectionManager::ChannelDescriptor& descriptor) {
+        void clearChannel(ConnectionManager::ChannelDescriptor const& descriptor) {
             descriptor.get<1>()->clear();
         }
 
         void ConnectionManager::clear()
-        { RTT::os::MutexLock lock(connection_lock);
-            std::for_each(connections.begin(), connections.end(), &clearChannel);
+        {
+            ReadSection section(*this);
+            const ChannelSnapshot* snapshot = section.get();
+            if (snapshot)
+                std::for_each(snapshot->begin(), snapshot->end(), &clearChannel);
         }
 
-        bool ConnectionManager::findMatchingPort(ConnID const* conn_id, ChannelDescriptor const& descriptor)
+        void ConnectionManager::publish(ChannelSnapshot* next)
         {
-            return ( descriptor.get<0>() && conn_id->isSameID(*descriptor.get<0>()));
+            ChannelSnapshot* previous = channels;
+            // the CAS can not fail, since all writers hold connection_lock,
+            // but it orders the filling in of next before its publication.
+            os::CAS(&channels, previous, next);
+            if (previous)
+                retired.push_back(previous);
+            // Slow readers do not keep us waiting under connection_lock: the
+            // snapshots they may use are deleted by a later publish() instead.
+            if ( retired.empty() || !waitForReaders() )
+                return;
+            for (std::vector<ChannelSnapshot*>::iterator it = retired.begin(); it != retired.end(); ++it)
+                delete *it;
+            retired.clear();
         }
 
-        void ConnectionManager::updateCurrentChannel(bool reset_current)
+        bool ConnectionManager::waitForReaders()
         {
-            if (connections.empty())
-                cur_channel = NULL;
-            else if (reset_current)
-                cur_channel = &(connections.front());
+            // Wait for both counters to drain once. A reader that picked
+            // the old epoch just before the first flip is then waited for
+            // in the second round. The flips are serialised by connection_lock.
+            for (int round = 0; round != 2; ++round) {
+                int counter = epoch.read() & 1;
+                epoch.inc();
+                for (int yields = 0; readers[counter].read() != 0; ++yields) {
+                    if ( yields == ORONUM_CONNECTION_GRACE_YIELDS )
+                        return false;
+                    os::MainThread::Instance()->yield();
+                }
+            }
+            return true;
+        }
+
+        const ConnectionManager::ChannelDescriptor* ConnectionManager::findCurrentChannel(const ChannelSnapshot& snapshot) const
+        {
+            if (snapshot.empty())
+                return NULL;
+            base::ChannelElementBase* current = cur_channel;
+            if (current) {
+                ChannelSnapshot::const_iterator it;
+                for (it = snapshot.begin(); it != snapshot.end(); ++it)
+                    if (it->get<1>().get() == current)
+                        return &(*it);
+            }
+            // none selected or the selected one was removed: fall back to the first.
+            return &snapshot.front();
+        }
+
+        bool ConnectionManager::isSingleConnection() const
+        {
+            ReadSection section(*this);
+            return section.get() && section.get()->size() == 1;
+        }
+
+        base::ChannelElementBase* ConnectionManager::getCurrentChannel() const
+        {
+            ReadSection section(*this);
+            const ChannelDescriptor* current = section.get() ? findCurrentChannel(*section.get()) : NULL;
+            return current ? current->get<1>().get() : NULL;
+        }
+
+        base::ChannelElementBase::shared_ptr ConnectionManager::getSingleChannel() const
+        {
+            ReadSection section(*this);
+            const ChannelSnapshot* snapshot = section.get();
+            if (snapshot && snapshot->size() == 1)
+                return snapshot->front().get<1>();
+            return base::ChannelElementBase::shared_ptr();
+        }
+
+        std::list<ConnectionManager::ChannelDescriptor> ConnectionManager::getChannels() const
+        {
+            ReadSection section(*this);
+            const ChannelSnapshot* snapshot = section.get();
+            if (!snapshot)
+                return std::list<ChannelDescriptor>();
+            return std::list<ChannelDescriptor>(snapshot->begin(), snapshot->end());
+        }
+
+        bool ConnectionManager::findMatchingPort(ConnID const* conn_id, ChannelDescriptor const& descriptor)
+        {
+            return ( descriptor.get<0>() && conn_id->isSameID(*descriptor.get<0>()));
         }
 
         bool ConnectionManager::disconnect(PortInterface* port)
@@ -116,40 +206,48 @@ namespace RTT
         {
             std::list<ChannelDescriptor> all_connections;
             { RTT::os::MutexLock lock(connection_lock);
-                all_connections.splice(all_connections.end(), connections);
+                if (channels)
+                    all_connections.assign(channels->begin(), channels->end());
                 cur_channel = NULL;
+                publish(NULL);
             }
             std::for_each(all_connections.begin(), all_connections.end(),
                     boost::bind(&ConnectionManager::eraseConnection, this, _1));
         }
 
         bool ConnectionManager::connected() const
-        { return !connections.empty(); }
+        { return channels != NULL; }
 
 
         void ConnectionManager::addConnection(ConnID* conn_id, ChannelElementBase::shared_ptr channel, ConnPolicy policy)
         { RTT::os::MutexLock lock(connection_lock);
             assert(conn_id);
             ChannelDescriptor descriptor = boost::make_tuple(conn_id, channel, policy);
-            connections.insert(connections.end(), descriptor);
-            if (connections.size() == 1)
-                cur_channel = &(connections.front());
+            ChannelSnapshot* next = channels ? new ChannelSnapshot(*channels) : new ChannelSnapshot();
+            next->push_back(descriptor);
+            publish(next);
         }
 
         bool ConnectionManager::removeConnection(ConnID* conn_id)
         {
             ChannelDescriptor descriptor;
             { RTT::os::MutexLock lock(connection_lock);
-                std::list<ChannelDescriptor>::iterator conn_it =
-                    std::find_if(connections.begin(), connections.end(), boost::bind(&ConnectionManager::findMatchingPort, this, conn_id, _1));
-                if (conn_it == connections.end())
+                if (!channels)
+                    return false;
+                ChannelSnapshot::const_iterator conn_it =
+                    std::find_if(channels->begin(), channels->end(), boost::bind(&ConnectionManager::findMatchingPort, this, conn_id, _1));
+                if (conn_it == channels->end())
                     return false;
                 descriptor = *conn_it;
-                // Verify whether cur_channel is conn_it before we erase, as
-                // cur_channel is a pointer to an element in connections
-                bool reset_current = cur_channel && (cur_channel->get<1>() == descriptor.get<1>());
-                connections.erase(conn_it);
-                updateCurrentChannel(reset_current);
+                ChannelSnapshot* next = 0;
+                if (channels->size() != 1) {
+                    next = new ChannelSnapshot();
+                    next->reserve(channels->size() - 1);
+                    for (ChannelSnapshot::const_iterator it = channels->begin(); it != channels->end(); ++it)
+                        if (it != conn_it)
+                            next->push_back(*it);
+                }
+                publish(next);
             }
 
             // disconnect needs to know if we're from Out->In (forward) or from In->Out
@@ -161,6 +259,26 @@ namespace RTT
             return true;
         }
 
+        void ConnectionManager::eraseChannels(std::vector<base::ChannelElementBase*> const& invalid)
+        { RTT::os::MutexLock lock(connection_lock);
+            if (!channels)
+                return;
+            ChannelSnapshot* next = new ChannelSnapshot();
+            for (ChannelSnapshot::const_iterator it = channels->begin(); it != channels->end(); ++it)
+                if ( std::find(invalid.begin(), invalid.end(), it->get<1>().get()) == invalid.end() )
+                    next->push_back(*it);
+            if (next->size() == channels->size()) {
+                // already removed by someone else.
+                delete next;
+                return;
+            }
+            if (next->empty()) {
+                delete next;
+                next = 0;
+            }
+            publish(next);
+        }
+
         bool is_same_id(ConnID* conn_id, ConnectionManager::ChannelDescriptor const& channel)
         {
             return conn_id->isSameID( *channel.get<0>() );
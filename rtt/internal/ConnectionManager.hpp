@@ -51,6 +51,7 @@
 #include "List.hpp"
 #include "../ConnPolicy.hpp"
 #include "../os/Mutex.hpp"
+#include "../os/Atomic.hpp"
 #include "../base/rtt-base-fwd.hpp"
 #include "../base/ChannelElementBase.hpp"
 #include <boost/tuple/tuple.hpp>
@@ -60,6 +61,7 @@
 #include <rtt/os/Mutex.hpp>
 #include <rtt/os/MutexLock.hpp>
 #include <list>
+#include <vector>
 
 
 namespace RTT
@@ -71,7 +73,17 @@ namespace RTT
          * Manages connections between ports.
          * This class is used for input and output ports
          * in order to manage their channels.
-         * TODO: use the mutex lock !!!
+         *
+         * The channels are kept in an immutable snapshot, which
+         * is replaced as a whole when a connection is added or removed.
+         * Reading and writing a port only uses the snapshot and never
+         * takes a lock, such that the data flow does not contend with
+         * connection management, nor do several readers of one output
+         * port contend with each other. Any number of threads may use
+         * the data flow functions of a port at the same time.
+         * Adding and removing connections is serialised by a mutex.
+         * A replaced snapshot is deleted once no port operation uses it
+         * anymore.
          */
         class RTT_API ConnectionManager
         {
@@ -114,21 +126,29 @@ namespace RTT
             /** Removes the channel that connects this port to \c port */
             bool disconnect(base::PortInterface* port);
 
+            /**
+             * Calls \a pred for each connection and removes the
+             * connections for which it returns true. These connections
+             * are not disconnected.
+             * @note Real-time as long as \a pred returns false.
+             */
             template<typename Pred>
             bool delete_if(Pred pred) {
-                RTT::os::MutexLock lock(connection_lock);
-                bool result = false;
-                std::list<ChannelDescriptor>::iterator it = connections.begin();
-                while (it != connections.end())
+                std::vector<base::ChannelElementBase*> invalid;
                 {
-                    if (pred(*it))
-                    {
-                        result = true;
-                        it = connections.erase(it);
-                    }
-                    else ++it;
+                    ReadSection section(*this);
+                    const ChannelSnapshot* snapshot = section.get();
+                    if (!snapshot)
+                        return false;
+                    ChannelSnapshot::const_iterator it;
+                    for (it = snapshot->begin(); it != snapshot->end(); ++it)
+                        if (pred(*it))
+                            invalid.push_back( it->get<1>().get() );
                 }
-                return result;
+                if ( invalid.empty() )
+                    return false;
+                eraseChannels(invalid);
+                return true;
             }
 
             /**
@@ -141,58 +161,46 @@ namespace RTT
              */
             template<typename Pred>
             void select_reader_channel(Pred pred, bool copy_old_data) {
-                RTT::os::MutexLock lock(connection_lock);
-                ChannelDescriptor *new_channel =
-                    find_if(pred, copy_old_data);
+                ReadSection section(*this);
+                const ChannelSnapshot* snapshot = section.get();
+                if (!snapshot)
+                    return;
+                const ChannelDescriptor *new_channel =
+                    find_if(*snapshot, pred, copy_old_data);
                 if (new_channel)
                 {
                     // We don't clear the current channel (to get it to NoData state), because there is a race
                     // between find_if and this line. We have to accept (in other parts of the code) that eventually,
                     // all channels return 'OldData'.
-                    cur_channel = new_channel;
+                    cur_channel = new_channel->get<1>().get();
                 }
             }
 
-            template<typename Pred>
-            ChannelDescriptor *find_if(Pred pred, bool copy_old_data) {
-                // We only copy OldData in the initial read of the current channel.
-                // if it has no new data, the search over the other channels starts,
-                // but no old data is needed.
-                ChannelDescriptor *channel = cur_channel;
-                if ( channel )
-                    if ( pred( copy_old_data, *channel ) )
-                        return channel;
-
-                std::list<ChannelDescriptor>::iterator result;
-                for (result = connections.begin(); result != connections.end(); ++result) {
-                    if (cur_channel && (result->get<1>() == cur_channel->get<1>())) continue;
-                    if ( pred(false, *result) == true)
-                        return &(*result);
-                }
-                return NULL;
-            }
-
             /**
              * Returns true if this manager manages only one connection.
              * @return
              */
-            bool isSingleConnection() const { return connections.size() == 1; }
+            bool isSingleConnection() const;
 
             /**
              * Returns the first added channel or if select_if was called, the selected channel.
              * @see select_if to change the current channel.
              * @return
              */
-            base::ChannelElementBase* getCurrentChannel() const {
-                return cur_channel ? cur_channel->get<1>().get() : NULL;
-            }
+            base::ChannelElementBase* getCurrentChannel() const;
+
+            /**
+             * Returns the channel of this manager if it manages exactly one
+             * connection. Unlike getCurrentChannel(), the returned channel
+             * remains valid if the connection is removed concurrently.
+             * @return null if there are no or several connections.
+             */
+            base::ChannelElementBase::shared_ptr getSingleChannel() const;
 
             /**
              * Returns a list of all channels managed by this object.
              */
-            std::list<ChannelDescriptor> getChannels() const {
-                return connections;
-            }
+            std::list<ChannelDescriptor> getChannels() const;
 
             /**
              * Clears (removes) all data in the manager's connections.
@@ -202,21 +210,93 @@ namespace RTT
             void clear();
 
             /**
-             * Locks the mutex protecting the channel element list.
+             * Locks the mutex protecting modifications of the channel list.
+             * While it is held, the channels can not be added or removed.
              * */
             void lock() const {
                 connection_lock.lock();
             };
 
             /**
-             * Unlocks the mutex protecting the channel element list.
+             * Unlocks the mutex protecting modifications of the channel list.
              * */
             void unlock() const {
                 connection_lock.unlock();
             }
         protected:
+            /**
+             * An immutable list of channels, published as a whole.
+             */
+            typedef std::vector<ChannelDescriptor> ChannelSnapshot;
+
+            /**
+             * Marks the lifetime in which a port function uses the
+             * current snapshot. Writers wait for all sections that
+             * may have seen a replaced snapshot before deleting it.
+             * The readers are counted in one of two counters, chosen
+             * by the current epoch, such that a continuous stream of
+             * readers can not keep a writer waiting forever.
+             */
+            class ReadSection
+            {
+                const ConnectionManager& cm;
+                const int counter;
+            public:
+                ReadSection(const ConnectionManager& cm)
+                    : cm(cm), counter( cm.epoch.read() & 1 )
+                {
+                    // the increment is a full barrier, so the snapshot
+                    // is read after we are counted.
+                    cm.readers[counter].inc();
+                }
+                ~ReadSection() { cm.readers[counter].dec(); }
+                /** The snapshot, null if there are no connections. */
+                const ChannelSnapshot* get() const { return cm.channels; }
+            };
 
-            void updateCurrentChannel(bool reset_current);
+            template<typename Pred>
+            const ChannelDescriptor *find_if(const ChannelSnapshot& snapshot, Pred pred, bool copy_old_data) {
+                // We only copy OldData in the initial read of the current channel.
+                // if it has no new data, the search over the other channels starts,
+                // but no old data is needed.
+                const ChannelDescriptor *channel = findCurrentChannel(snapshot);
+                if ( channel )
+                    if ( pred( copy_old_data, *channel ) )
+                        return channel;
+
+                ChannelSnapshot::const_iterator result;
+                for (result = snapshot.begin(); result != snapshot.end(); ++result) {
+                    if (channel && (result->get<1>() == channel->get<1>())) continue;
+                    if ( pred(false, *result) == true)
+                        return &(*result);
+                }
+                return NULL;
+            }
+
+            /**
+             * Returns the descriptor of the current channel in \a snapshot,
+             * which is the first channel if no channel was selected or if the
+             * selected channel was removed.
+             */
+            const ChannelDescriptor* findCurrentChannel(const ChannelSnapshot& snapshot) const;
+
+            /**
+             * Replaces the snapshot with \a next and retires the previous one.
+             * The retired snapshots are deleted as soon as no port operation
+             * uses them anymore. Must be called with connection_lock held.
+             */
+            void publish(ChannelSnapshot* next);
+
+            /**
+             * Waits a bounded time until all port operations which may
+             * have seen a retired snapshot have finished.
+             * Must be called with connection_lock held.
+             * @return true if they all finished.
+             */
+            bool waitForReaders();
+
+            /** Removes the given channels, without disconnecting them. */
+            void eraseChannels(std::vector<base::ChannelElementBase*> const& invalid);
 
             /** Helper method for disconnect(PortInterface*)
              *
@@ -243,19 +323,32 @@ namespace RTT
             base::PortInterface* mport;
 
             /**
-             * A list of all our connections. Only non-null if two or more connections
-             * were added.
+             * The current snapshot of all our connections, null if there are none.
+             */
+            ChannelSnapshot* volatile channels;
+
+            /**
+             * Replaced snapshots which may still be in use by port operations.
+             * Protected by connection_lock.
+             */
+            std::vector<ChannelSnapshot*> retired;
+
+            /**
+             * The channel last selected by select_reader_channel().
+             * It is only compared against, never dereferenced.
              */
-            std::list< ChannelDescriptor > connections;
+            base::ChannelElementBase* volatile cur_channel;
 
             /**
-             * Optimisation in case only one channel is to be managed.
+             * The epoch selects which of the two \c readers counters
+             * new ReadSections increment.
              */
-            ChannelDescriptor *cur_channel;
+            os::AtomicInt epoch;
+            mutable os::AtomicInt readers[2];
 
             /**
-             * Lock that should be taken before the list of connections is
-             * accessed or modified
+             * Lock that serialises the modifications of the
+             * connections.
              */
             mutable RTT::os::Mutex connection_lock;
         };
@@ -0,0 +1,228 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 03:19:30 UTC 2026  ExecutionProfiler.cpp
+
+                        ExecutionProfiler.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "ExecutionProfiler.hpp"
+#include "../base/ExecutableInterface.hpp"
+#include "../os/TimeService.hpp"
+#include <cstdio>
+#include <cstring>
+#include <time.h>
+
+namespace RTT {
+    using namespace internal;
+
+    ExecutionProfiler::Profile::Profile()
+        : count(0), last(0), min(0), mean(0), max(0), p99(0)
+    {
+    }
+
+    ExecutionProfiler::ExecutionProfiler()
+        : enabled(true)
+    {
+        const char* names[FixedEntries] = { "prepareUpdateHook", "updateHook", "errorHook", "messages", "functions" };
+        for (int i = 0; i != FixedEntries; ++i) {
+            strncpy(entries[i].name, names[i], sizeof(entries[i].name) - 1);
+            entries[i].used = true;
+        }
+    }
+
+    nsecs ExecutionProfiler::now()
+    {
+#if defined(CLOCK_MONOTONIC_RAW) || defined(CLOCK_MONOTONIC)
+        timespec ts;
+# ifdef CLOCK_MONOTONIC_RAW
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+# else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+# endif
+        return nsecs( ts.tv_sec ) * 1000000000LL + nsecs( ts.tv_nsec );
+#else
+        return os::TimeService::ticks2nsecs( os::TimeService::Instance()->getTicks() );
+#endif
+    }
+
+    void ExecutionProfiler::record(Entry entry, nsecs start)
+    {
+        if ( !enabled || start == 0 )
+            return;
+        nsecs duration = now() - start;
+        entries[entry].last = duration;
+        entries[entry].histogram.record(duration);
+    }
+
+    void ExecutionProfiler::recordFunction(base::ExecutableInterface* f, nsecs start)
+    {
+        if ( !enabled || start == 0 )
+            return;
+        nsecs duration = now() - start;
+        Slot* slot = 0;
+        Slot* free_slot = 0;
+        for (int i = 0; i != MaxFunctions && !slot; ++i) {
+            if ( functions[i].owner == f )
+                slot = &functions[i];
+            // prefer slots which were never used, such that the
+            // measurements of unloaded functions remain longer.
+            else if ( functions[i].owner == 0 && (!free_slot || (free_slot->used && !functions[i].used)) )
+                free_slot = &functions[i];
+        }
+        if ( !slot ) {
+            if ( !free_slot )
+                return;
+            slot = free_slot;
+            slot->used = false;
+            slot->histogram.reset();
+            std::string name = f->getExecutableName();
+            if ( name.empty() )
+                snprintf(slot->name, sizeof(slot->name), "function%d", int(slot - functions));
+            else
+                snprintf(slot->name, sizeof(slot->name), "%s", name.c_str());
+            slot->owner = f;
+            slot->used = true;
+        }
+        slot->last = duration;
+        slot->histogram.record(duration);
+    }
+
+    bool ExecutionProfiler::addChild(base::TaskCore* child, const std::string& name)
+    {
+        Slot* slots = 0;
+        for (int i = 0; i != MaxChildren && !slots; ++i)
+            if ( children[i][0].owner == child )
+                slots = children[i];
+        for (int i = 0; i != MaxChildren && !slots; ++i)
+            if ( children[i][0].owner == 0 )
+                slots = children[i];
+        if ( !slots )
+            return false;
+        for (int e = 0; e != HookEntries; ++e) {
+            slots[e].used = false;
+            snprintf(slots[e].name, sizeof(slots[e].name), "%s.%s", name.c_str(), entries[e].name);
+        }
+        if ( slots[0].owner != child ) {
+            for (int e = 0; e != HookEntries; ++e)
+                slots[e].histogram.reset();
+            slots[0].owner = child;
+        }
+        for (int e = 0; e != HookEntries; ++e)
+            slots[e].used = true;
+        return true;
+    }
+
+    void ExecutionProfiler::removeChild(base::TaskCore* child)
+    {
+        for (int i = 0; i != MaxChildren; ++i)
+            if ( children[i][0].owner == child ) {
+                for (int e = 0; e != HookEntries; ++e)
+                    children[i][e].used = false;
+                children[i][0].owner = 0;
+            }
+    }
+
+    void ExecutionProfiler::recordChild(base::TaskCore* child, Entry entry, nsecs start)
+    {
+        if ( !enabled || start == 0 || entry >= HookEntries )
+            return;
+        nsecs duration = now() - start;
+        for (int i = 0; i != MaxChildren; ++i)
+            if ( children[i][0].owner == child ) {
+                children[i][entry].last = duration;
+                children[i][entry].histogram.record(duration);
+                return;
+            }
+    }
+
+    void ExecutionProfiler::releaseFunction(base::ExecutableInterface* f)
+    {
+        for (int i = 0; i != MaxFunctions; ++i)
+            if ( functions[i].owner == f )
+                functions[i].owner = 0;
+    }
+
+    ExecutionProfiler::Profile ExecutionProfiler::getProfile(const Slot& slot) const
+    {
+        Profile profile;
+        os::JitterStatistics stats = slot.histogram.getStatistics();
+        profile.name = slot.name;
+        profile.count = stats.samples;
+        profile.last = stats.samples ? nsecs(slot.last) : 0;
+        profile.min = stats.min;
+        profile.mean = stats.mean;
+        profile.max = stats.max;
+        profile.p99 = stats.p99;
+        return profile;
+    }
+
+    std::vector<ExecutionProfiler::Profile> ExecutionProfiler::getProfiles() const
+    {
+        std::vector<Profile> result;
+        for (int i = 0; i != FixedEntries; ++i)
+            result.push_back( getProfile(entries[i]) );
+        for (int i = 0; i != MaxChildren; ++i)
+            for (int e = 0; e != HookEntries; ++e)
+                if ( children[i][e].used )
+                    result.push_back( getProfile(children[i][e]) );
+        for (int i = 0; i != MaxFunctions; ++i)
+            if ( functions[i].used )
+                result.push_back( getProfile(functions[i]) );
+        return result;
+    }
+
+    bool ExecutionProfiler::getProfile(const std::string& name, Profile& profile) const
+    {
+        std::vector<Profile> profiles = getProfiles();
+        for (unsigned int i = 0; i != profiles.size(); ++i)
+            if ( profiles[i].name == name ) {
+                profile = profiles[i];
+                return true;
+            }
+        return false;
+    }
+
+    void ExecutionProfiler::reset()
+    {
+        for (int i = 0; i != FixedEntries; ++i)
+            entries[i].histogram.reset();
+        for (int i = 0; i != MaxFunctions; ++i)
+            functions[i].histogram.reset();
+        for (int i = 0; i != MaxChildren; ++i)
+            for (int e = 0; e != HookEntries; ++e)
+                children[i][e].histogram.reset();
+    }
+}
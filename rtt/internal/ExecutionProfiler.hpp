@@ -0,0 +1,202 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 03:19:30 UTC 2026  ExecutionProfiler.hpp
+
+                        ExecutionProfiler.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_EXECUTION_PROFILER_HPP
+#define ORO_EXECUTION_PROFILER_HPP
+
+#include "../os/JitterHistogram.hpp"
+#include "../base/rtt-base-fwd.hpp"
+#include "../rtt-config.h"
+#include <string>
+#include <vector>
+
+namespace RTT
+{ namespace internal {
+
+    /**
+     * Measures how long an ExecutionEngine spends in each hook of its
+     * component and of its child TaskCores, in each batch of messages
+     * and in each loaded function.
+     *
+     * Only the thread of the engine records measurements, without
+     * locking or allocating memory. Other threads read or reset them
+     * at any time. The profiler is enabled by default; a measurement
+     * costs two reads of the clock and a histogram update.
+     */
+    class RTT_API ExecutionProfiler
+    {
+    public:
+        /**
+         * The measurements which are always present.
+         */
+        enum Entry { PrepareUpdateHook, UpdateHook, ErrorHook, Messages, Functions, FixedEntries };
+
+        /**
+         * The entries which are measured for each child as well.
+         */
+        enum { HookEntries = ErrorHook + 1 };
+
+        /**
+         * The number of functions measured separately. When more functions
+         * are loaded, the ones loaded last are only part of Functions.
+         */
+        enum { MaxFunctions = 16 };
+
+        /**
+         * The number of children measured separately. The hooks of
+         * children added after these are not measured.
+         */
+        enum { MaxChildren = 16 };
+
+        /**
+         * The execution times of one entry, in nanoseconds.
+         */
+        struct Profile
+        {
+            Profile();
+
+            std::string name;
+            /** The number of executions. */
+            unsigned long count;
+            nsecs last;
+            nsecs min;
+            nsecs mean;
+            nsecs max;
+            /** 99% of the executions took less than or equal to this time. */
+            nsecs p99;
+        };
+
+        ExecutionProfiler();
+
+        /**
+         * The current time in nanoseconds of a monotonic clock, which
+         * is not slewed when the system time is adjusted if the target
+         * supports CLOCK_MONOTONIC_RAW.
+         */
+        static nsecs now();
+
+        /**
+         * The time to pass to record(), or zero when disabled.
+         */
+        nsecs start() const { return enabled ? now() : 0; }
+
+        /**
+         * Starts or stops taking measurements.
+         */
+        void setEnabled(bool tf) { enabled = tf; }
+
+        bool isEnabled() const { return enabled; }
+
+        /**
+         * Records an execution of \a entry which started at \a start.
+         * Does nothing when disabled or when \a start is zero.
+         */
+        void record(Entry entry, nsecs start);
+
+        /**
+         * Records an execution of function \a f which started at \a start.
+         * Does nothing when disabled or when \a start is zero.
+         */
+        void recordFunction(base::ExecutableInterface* f, nsecs start);
+
+        /**
+         * Reserves the hook entries of \a child, which are named
+         * \a name followed by a dot and the name of the hook. Adding
+         * a child again renames its entries.
+         * @return false if all child slots are in use.
+         */
+        bool addChild(base::TaskCore* child, const std::string& name);
+
+        /**
+         * Removes the hook entries of \a child.
+         */
+        void removeChild(base::TaskCore* child);
+
+        /**
+         * Records an execution of hook \a entry of \a child which
+         * started at \a start. Does nothing when disabled, when \a
+         * start is zero or when \a child was not added.
+         */
+        void recordChild(base::TaskCore* child, Entry entry, nsecs start);
+
+        /**
+         * Frees the slot of \a f, which was unloaded. Its
+         * measurements remain until the slot is used again.
+         */
+        void releaseFunction(base::ExecutableInterface* f);
+
+        /**
+         * Returns the measurements of the fixed entries, of the hooks
+         * of each child and of each function which was executed.
+         */
+        std::vector<Profile> getProfiles() const;
+
+        /**
+         * Returns the measurements of the entry or function \a name.
+         * @return false if there is no such entry.
+         */
+        bool getProfile(const std::string& name, Profile& profile) const;
+
+        /**
+         * Restarts all measurements.
+         */
+        void reset();
+
+    private:
+        struct Slot
+        {
+            Slot() : owner(0), used(false), last(0) { name[0] = 0; }
+            const void* volatile owner;
+            volatile bool used;
+            char name[64];
+            os::JitterHistogram histogram;
+            volatile nsecs last;
+        };
+
+        Profile getProfile(const Slot& slot) const;
+
+        volatile bool enabled;
+        Slot entries[FixedEntries];
+        Slot functions[MaxFunctions];
+        Slot children[MaxChildren][HookEntries];
+    };
+}}
+
+#endif
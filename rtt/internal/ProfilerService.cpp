@@ -0,0 +1,159 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 03:19:30 UTC 2026  ProfilerService.cpp
+
+                        ProfilerService.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "ProfilerService.hpp"
+#include "../TaskContext.hpp"
+#include <sstream>
+#include <iomanip>
+
+namespace RTT {
+    using namespace internal;
+
+    ProfilerService::shared_ptr ProfilerService::Create(TaskContext* parent){
+        shared_ptr sp(new ProfilerService(parent));
+        parent->provides()->addService( sp );
+        return sp;
+    }
+
+    ProfilerService::ProfilerService(TaskContext* parent)
+        : Service("profiler", parent), mtc(parent)
+    {
+        this->doc("Execution times of the hooks, messages and functions of this TaskContext and of its children.");
+        this->addOperation("getEntries", &ProfilerService::getEntries, this)
+                .doc("Returns the names of the measured entries.");
+        this->addOperation("getCount", &ProfilerService::getCount, this)
+                .doc("Returns the number of executions.").arg("Entry", "The name of the entry.");
+        this->addOperation("getLast", &ProfilerService::getLast, this)
+                .doc("Returns the last execution time in seconds.").arg("Entry", "The name of the entry.");
+        this->addOperation("getMin", &ProfilerService::getMin, this)
+                .doc("Returns the minimum execution time in seconds.").arg("Entry", "The name of the entry.");
+        this->addOperation("getMax", &ProfilerService::getMax, this)
+                .doc("Returns the maximum execution time in seconds.").arg("Entry", "The name of the entry.");
+        this->addOperation("getMean", &ProfilerService::getMean, this)
+                .doc("Returns the mean execution time in seconds.").arg("Entry", "The name of the entry.");
+        this->addOperation("getP99", &ProfilerService::getP99, this)
+                .doc("Returns the time in seconds within which 99% of the executions finished.").arg("Entry", "The name of the entry.");
+        this->addOperation("setEnabled", &ProfilerService::setEnabled, this)
+                .doc("Starts or stops taking measurements.").arg("Enabled", "True to take measurements.");
+        this->addOperation("isEnabled", &ProfilerService::isEnabled, this)
+                .doc("Returns true if measurements are taken.");
+        this->addOperation("reset", &ProfilerService::reset, this)
+                .doc("Restarts all measurements.");
+        this->addOperation("report", &ProfilerService::report, this)
+                .doc("Returns a table of all measurements.");
+    }
+
+    void ProfilerService::setEnabled(bool tf)
+    {
+        mtc->engine()->getProfiler().setEnabled(tf);
+    }
+
+    bool ProfilerService::isEnabled() const
+    {
+        return mtc->engine()->getProfiler().isEnabled();
+    }
+
+    ExecutionProfiler::Profile ProfilerService::profile(const std::string& entry) const
+    {
+        ExecutionProfiler::Profile p;
+        mtc->engine()->getProfiler().getProfile(entry, p);
+        return p;
+    }
+
+    std::vector<std::string> ProfilerService::getEntries() const
+    {
+        std::vector<std::string> result;
+        std::vector<ExecutionProfiler::Profile> profiles = mtc->engine()->getProfiler().getProfiles();
+        for (unsigned int i = 0; i != profiles.size(); ++i)
+            result.push_back( profiles[i].name );
+        return result;
+    }
+
+    unsigned int ProfilerService::getCount(const std::string& entry) const
+    {
+        return profile(entry).count;
+    }
+
+    Seconds ProfilerService::getLast(const std::string& entry) const
+    {
+        return nsecs_to_Seconds( profile(entry).last );
+    }
+
+    Seconds ProfilerService::getMin(const std::string& entry) const
+    {
+        return nsecs_to_Seconds( profile(entry).min );
+    }
+
+    Seconds ProfilerService::getMax(const std::string& entry) const
+    {
+        return nsecs_to_Seconds( profile(entry).max );
+    }
+
+    Seconds ProfilerService::getMean(const std::string& entry) const
+    {
+        return nsecs_to_Seconds( profile(entry).mean );
+    }
+
+    Seconds ProfilerService::getP99(const std::string& entry) const
+    {
+        return nsecs_to_Seconds( profile(entry).p99 );
+    }
+
+    void ProfilerService::reset()
+    {
+        mtc->engine()->getProfiler().reset();
+    }
+
+    std::string ProfilerService::report() const
+    {
+        std::vector<ExecutionProfiler::Profile> profiles = mtc->engine()->getProfiler().getProfiles();
+        std::ostringstream os;
+        os << std::left << std::setw(32) << "entry" << std::right
+           << std::setw(10) << "count" << std::setw(12) << "last[us]" << std::setw(12) << "min[us]"
+           << std::setw(12) << "mean[us]" << std::setw(12) << "p99[us]" << std::setw(12) << "max[us]" << std::endl;
+        for (unsigned int i = 0; i != profiles.size(); ++i) {
+            const ExecutionProfiler::Profile& p = profiles[i];
+            os << std::left << std::setw(32) << p.name << std::right
+               << std::setw(10) << p.count << std::setw(12) << p.last / 1000 << std::setw(12) << p.min / 1000
+               << std::setw(12) << p.mean / 1000 << std::setw(12) << p.p99 / 1000 << std::setw(12) << p.max / 1000 << std::endl;
+        }
+        return os.str();
+    }
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 03:19:30 UTC 2026  ProfilerService.hpp
+
+                        ProfilerService.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_PROFILER_SERVICE_HPP
+#define ORO_PROFILER_SERVICE_HPP
+
+#include "../Service.hpp"
+#include "ExecutionProfiler.hpp"
+#include <string>
+#include <vector>
+
+namespace RTT
+{ namespace internal {
+
+    /**
+     * Service which reports the execution times measured by the
+     * ExecutionProfiler of the engine of a TaskContext. All times
+     * are in seconds. Every TaskContext has this service; a child
+     * TaskContext reports the engine of its parent.
+     */
+    class RTT_API ProfilerService
+        : public Service
+    {
+    public:
+        typedef boost::shared_ptr<ProfilerService> shared_ptr;
+
+        /**
+         * Creates a ProfilerService object and registers
+         * the service to \a parent.
+         */
+        static shared_ptr Create(TaskContext* parent);
+
+        /**
+         * Creates a ProfilerService object.
+         * You need to add the service to \a parent yourself,
+         * or use Create().
+         */
+        ProfilerService(TaskContext* parent);
+
+        /**
+         * Starts or stops taking measurements.
+         */
+        void setEnabled(bool tf);
+
+        bool isEnabled() const;
+
+        /**
+         * Returns the names of the measured entries.
+         */
+        std::vector<std::string> getEntries() const;
+
+        /**
+         * Returns the number of executions of \a entry.
+         */
+        unsigned int getCount(const std::string& entry) const;
+
+        Seconds getLast(const std::string& entry) const;
+
+        Seconds getMin(const std::string& entry) const;
+
+        Seconds getMax(const std::string& entry) const;
+
+        Seconds getMean(const std::string& entry) const;
+
+        /**
+         * Returns the time within which 99% of the executions of \a entry finished.
+         */
+        Seconds getP99(const std::string& entry) const;
+
+        /**
+         * Restarts all measurements.
+         */
+        void reset();
+
+        /**
+         * Returns a table of all measurements, one line per entry.
+         */
+        std::string report() const;
+
+    private:
+        ExecutionProfiler::Profile profile(const std::string& entry) const;
+
+        TaskContext* mtc;
+    };
+}}
+
+#endif
@@ -0,0 +1,431 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 04:43:22 UTC 2026  SegmentedMWSRQueue.hpp
+
+                        SegmentedMWSRQueue.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_CORELIB_SEGMENTED_MWSR_QUEUE_HPP
+#define ORO_CORELIB_SEGMENTED_MWSR_QUEUE_HPP
+
+#include "../os/CAS.hpp"
+#include "../os/Atomic.hpp"
+#include "../os/oro_malloc.h"
+#include <new>
+
+namespace RTT
+{
+    namespace internal
+    {
+        /**
+         * Create an unbounded, non-blocking Multi-Writer Single-Reader FIFO for storing
+         * a pointer \a T by value. Any number of writer threads
+         * may access the queue concurrently, but only one thread may read it.
+         *
+         * The elements are stored in segments of a fixed size, which form a
+         * linked list. The segments behind the one the writers write to are
+         * empty and used when that one is full. The reader links each segment
+         * it emptied behind the last one again, such that the writers only
+         * allocate a segment, with oro_rt_malloc(), when a burst exceeds all
+         * segments. This is real-time safe when TLSF is enabled. Segments are
+         * never freed before the queue is destroyed, such that the queue keeps
+         * the size required by the largest burst it saw.
+         *
+         * @warning You can not store null pointers.
+         * @param T The pointer type to be stored in the Queue.
+         * Example : SegmentedMWSRQueue< A* > is a queue of pointers to A.
+         * @ingroup CoreLibBuffers
+         */
+        template<class T>
+        class SegmentedMWSRQueue
+        {
+            struct Segment
+            {
+                /**
+                 * The next segment of the queue.
+                 */
+                Segment* volatile next;
+                /**
+                 * Links this segment in a list of segments which are
+                 * waiting to be reused.
+                 */
+                Segment* volatile link;
+                /**
+                 * Links all segments of this queue, for destruction.
+                 */
+                Segment* chain;
+                /**
+                 * The next slot a writer may claim. Equals the segment size
+                 * when this segment is full.
+                 */
+                volatile int windex;
+                /**
+                 * The number of writers which are accessing this segment.
+                 * The reader only reuses an emptied segment once this is zero.
+                 */
+                os::AtomicInt users;
+                /**
+                 * The elements, null if not yet written.
+                 */
+                T volatile* slots;
+            };
+
+            const int msegsize;
+
+            /**
+             * The segment the reader reads from and its read index.
+             * Only accessed by the reader.
+             */
+            Segment* mhead;
+            int mrindex;
+
+            /**
+             * The segment the writers write to.
+             */
+            Segment* volatile mtail;
+
+            /**
+             * A segment at or before the end of the list, from which
+             * the reader looks for the end. Only accessed by the reader.
+             */
+            Segment* mlast;
+
+            /**
+             * All segments of this queue.
+             */
+            Segment* volatile mchain;
+
+            /**
+             * The segments a writer allocated but did not need, because
+             * another writer appended a segment first.
+             */
+            Segment* volatile mreturned;
+
+            /**
+             * The segments the reader emptied, but which may still be
+             * accessed by a writer. Only accessed by the reader.
+             */
+            Segment* mretired;
+
+            os::AtomicInt mcount;
+            os::AtomicInt msegments;
+            os::AtomicInt mallocated;
+            volatile int mhwm;
+
+            Segment* newSegment()
+            {
+                void* p = oro_rt_malloc( sizeof(Segment) + msegsize * sizeof(T) );
+                if (p == 0)
+                    return 0;
+                Segment* s = new (p) Segment();
+                s->slots = reinterpret_cast<T volatile*>( s + 1 );
+                reset(s);
+                Segment* old;
+                do {
+                    old = mchain;
+                    s->chain = old;
+                } while ( !os::CAS(&mchain, old, s) );
+                msegments.inc();
+                return s;
+            }
+
+            void reset(Segment* s)
+            {
+                s->next = 0;
+                s->link = 0;
+                s->windex = 0;
+                for (int i = 0; i != msegsize; ++i)
+                    s->slots[i] = 0;
+            }
+
+            /**
+             * Called by the reader to link an empty segment behind the last one.
+             */
+            void append(Segment* s)
+            {
+                Segment* l = mlast;
+                while ( true ) {
+                    Segment* n = l->next;
+                    if ( n )
+                        l = n;
+                    else if ( os::CAS(&l->next, (Segment*)0, s) )
+                        break;
+                }
+                mlast = s;
+            }
+
+            /**
+             * Called by the reader to reuse the segments it emptied.
+             */
+            void recycle()
+            {
+                Segment* r = mreturned;
+                while ( r && !os::CAS(&mreturned, r, (Segment*)0) )
+                    r = mreturned;
+                while (r) {
+                    Segment* n = r->link;
+                    r->link = 0;
+                    append(r);
+                    r = n;
+                }
+                // A writer which still holds an emptied segment must find
+                // out that it is no longer the tail before it is reused.
+                Segment** p = &mretired;
+                while (*p) {
+                    Segment* s = *p;
+                    if ( s->users.read() == 0 ) {
+                        *p = s->link;
+                        reset(s);
+                        append(s);
+                    } else
+                        p = const_cast<Segment**>( &s->link );
+                }
+            }
+
+            // non-copyable !
+            SegmentedMWSRQueue(const SegmentedMWSRQueue<T>&);
+        public:
+            typedef unsigned int size_type;
+
+            /**
+             * Create a SegmentedMWSRQueue.
+             * @param segment_size The number of elements in a segment, should be 1 or greater.
+             * @param spare_segments The number of segments which are allocated
+             * in advance, in addition to the first one.
+             */
+            SegmentedMWSRQueue(unsigned int segment_size, unsigned int spare_segments = 1)
+                : msegsize(segment_size > 0 ? segment_size : 1),
+                  mhead(0), mrindex(0), mtail(0), mlast(0), mchain(0), mreturned(0),
+                  mretired(0), mcount(0), msegments(0), mallocated(0), mhwm(0)
+            {
+                mhead = newSegment();
+                if (mhead == 0)
+                    throw std::bad_alloc();
+                mtail = mlast = mhead;
+                for (unsigned int i = 0; i != spare_segments; ++i) {
+                    Segment* s = newSegment();
+                    if (s == 0)
+                        throw std::bad_alloc();
+                    append(s);
+                }
+            }
+
+            ~SegmentedMWSRQueue()
+            {
+                Segment* s = mchain;
+                while (s) {
+                    Segment* n = s->chain;
+                    s->~Segment();
+                    oro_rt_free(s);
+                    s = n;
+                }
+            }
+
+            /**
+             * Inspect if the Queue is full. It is only full when
+             * a new segment could not be allocated.
+             * @return false.
+             */
+            bool isFull() const
+            {
+                return false;
+            }
+
+            /**
+             * Inspect if the Queue is empty.
+             * @return true if empty, false otherwise.
+             */
+            bool isEmpty() const
+            {
+                return mcount.read() <= 0;
+            }
+
+            /**
+             * Return the number of items this queue can contain
+             * without allocating new segments.
+             */
+            size_type capacity() const
+            {
+                return msegments.read() * msegsize;
+            }
+
+            /**
+             * Return the number of elements in the queue.
+             */
+            size_type size() const
+            {
+                int c = mcount.read();
+                return c > 0 ? c : 0;
+            }
+
+            /**
+             * Return the number of elements in a segment.
+             */
+            size_type segmentSize() const
+            {
+                return msegsize;
+            }
+
+            /**
+             * Return the number of segments allocated by a writer
+             * because all segments were full.
+             */
+            size_type allocatedSegments() const
+            {
+                return mallocated.read();
+            }
+
+            /**
+             * Return the largest number of elements this queue held
+             * since its creation or the last resetHighWatermark().
+             */
+            size_type highWatermark() const
+            {
+                return mhwm;
+            }
+
+            void resetHighWatermark()
+            {
+                mhwm = 0;
+            }
+
+            /**
+             * Enqueue an item.
+             * @param value The value to enqueue.
+             * @return false if no segment could be allocated, true if queued.
+             */
+            bool enqueue(const T& value)
+            {
+                if (value == 0)
+                    return false;
+                // Counted before the slot is written, such that the
+                // reader never sees a negative count.
+                mcount.inc();
+                while (true) {
+                    Segment* t = mtail;
+                    t->users.inc();
+                    if ( t != mtail ) {
+                        t->users.dec();
+                        continue;
+                    }
+                    int i;
+                    do {
+                        i = t->windex;
+                    } while ( i < msegsize && !os::CAS(&t->windex, i, i + 1) );
+                    if ( i < msegsize ) {
+                        t->slots[i] = value;
+                        t->users.dec();
+                        int c = mcount.read();
+                        int h = mhwm;
+                        while ( c > h && !os::CAS(&mhwm, h, c) )
+                            h = mhwm;
+                        return true;
+                    }
+                    // t is full, move the tail to the next segment,
+                    // which we allocate if there is none.
+                    if ( t->next == 0 ) {
+                        Segment* n = newSegment();
+                        if ( n == 0 ) {
+                            t->users.dec();
+                            mcount.dec();
+                            return false;
+                        }
+                        mallocated.inc();
+                        if ( !os::CAS(&t->next, (Segment*)0, n) ) {
+                            Segment* old;
+                            do {
+                                old = mreturned;
+                                n->link = old;
+                            } while ( !os::CAS(&mreturned, old, n) );
+                        }
+                    }
+                    os::CAS(&mtail, t, t->next);
+                    t->users.dec();
+                }
+            }
+
+            /**
+             * Dequeue an item.
+             * @param value Stores the dequeued value. It is unchanged when
+             * dequeue returns false and contains the dequeued value
+             * when it returns true.
+             * @return false if queue is empty, true if result was written.
+             */
+            bool dequeue(T& result)
+            {
+                while (true) {
+                    if ( mrindex < msegsize ) {
+                        T value = mhead->slots[mrindex];
+                        if ( value == 0 ) {
+                            // empty, or a writer is still writing this slot.
+                            if ( mretired || mreturned )
+                                recycle();
+                            return false;
+                        }
+                        ++mrindex;
+                        mcount.dec();
+                        result = value;
+                        return true;
+                    }
+                    Segment* n = mhead->next;
+                    if ( n == 0 )
+                        return false;
+                    // Make sure the emptied segment is no longer the tail.
+                    os::CAS(&mtail, mhead, n);
+                    if ( mlast == mhead )
+                        mlast = n;
+                    mhead->link = mretired;
+                    mretired = mhead;
+                    mhead = n;
+                    mrindex = 0;
+                    recycle();
+                }
+            }
+
+            /**
+             * Clear all contents of the Queue and thus make it empty.
+             * May only be called by the reader.
+             */
+            void clear()
+            {
+                T value;
+                while ( dequeue(value) ) {}
+            }
+        };
+    }
+}
+
+#endif
@@ -196,6 +196,68 @@ namespace RTT
                 return true;
             }
 
+            /**
+             * Allocates up to \a n elements with a single CAS on the free list.
+             * @param items receives the pointers to the allocated elements.
+             * @param n the maximum number of elements to allocate.
+             * @return the number of elements written to \a items, which
+             * is less than \a n if the pool runs out of elements.
+             */
+            size_type allocate(value_t** items, size_type n)
+            {
+                volatile Pointer_t oldval;
+                volatile Pointer_t newval;
+                size_type count;
+                do
+                {
+                    oldval.value = head.next.value;
+                    unsigned short index = oldval.ptr.index;
+                    count = 0;
+                    // The chain may be modified concurrently while we walk it.
+                    // The CAS below fails in that case, since any allocate()
+                    // or deallocate() changes the tag of the head.
+                    while (count != n && index < pool_capacity)
+                    {
+                        items[count++] = &pool[index].value;
+                        index = pool[index].next.ptr.index;
+                    }
+                    if (count == 0)
+                        return 0;
+                    newval.ptr.index = index;
+                    newval.ptr.tag = oldval.ptr.tag + 1;
+                } while (!os::CAS(&head.next.value, oldval.value, newval.value));
+                return count;
+            }
+
+            /**
+             * Gives \a n elements back to the pool with a single CAS on the free list.
+             * @param items the elements to deallocate, none of them may be null.
+             * @param n the number of elements in \a items.
+             */
+            bool deallocate(value_t* const* items, size_type n)
+            {
+                if (n == 0)
+                    return false;
+                // chain the items, the last one will point to the current head.
+                for (size_type i = 0; i + 1 < n; ++i)
+                {
+                    assert(items[i] >= (T*) &pool[0] && items[i] <= (T*) &pool[pool_capacity]);
+                    reinterpret_cast<Item*>(items[i])->next.ptr.index = reinterpret_cast<Item*>(items[i + 1]) - pool;
+                }
+                Item* first = reinterpret_cast<Item*> (items[0]);
+                Item* last = reinterpret_cast<Item*> (items[n - 1]);
+                volatile Pointer_t oldval;
+                Pointer_t head_next;
+                do
+                {
+                    oldval.value = head.next.value;
+                    last->next.value = oldval.value;
+                    head_next.ptr.index = (first - pool);
+                    head_next.ptr.tag = oldval.ptr.tag + 1;
+                } while (!os::CAS(&head.next.value, oldval.value, head_next.value));
+                return true;
+            }
+
             /**
              * Return the number of elements that are available to be allocated.
              * This function is not thread-safe and should not be used when concurrent
@@ -8,6 +8,7 @@ namespace RTT {
         class ConnectionBase;
         class ConnectionManager;
         class DataSourceCommand;
+        class ExecutionProfiler;
         class GlobalEngine;
         class OffsetDataSource;
         class OperationCallerC;
@@ -93,6 +94,8 @@ namespace RTT {
         template<class T>
         class Queue;
         template<class T>
+        class SegmentedMWSRQueue;
+        template<class T>
         struct AStore;
         template<class T>
         struct DSRStore;
@@ -0,0 +1,117 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:39:22 UTC 2026  CpuSet.cpp
+
+                        CpuSet.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "CpuSet.hpp"
+
+using namespace RTT::os;
+
+CpuSet::CpuSet()
+{
+    for (unsigned w = 0; w != Words; ++w)
+        mbits[w] = 0;
+}
+
+CpuSet::CpuSet(unsigned mask)
+{
+    for (unsigned w = 0; w != Words; ++w)
+        mbits[w] = 0;
+    for (unsigned i = 0; i != 8 * sizeof(mask); ++i)
+        if ( mask & (1u << i) )
+            set(i);
+}
+
+void CpuSet::set(unsigned cpu)
+{
+    if ( cpu < MaxCpus )
+        mbits[cpu / BitsPerWord] |= 1ul << (cpu % BitsPerWord);
+}
+
+void CpuSet::clear(unsigned cpu)
+{
+    if ( cpu < MaxCpus )
+        mbits[cpu / BitsPerWord] &= ~(1ul << (cpu % BitsPerWord));
+}
+
+bool CpuSet::isSet(unsigned cpu) const
+{
+    return cpu < MaxCpus && (mbits[cpu / BitsPerWord] & (1ul << (cpu % BitsPerWord))) != 0;
+}
+
+unsigned CpuSet::count() const
+{
+    unsigned n = 0;
+    for (unsigned cpu = 0; cpu != MaxCpus; ++cpu)
+        if ( isSet(cpu) )
+            ++n;
+    return n;
+}
+
+bool CpuSet::empty() const
+{
+    for (unsigned w = 0; w != Words; ++w)
+        if ( mbits[w] )
+            return false;
+    return true;
+}
+
+bool CpuSet::fitsMask() const
+{
+    for (unsigned cpu = 8 * sizeof(unsigned); cpu < MaxCpus; ++cpu)
+        if ( isSet(cpu) )
+            return false;
+    return true;
+}
+
+unsigned CpuSet::toMask() const
+{
+    unsigned mask = 0;
+    for (unsigned i = 0; i != 8 * sizeof(mask); ++i)
+        if ( isSet(i) )
+            mask |= 1u << i;
+    return mask;
+}
+
+bool CpuSet::operator==(const CpuSet& other) const
+{
+    for (unsigned w = 0; w != Words; ++w)
+        if ( mbits[w] != other.mbits[w] )
+            return false;
+    return true;
+}
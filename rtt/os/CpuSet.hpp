@@ -0,0 +1,116 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:39:22 UTC 2026  CpuSet.hpp
+
+                        CpuSet.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_OS_CPUSET_HPP
+#define ORO_OS_CPUSET_HPP
+
+#include "../rtt-config.h"
+
+namespace RTT
+{
+    namespace os
+    {
+        /**
+         * A set of CPUs a thread may run on. Unlike the \a unsigned
+         * cpu affinity mask, it can hold CPUs above 31.
+         * @see Thread::setCpuSet()
+         */
+        class RTT_API CpuSet
+        {
+        public:
+            /** The number of CPUs a set can hold, which is the size of a Linux cpu_set_t. */
+            enum { MaxCpus = 1024 };
+
+            /**
+             * Creates an empty set.
+             */
+            CpuSet();
+
+            /**
+             * Creates the set of the cpu affinity mask \a mask,
+             * in which bit \a i selects CPU \a i.
+             */
+            explicit CpuSet(unsigned mask);
+
+            /**
+             * Adds \a cpu to the set. CPUs beyond MaxCpus are ignored.
+             */
+            void set(unsigned cpu);
+
+            /**
+             * Removes \a cpu from the set.
+             */
+            void clear(unsigned cpu);
+
+            /**
+             * Returns true if \a cpu is in the set.
+             */
+            bool isSet(unsigned cpu) const;
+
+            /**
+             * The number of CPUs in the set.
+             */
+            unsigned count() const;
+
+            bool empty() const;
+
+            /**
+             * Returns true if the set only holds CPUs which fit in
+             * an \a unsigned cpu affinity mask.
+             */
+            bool fitsMask() const;
+
+            /**
+             * Returns the cpu affinity mask of the CPUs which fit in an \a unsigned.
+             */
+            unsigned toMask() const;
+
+            bool operator==(const CpuSet& other) const;
+
+            bool operator!=(const CpuSet& other) const { return !(*this == other); }
+
+        private:
+            enum { BitsPerWord = 8 * sizeof(unsigned long), Words = MaxCpus / BitsPerWord };
+            unsigned long mbits[Words];
+        };
+    }
+}
+
+#endif
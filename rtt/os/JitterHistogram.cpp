@@ -0,0 +1,144 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:27:10 UTC 2026  JitterHistogram.cpp
+
+                        JitterHistogram.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "JitterHistogram.hpp"
+
+using namespace RTT;
+using namespace RTT::os;
+
+JitterStatistics::JitterStatistics()
+    : samples(0), overruns(0), min(0), mean(0), max(0), p99(0)
+{
+}
+
+JitterHistogram::JitterHistogram()
+    : mreset(1)
+{
+    checkReset();
+}
+
+int JitterHistogram::bucket(nsecs value)
+{
+    if ( value < SubBuckets )
+        return int(value);
+    // the position of the highest bit selects the power of two,
+    // the three bits below it the bucket within that power.
+    int bits = 0;
+    for (nsecs v = value; v >= 2 * SubBuckets; v >>= 1)
+        ++bits;
+    int b = (bits + 1) * SubBuckets + int(value >> bits) - SubBuckets;
+    return b < Buckets ? b : Buckets - 1;
+}
+
+nsecs JitterHistogram::upperBound(int bucket)
+{
+    if ( bucket < SubBuckets )
+        return bucket;
+    int bits = bucket / SubBuckets - 1;
+    nsecs lower = nsecs(bucket % SubBuckets + SubBuckets) << bits;
+    return lower + (nsecs(1) << bits) - 1;
+}
+
+void JitterHistogram::checkReset()
+{
+    if ( mreset.read() == 0 )
+        return;
+    for (int i = 0; i != Buckets; ++i)
+        mbuckets[i] = 0;
+    msamples = 0;
+    moverruns = 0;
+    mmin = 0;
+    mmax = 0;
+    msum = 0;
+    mreset.set(0);
+}
+
+void JitterHistogram::record(nsecs jitter)
+{
+    checkReset();
+    if ( jitter < 0 )
+        jitter = -jitter;
+    if ( msamples == 0 || jitter < mmin )
+        mmin = jitter;
+    if ( jitter > mmax )
+        mmax = jitter;
+    msum = msum + jitter;
+    mbuckets[ bucket(jitter) ] = mbuckets[ bucket(jitter) ] + 1;
+    msamples = msamples + 1;
+}
+
+void JitterHistogram::overrun()
+{
+    checkReset();
+    moverruns = moverruns + 1;
+}
+
+void JitterHistogram::reset()
+{
+    mreset.set(1);
+}
+
+JitterStatistics JitterHistogram::getStatistics() const
+{
+    JitterStatistics stats;
+    if ( mreset.read() != 0 )
+        return stats;
+    stats.overruns = moverruns;
+    stats.samples = msamples;
+    if ( stats.samples == 0 )
+        return stats;
+    stats.min = mmin;
+    stats.max = mmax;
+    stats.mean = msum / nsecs(stats.samples);
+
+    // walk the buckets up to the one holding the 99th percentile.
+    unsigned long total = 0;
+    for (int i = 0; i != Buckets; ++i)
+        total += mbuckets[i];
+    unsigned long rank = total - total / 100, count = 0;
+    for (int i = 0; i != Buckets && total != 0; ++i) {
+        count += mbuckets[i];
+        if ( count >= rank ) {
+            stats.p99 = upperBound(i) < stats.max ? upperBound(i) : stats.max;
+            break;
+        }
+    }
+    return stats;
+}
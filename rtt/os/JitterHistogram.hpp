@@ -0,0 +1,131 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:27:10 UTC 2026  JitterHistogram.hpp
+
+                        JitterHistogram.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_OS_JITTER_HISTOGRAM_HPP
+#define ORO_OS_JITTER_HISTOGRAM_HPP
+
+#include "Time.hpp"
+#include "Atomic.hpp"
+#include "../rtt-config.h"
+
+namespace RTT
+{
+    namespace os
+    {
+        /**
+         * A summary of the wake-up jitter of a periodic thread.
+         * The jitter of one period is the time between the scheduled start
+         * of that period and the moment the thread woke up for it, measured
+         * with the clock that times the periods of the thread.
+         * All times are in nanoseconds and zero if no period was measured.
+         */
+        struct RTT_API JitterStatistics
+        {
+            JitterStatistics();
+
+            /** The number of periods measured. */
+            unsigned long samples;
+            /** The number of periods in which the thread overran. */
+            unsigned long overruns;
+            nsecs min;
+            nsecs mean;
+            nsecs max;
+            /** 99% of the periods had a jitter less than or equal to this value. */
+            nsecs p99;
+        };
+
+        /**
+         * A histogram of jitter values, which is filled in by one thread and
+         * may be read or reset by any other thread without locking.
+         *
+         * The buckets are spaced logarithmically with eight buckets per
+         * power of two, such that percentiles are reported with a
+         * resolution better than 12.5%.
+         */
+        class RTT_API JitterHistogram
+        {
+        public:
+            JitterHistogram();
+
+            /**
+             * Records the jitter of one period.
+             * May only be called by the thread which owns this histogram.
+             */
+            void record(nsecs jitter);
+
+            /**
+             * Records an overrun.
+             * May only be called by the thread which owns this histogram.
+             */
+            void overrun();
+
+            /**
+             * Clears the histogram. It is emptied by the owning thread
+             * when it records its next value, and reported as empty
+             * until then.
+             */
+            void reset();
+
+            /**
+             * Returns a summary of the recorded values. The result may be
+             * slightly inconsistent while the owning thread records a value.
+             */
+            JitterStatistics getStatistics() const;
+
+        private:
+            enum { SubBuckets = 8, Buckets = 320 };
+
+            static int bucket(nsecs value);
+            static nsecs upperBound(int bucket);
+
+            void checkReset();
+
+            volatile unsigned long mbuckets[Buckets];
+            volatile unsigned long msamples;
+            volatile unsigned long moverruns;
+            volatile nsecs mmin;
+            volatile nsecs mmax;
+            volatile nsecs msum;
+            AtomicInt mreset;
+        };
+    }
+}
+
+#endif
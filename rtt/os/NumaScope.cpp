@@ -0,0 +1,62 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:39:22 UTC 2026  NumaScope.cpp
+
+                        NumaScope.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#include "NumaScope.hpp"
+#include "fosi_internal_interface.hpp"
+
+using namespace RTT::os;
+
+NumaScope::NumaScope(int node)
+    : previous(-1), changed(false)
+{
+    if ( node < 0 )
+        return;
+    previous = rtos_numa_get_preferred_node();
+    // leave policies alone which we could not restore.
+    if ( previous < -1 || previous == node )
+        return;
+    changed = rtos_numa_set_preferred_node(node) == 0;
+}
+
+NumaScope::~NumaScope()
+{
+    if ( changed )
+        rtos_numa_set_preferred_node(previous);
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 02:39:22 UTC 2026  NumaScope.hpp
+
+                        NumaScope.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+
+#ifndef ORO_OS_NUMA_SCOPE_HPP
+#define ORO_OS_NUMA_SCOPE_HPP
+
+#include "../rtt-config.h"
+
+namespace RTT
+{
+    namespace os
+    {
+        /**
+         * Lets the calling thread allocate new memory pages on a
+         * given NUMA node for as long as this object exists, and
+         * restores its previous memory policy when it is destroyed.
+         *
+         * Only pages which are touched for the first time in the scope are
+         * placed on the node, so it is effective for data structures which
+         * initialize their storage when they are constructed, like
+         * the lock-free buffers and data objects.
+         */
+        class RTT_API NumaScope
+        {
+        public:
+            /**
+             * @param node The NUMA node to allocate on. If it is -1, or if
+             * the OS does not support NUMA, the memory policy is not changed.
+             */
+            explicit NumaScope(int node);
+
+            ~NumaScope();
+
+        private:
+            NumaScope(const NumaScope&);
+            NumaScope& operator=(const NumaScope&);
+
+            int previous;
+            bool changed;
+        };
+    }
+}
+
+#endif
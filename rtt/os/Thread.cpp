@@ -68,6 +68,10 @@ namespace RTT {
 
         void Thread::setStackSize(unsigned int ssize) { default_stack_size = ssize; }
 
+        bool Thread::setThreadCache(unsigned int size) { return rtos_task_set_thread_cache(size, default_stack_size) == 0; }
+
+        unsigned int Thread::getCachedThreadCount() { return rtos_task_get_cached_threads(); }
+
         void Thread::setLockTimeoutNoPeriod(double timeout_in_s) { lock_timeout_no_period_in_s = timeout_in_s; }
        
         void Thread::setLockTimeoutPeriodFactor(double factor) { lock_timeout_period_factor = factor; }
@@ -126,6 +130,9 @@ namespace RTT {
                             if (task->period != 0) // periodic
                             {
                                 MutexLock lock(task->breaker);
+                                // the start of the current step, for targets which
+                                // do not measure the start of the period.
+                                NANO_TIME release = rtos_get_time_ns();
                                 while(task->running && !task->prepareForExit )
                                 {
                                     TRY
@@ -139,6 +146,12 @@ namespace RTT {
                                         SCOPE_OFF
                                         throw;
                                     )
+                                    // measured from the start of the period, with the clock of the task.
+                                    NANO_TIME elapsed = rtos_task_get_period_elapsed(task->getTask());
+                                    if ( elapsed < 0 )
+                                        elapsed = rtos_get_time_ns() - release;
+                                    if ( elapsed > (task->dl_deadline ? task->dl_deadline : cur_period) )
+                                        task->dl_misses.inc();
 
                                     // Check changes in period
                                     if ( cur_period != task->period) {
@@ -154,11 +167,20 @@ namespace RTT {
                                         rtos_task_set_scheduler(task->getTask(), task->msched_type);
                                         cur_sched = task->msched_type;
                                     }
+                                    // Check changes in the deadline parameters
+                                    task->applyDeadline();
                                     // rtos_task_wait_period will return immediately if
                                     // the task is not periodic (ie period == 0)
                                     // return non-zero to indicate overrun.
-                                    if (rtos_task_wait_period(task->getTask()) != 0)
+                                    int overrun = rtos_task_wait_period(task->getTask());
+                                    release = rtos_get_time_ns();
+                                    // how late we woke up after the start of this period.
+                                    NANO_TIME latency = rtos_task_get_wakeup_latency(task->getTask());
+                                    if (overrun == 0 && latency >= 0)
+                                        task->jitter.record( latency );
+                                    if (overrun != 0)
                                     {
+                                        task->jitter.overrun();
                                         ++overruns;
                                         if (overruns == task->maxOverRun)
                                             break; // break while(task->running)
@@ -238,7 +260,11 @@ namespace RTT {
                     msched_type(scheduler), active(false), prepareForExit(false),
                     inloop(false),running(false),
                     maxOverRun(OROSEM_OS_PERIODIC_THREADS_MAX_OVERRUN),
-                    period(Seconds_to_nsecs(periods)) // Do not call setPeriod(), since the semaphores are not yet used !
+                    period(Seconds_to_nsecs(periods)), // Do not call setPeriod(), since the semaphores are not yet used !
+                    numa_node(-1),
+                    dl_runtime(0), dl_deadline(0),
+                    dl_cur_runtime(0), dl_cur_deadline(0), dl_cur_period(0),
+                    dl_scheduled(false), dl_misses(0)
 #ifdef OROPKG_OS_THREAD_SCOPE
         ,d(NULL)
 #endif
@@ -479,6 +505,9 @@ namespace RTT {
             log(Info) << "Setting scheduler type for Thread '"
                       << rtos_task_get_name(&rtos_task) << "' to "
                       << sched_type << endlog();
+            // leave the deadline scheduler.
+            dl_runtime = 0;
+            dl_scheduled = false;
             rtos_task_set_scheduler(&rtos_task, sched_type); // this may be a no-op, in that case, configure() will pick the change up.
             msched_type = sched_type;
             rtos_sem_signal(&sem);
@@ -502,11 +531,35 @@ namespace RTT {
             rtos_task_set_period(&rtos_task, period);
 
             // reconfigure scheduler.
-            if (msched_type != rtos_task_get_scheduler(&rtos_task))
+            if (!dl_scheduled && msched_type != rtos_task_get_scheduler(&rtos_task))
             {
                 rtos_task_set_scheduler(&rtos_task, msched_type);
                 msched_type = rtos_task_get_scheduler(&rtos_task);
             }
+            applyDeadline();
+
+            // the memory policy can only be set by the thread itself.
+            if (numa_node != rtos_numa_get_preferred_node())
+                rtos_numa_set_preferred_node(numa_node);
+        }
+
+        void Thread::applyDeadline()
+        {
+            NANO_TIME runtime = dl_runtime, deadline = dl_deadline ? dl_deadline : period;
+            if ( runtime == dl_cur_runtime && deadline == dl_cur_deadline && period == dl_cur_period )
+                return;
+            dl_cur_runtime = runtime;
+            dl_cur_deadline = deadline;
+            dl_cur_period = period;
+            if ( runtime != 0 && period != 0 && runtime <= deadline && deadline <= period ) {
+                dl_scheduled = rtos_task_set_deadline(&rtos_task, runtime, deadline, period) == 0;
+                if ( !dl_scheduled )
+                    log(Warning) << "Thread " << getName() << " keeps its scheduler: the deadline parameters were refused." << endlog();
+            } else if ( dl_scheduled ) {
+                // not periodic anymore or setDeadline(0): back to the normal scheduler.
+                rtos_task_set_scheduler(&rtos_task, msched_type);
+                dl_scheduled = false;
+            }
         }
 
         void Thread::step()
@@ -608,6 +661,81 @@ namespace RTT {
             return rtos_task_get_cpu_affinity(&rtos_task);
         }
 
+        bool Thread::setCpuSet(const CpuSet& cpus)
+        {
+            return rtos_task_set_cpu_set(&rtos_task, cpus) == 0;
+        }
+
+        CpuSet Thread::getCpuSet() const
+        {
+            CpuSet cpus;
+            rtos_task_get_cpu_set(&rtos_task, cpus);
+            return cpus;
+        }
+
+        bool Thread::setNumaNode(int node)
+        {
+            CpuSet cpus;
+            if ( node >= 0 && rtos_numa_node_cpus(node, cpus) != 0 ) {
+                log(Error) << "Can not place thread " << getName() << " on NUMA node " << node << ": no such node." << endlog();
+                return false;
+            }
+            // an empty set allows all CPUs again.
+            if ( !setCpuSet(cpus) )
+                return false;
+            numa_node = node;
+            rtos_sem_signal(&sem); // configure() will pick the memory policy up.
+            return true;
+        }
+
+        int Thread::getNumaNode() const
+        {
+            return numa_node;
+        }
+
+        bool Thread::setDeadline(Seconds runtime, Seconds deadline)
+        {
+            NANO_TIME ns_runtime = Seconds_to_nsecs(runtime), ns_deadline = Seconds_to_nsecs(deadline);
+            if ( ns_runtime < 0 || ns_deadline < 0 || (period != 0 && ns_deadline > period)
+                 || ns_runtime > (ns_deadline ? ns_deadline : (period ? period : ns_runtime)) ) {
+                log(Error) << "Invalid deadline parameters for thread " << getName() << ": runtime " << runtime
+                           << ", deadline " << deadline << ", period " << getPeriod() << endlog();
+                return false;
+            }
+            dl_runtime = ns_runtime;
+            dl_deadline = ns_deadline;
+            // a running thread applies them after its next step(),
+            // an inactive one when it is woken up.
+            if ( !active )
+                rtos_sem_signal(&sem);
+            return true;
+        }
+
+        Seconds Thread::getDeadlineRuntime() const
+        {
+            return nsecs_to_Seconds(dl_runtime);
+        }
+
+        Seconds Thread::getDeadline() const
+        {
+            return nsecs_to_Seconds(dl_deadline ? dl_deadline : period);
+        }
+
+        bool Thread::isDeadlineScheduled() const
+        {
+            return dl_scheduled;
+        }
+
+        unsigned int Thread::getDeadlineMisses() const
+        {
+            return dl_misses.read();
+        }
+
+        void Thread::resetDeadlineMisses()
+        {
+            dl_misses.set(0);
+        }
+
         unsigned int Thread::getPid() const
         {
         	return rtos_task_get_pid(&rtos_task);
@@ -649,6 +777,16 @@ namespace RTT {
             rtos_task_set_wait_period_policy(&rtos_task, p);  
         }
 
+        JitterStatistics Thread::getJitterStatistics() const
+        {
+            return jitter.getStatistics();
+        }
+
+        void Thread::resetJitterStatistics()
+        {
+            jitter.reset();
+        }
+
     }
 }
 
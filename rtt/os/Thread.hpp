@@ -44,6 +44,7 @@
 
 #include "ThreadInterface.hpp"
 #include "Mutex.hpp"
+#include "Atomic.hpp"
 
 #include <string>
 
@@ -137,6 +138,24 @@ namespace RTT
              */
             static void setStackSize(unsigned int ssize);
 
+            /**
+             * Keeps up to \a size finished threads parked, such that creating
+             * a new Thread hands its work to one of them instead of spawning
+             * a fresh one. Threads are only reused for the stack size set
+             * with setStackSize() at the time of this call, and inherit the
+             * scheduling of the creating thread just like new ones.
+             * Use zero to disable the cache and let the parked threads exit.
+             * @param size the number of parked threads to keep.
+             * @return false if the target does not support a thread cache.
+             */
+            static bool setThreadCache(unsigned int size);
+
+            /**
+             * Returns the number of threads currently parked in the cache
+             * of setThreadCache().
+             */
+            static unsigned int getCachedThreadCount();
+
             /**
              * Sets the lock timeout for a thread which does not have a period
              * The default is 1 second 
@@ -234,6 +253,31 @@ namespace RTT
              */
             virtual unsigned getCpuAffinity() const;
 
+            /**
+             * Set the CPUs this thread may run on, which may include CPUs
+             * above 31. An empty set allows all CPUs.
+             * @return true if the set has been applied
+             */
+            virtual bool setCpuSet(const CpuSet& cpus);
+
+            /**
+             * @return the CPUs this thread may run on.
+             */
+            virtual CpuSet getCpuSet() const;
+
+            /**
+             * Place this thread on NUMA node \a node: it only runs on the
+             * CPUs of that node and allocates new memory pages on it, which
+             * includes the buffers of the connections to the input ports of
+             * the components it runs. The memory policy is applied when the
+             * thread is started or is idle.
+             * @param node The NUMA node, or -1 to allow all CPUs and nodes again.
+             * @return false if \a node does not exist or the thread could not be moved.
+             */
+            virtual bool setNumaNode(int node);
+
+            virtual int getNumaNode() const;
+
             virtual void yield();
 
             virtual void setMaxOverrun(int m);
@@ -242,6 +286,60 @@ namespace RTT
 
             virtual void setWaitPeriodPolicy(int p);
 
+            virtual JitterStatistics getJitterStatistics() const;
+
+            virtual void resetJitterStatistics();
+
+            /**
+             * Let the kernel schedule this periodic thread by its deadline
+             * (SCHED_DEADLINE on Linux) instead of by its priority. Each
+             * period, step() may then use \a runtime seconds of CPU time,
+             * which the kernel reserves and enforces. Since the kernel
+             * refuses threads which would overload the CPUs, more threads
+             * can be placed on the same CPUs safely.
+             *
+             * The parameters are applied by the thread itself, as soon as it is
+             * periodic. If the kernel refuses them, a warning is logged and
+             * the thread keeps its scheduler: see isDeadlineScheduled().
+             * A later setScheduler() leaves the deadline scheduler again.
+             * @param runtime The CPU time per period in seconds, or zero to
+             * return to the scheduler and priority of this thread.
+             * @param deadline The time after the start of each period within which
+             * step() must finish, or zero to use the period.
+             * @return false if \a runtime exceeds \a deadline or if \a deadline exceeds the period.
+             */
+            bool setDeadline(Seconds runtime, Seconds deadline = 0.0);
+
+            /**
+             * Returns the CPU time per period set by setDeadline(), or zero.
+             */
+            Seconds getDeadlineRuntime() const;
+
+            /**
+             * Returns the time after the start of each period within which
+             * step() must finish: the deadline set by setDeadline(), or the period.
+             */
+            Seconds getDeadline() const;
+
+            /**
+             * Returns true if the kernel schedules this thread by its deadline.
+             */
+            bool isDeadlineScheduled() const;
+
+            /**
+             * Returns the number of times step() finished later than
+             * getDeadline() after the start of its period, whether this
+             * thread is scheduled by its deadline or not. The time is
+             * measured with the clock which times the periods, such that
+             * a late wake-up counts as well.
+             */
+            unsigned int getDeadlineMisses() const;
+
+            /**
+             * Sets the number of deadline misses to zero.
+             */
+            void resetDeadlineMisses();
+
         protected:
             /**
              * Exit and destroy the thread
@@ -286,6 +384,12 @@ namespace RTT
              */
             void configure();
 
+            /**
+             * Applies the parameters of setDeadline() when they or the period changed.
+             * Only called by the thread itself.
+             */
+            void applyDeadline();
+
             static unsigned int default_stack_size;
 
             /**
@@ -350,6 +454,36 @@ namespace RTT
              */
             NANO_TIME period;
 
+            /**
+             * The jitter of each period, filled in by the thread itself.
+             */
+            JitterHistogram jitter;
+
+            /**
+             * The NUMA node this thread was placed on, or -1.
+             */
+            int numa_node;
+
+            /**
+             * The parameters of setDeadline(), or zero.
+             */
+            NANO_TIME dl_runtime, dl_deadline;
+
+            /**
+             * The deadline parameters the thread applied last.
+             */
+            NANO_TIME dl_cur_runtime, dl_cur_deadline, dl_cur_period;
+
+            /**
+             * Set by the thread if the kernel accepted the deadline parameters.
+             */
+            bool dl_scheduled;
+
+            /**
+             * The number of steps which missed their deadline.
+             */
+            AtomicInt dl_misses;
+
             /**
              * The timeout, in seconds, for stop()
              */
@@ -55,6 +55,20 @@ ThreadInterface::~ThreadInterface()
     //threads.dec();
 }
 
+int ThreadInterface::getNumaNode() const
+{
+    return -1;
+}
+
+JitterStatistics ThreadInterface::getJitterStatistics() const
+{
+    return JitterStatistics();
+}
+
+void ThreadInterface::resetJitterStatistics()
+{
+}
+
 bool ThreadInterface::isSelf() const
 {
     return rtos_task_is_self( this->getTask() ) == 1;
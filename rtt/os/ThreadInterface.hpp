@@ -42,6 +42,8 @@
 #include "fosi.h"
 #include "threads.hpp"
 #include "Time.hpp"
+#include "JitterHistogram.hpp"
+#include "CpuSet.hpp"
 #include "../rtt-config.h"
 
 namespace RTT
@@ -195,6 +197,12 @@ namespace RTT
              */
             virtual unsigned getCpuAffinity() const = 0;
 
+            /**
+             * @return the NUMA node this thread was placed on,
+             * or -1 if it was not placed on a node.
+             */
+            virtual int getNumaNode() const;
+
             virtual void setMaxOverrun(int m) = 0;
 
             virtual int getMaxOverrun() const = 0;
@@ -205,6 +213,20 @@ namespace RTT
              */
             virtual void setWaitPeriodPolicy(int p) = 0;
 
+            /**
+             * Returns the wake-up jitter and the number of overruns
+             * this periodic thread measured since it was created or since
+             * resetJitterStatistics() was called. Threads which do not
+             * measure their jitter, or run on a target which does not
+             * report rtos_task_get_wakeup_latency(), return all zeros.
+             */
+            virtual JitterStatistics getJitterStatistics() const;
+
+            /**
+             * Restarts the measurement of getJitterStatistics().
+             */
+            virtual void resetJitterStatistics();
+
             /**
              * Yields (put to the back of the scheduler queue) the calling thread.
              */
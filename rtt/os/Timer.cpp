@@ -63,22 +63,16 @@ namespace RTT {
         // This code is executed from mThread's thread
         while (!mdo_quit) {
             Time wake_up_time;
-            TimerId next_timer_id = 0;
 
             // Select next timer.
             {// This scope is for MutexLock.
-                // find wake_up_time
-                // check timers queue.
                 MutexLock locker(m);
                 // We can't use infinite as the OS may internally use time_spec, which can not
                 // represent as much in the future (until 2038) // XXX Year-2038 Bug
-                wake_up_time = 1000000000LL * std::numeric_limits<int32_t>::max();
-                for (TimerIds::iterator it = mtimers.begin(); it != mtimers.end(); ++it) {
-                    if ( it->expires != 0 && it->expires < wake_up_time  ) {
-                        wake_up_time = it->expires;
-                        next_timer_id = it - mtimers.begin();
-                    }
-                }
+                if ( mheap.empty() )
+                    wake_up_time = 1000000000LL * std::numeric_limits<int32_t>::max();
+                else
+                    wake_up_time = mtimers[ mheap.front() ].expires;
             }// MutexLock
 
             // Wait
@@ -91,36 +85,33 @@ namespace RTT {
 
             // Timeout handling
             if (ret == -1) {
-                // a timer expired
-                // expires: reset/reprogram the timer that expired:
+                TimerId next_timer_id;
+                // First: reset/reprogram the timer that expired and notify waiting threads.
                 {
                     MutexLock locker(m);
-                    // detect corner case for resize:
-                    if ( next_timer_id < int(mtimers.size()) ) {
-                        // now clear or reprogram it.
-                        TimerIds::iterator tim = mtimers.begin() + next_timer_id;
-                        if ( tim->period ) {
-                            // periodic timer
-                            // if late by more than 4 periods, skip late updates
-                            int maxDelayInPeriods = 4;
-                            if (now - tim->expires > tim->period*maxDelayInPeriods) {
-                                tim->expires += tim->period*((now - tim->expires) / tim->period);
-                            }
-                            tim->expires += tim->period;
-                        } else {
-                            // aperiodic timer
-                            tim->expires = 0;
+                    now = rtos_get_time_ns();
+                    // The timer we waited for may have been killed or re-armed in the meantime.
+                    if ( mheap.empty() || mtimers[ mheap.front() ].expires > now )
+                        continue;
+                    next_timer_id = mheap.front();
+                    TimerInfo& tim = mtimers[next_timer_id];
+                    if ( tim.period ) {
+                        // periodic timer
+                        // if late by more than 4 periods, skip late updates
+                        int maxDelayInPeriods = 4;
+                        Time expires = tim.expires;
+                        if (now - expires > tim.period*maxDelayInPeriods) {
+                            expires += tim.period*((now - expires) / tim.period);
                         }
+                        schedule( next_timer_id, expires + tim.period, tim.period );
+                    } else {
+                        // aperiodic timer
+                        unschedule( next_timer_id );
                     }
+                    tim.expired.broadcast();
                 }
 
-                // Second: notify waiting threads
-                {// This scope is for MutexLock.
-                    MutexLock locker(m);
-                    mtimers[next_timer_id].expired.broadcast();
-                }// MutexLock
-
-                // Third: send the timeout signal and allow (within the callback)
+                // Second: send the timeout signal and allow (within the callback)
                 // to reprogram the timer.
                 // If we would expires call timeout(), the code above would overwrite
                 // user settings.
@@ -129,6 +120,87 @@ namespace RTT {
         }
     }
 
+    bool Timer::earlier(TimerId a, TimerId b) const
+    {
+        // Timers expiring at the same time fire in the order of their id.
+        return mtimers[a].expires < mtimers[b].expires
+            || ( mtimers[a].expires == mtimers[b].expires && a < b );
+    }
+
+    void Timer::heapSet(std::size_t pos, TimerId timer_id)
+    {
+        mheap[pos] = timer_id;
+        mtimers[timer_id].heap_index = pos;
+    }
+
+    void Timer::siftUp(std::size_t pos)
+    {
+        TimerId timer_id = mheap[pos];
+        while ( pos != 0 ) {
+            std::size_t parent = (pos - 1) / 2;
+            if ( !earlier( timer_id, mheap[parent] ) )
+                break;
+            heapSet( pos, mheap[parent] );
+            pos = parent;
+        }
+        heapSet( pos, timer_id );
+    }
+
+    void Timer::siftDown(std::size_t pos)
+    {
+        TimerId timer_id = mheap[pos];
+        while ( true ) {
+            std::size_t child = 2 * pos + 1;
+            if ( child >= mheap.size() )
+                break;
+            if ( child + 1 < mheap.size() && earlier( mheap[child + 1], mheap[child] ) )
+                ++child;
+            if ( !earlier( mheap[child], timer_id ) )
+                break;
+            heapSet( pos, mheap[child] );
+            pos = child;
+        }
+        heapSet( pos, timer_id );
+    }
+
+    bool Timer::schedule(TimerId timer_id, Time expires, Time period)
+    {
+        TimerInfo& tim = mtimers[timer_id];
+        tim.expires = expires;
+        tim.period = period;
+        if ( tim.heap_index < 0 ) {
+            // does not allocate, room for all timers was reserved.
+            mheap.push_back( timer_id );
+            siftUp( mheap.size() - 1 );
+        } else {
+            std::size_t pos = tim.heap_index;
+            siftUp( pos );
+            if ( mtimers[timer_id].heap_index == int(pos) )
+                siftDown( pos );
+        }
+        return mheap.front() == timer_id;
+    }
+
+    void Timer::unschedule(TimerId timer_id)
+    {
+        TimerInfo& tim = mtimers[timer_id];
+        tim.expires = 0;
+        tim.period = 0;
+        if ( tim.heap_index < 0 )
+            return;
+        std::size_t pos = tim.heap_index;
+        tim.heap_index = -1;
+        TimerId last = mheap.back();
+        mheap.pop_back();
+        if ( last == timer_id )
+            return;
+        // Move the last timer into the hole and restore the heap order.
+        heapSet( pos, last );
+        siftUp( pos );
+        if ( mtimers[last].heap_index == int(pos) )
+            siftDown( pos );
+    }
+
     bool Timer::breakLoop()
     {
         mdo_quit = true;
@@ -144,6 +216,7 @@ namespace RTT {
         : mThread(0), msem(0), mdo_quit(false)
     {
         mtimers.resize(max_timers);
+        mheap.reserve(max_timers);
         if (scheduler != -1) {
             mThread = new Activity(scheduler, priority, 0.0, this, "Timer");
             mThread->start();
@@ -164,7 +237,10 @@ namespace RTT {
     void Timer::setMaxTimers(TimerId max)
     {
         MutexLock locker(m);
+        for (TimerId i = max; i < int(mtimers.size()); ++i)
+            unschedule(i);
         mtimers.resize(max, TimerInfo() );
+        mheap.reserve(max);
     }
 
     bool Timer::startTimer(TimerId timer_id, double period)
@@ -177,12 +253,14 @@ namespace RTT {
 
         Time due_time = rtos_get_time_ns() + Seconds_to_nsecs( period );
 
+        bool first;
         {
             MutexLock locker(m);
-            mtimers[timer_id].expires = due_time;
-            mtimers[timer_id].period = Seconds_to_nsecs( period );
+            first = schedule( timer_id, due_time, Seconds_to_nsecs( period ) );
         }
-        msem.signal();
+        // Only wake up the timer thread if this timer is the next one to expire.
+        if ( first )
+            msem.signal();
         return true;
     }
 
@@ -197,12 +275,13 @@ namespace RTT {
         Time now = rtos_get_time_ns();
         Time due_time = now + Seconds_to_nsecs( wait_time );
 
+        bool first;
         {
             MutexLock locker(m);
-            mtimers[timer_id].expires  = due_time;
-            mtimers[timer_id].period = 0;
+            first = schedule( timer_id, due_time, 0 );
         }
-        msem.signal();
+        if ( first )
+            msem.signal();
         return true;
     }
 
@@ -241,8 +320,8 @@ namespace RTT {
             log(Error) << "Invalid timer id" << endlog();
             return false;
         }
-        mtimers[timer_id].expires = 0;
-        mtimers[timer_id].period = 0;
+        // The timer thread finds out by itself that this timer is gone.
+        unschedule( timer_id );
         mtimers[timer_id].expired.broadcast();
         return true;
     }
@@ -80,11 +80,12 @@ namespace RTT
 
         struct TimerInfo
         {
-            TimerInfo() : expires(0), period(0) {}
+            TimerInfo() : expires(0), period(0), heap_index(-1) {}
             TimerInfo(const TimerInfo& other) { *this = other; }
-            TimerInfo& operator=(const TimerInfo& other) { this->expires = other.expires; this->period = other.period; return *this; }
+            TimerInfo& operator=(const TimerInfo& other) { this->expires = other.expires; this->period = other.period; this->heap_index = other.heap_index; return *this; }
             Time expires; // was .first
             Time period;  // was .second
+            int heap_index; // position in mheap, or -1 if not armed.
             Condition expired;
         };
 
@@ -95,6 +96,15 @@ namespace RTT
          */
         typedef std::vector<TimerInfo> TimerIds;
         TimerIds mtimers;
+
+        /**
+         * The ids of all armed timers, ordered as a binary min-heap
+         * on their expiry time, such that the next timer to expire
+         * is always at the front. Each TimerInfo knows its position
+         * in the heap, so arming, re-arming and killing a timer take
+         * O(log n) time instead of a scan over all timers.
+         */
+        std::vector<TimerId> mheap;
         bool mdo_quit;
 
         bool initialize();
@@ -106,6 +116,25 @@ namespace RTT
 
         bool breakLoop();
 
+        /**
+         * Sets the expiry time and period of a timer and (re)inserts it in the heap.
+         * Must be called with \a m locked.
+         * @return true if this timer is now the first one to expire.
+         */
+        bool schedule(TimerId timer_id, Time expires, Time period);
+
+        /**
+         * Disarms a timer and removes it from the heap.
+         * Must be called with \a m locked.
+         */
+        void unschedule(TimerId timer_id);
+
+    private:
+        bool earlier(TimerId a, TimerId b) const;
+        void heapSet(std::size_t pos, TimerId timer_id);
+        void siftUp(std::size_t pos);
+        void siftDown(std::size_t pos);
+
     public:
         /**
          * Create a timer object which can hold \a max_timers timers.
@@ -48,6 +48,7 @@
 #define OS_FOSI_INTERNAL_INTERFACE_HPP
 
 #include "ThreadInterface.hpp"
+#include "CpuSet.hpp"
 #include "fosi.h"
 
 namespace RTT {
@@ -98,6 +99,25 @@ namespace RTT {
                                  void * (*start_routine)(void *),
                                  ThreadInterface* obj);
 
+            /**
+             * Keep up to \a size threads with a stack of \a stack_size bytes
+             * parked when their task is deleted, and spawn as many as needed
+             * to have \a size parked threads now. rtos_task_create() then hands
+             * a parked thread with the same stack size to the new task instead
+             * of spawning one. A \a size of zero stops all parked threads.
+             *
+             * @param stack_size The stack size of the threads to spawn, or zero
+             * for the default stack size.
+             * @retval 0 on success.
+             * @retval -1 when the RTOS does not support a thread cache.
+             */
+            int rtos_task_set_thread_cache(unsigned int size, size_t stack_size);
+
+            /**
+             * Returns the number of threads parked in the thread cache.
+             */
+            unsigned int rtos_task_get_cached_threads();
+
             /**
              * Yields the current thread. This function may be left empty.
              * @param task The task handle of the current thread.
@@ -137,6 +157,19 @@ namespace RTT {
              */
             int rtos_task_get_scheduler(const RTOS_TASK* t);
 
+            /**
+             * Let the kernel schedule task \a t by its deadline: it gets
+             * \a runtime nanoseconds of CPU time every \a period, which
+             * must be used up within \a deadline after each release.
+             * The kernel refuses tasks which would overload the CPUs.
+             * Use rtos_task_set_scheduler() to leave the deadline scheduler.
+             *
+             * @retval 0 when the kernel accepted the parameters.
+             * @retval -1 when the RTOS has no deadline scheduler or the
+             * kernel refused the parameters.
+             */
+            int rtos_task_set_deadline(RTOS_TASK* t, NANO_TIME runtime, NANO_TIME deadline, NANO_TIME period);
+
             /**
              * This function is to inform the RTOS that a thread is switching between
              * periodic or non-periodic execution. This may temporarily suspend the
@@ -179,6 +212,25 @@ namespace RTT {
              */
             int rtos_task_wait_period( RTOS_TASK* task );
 
+            /**
+             * Returns how late the last rtos_task_wait_period() of \a task
+             * returned after the start of the period it waited for,
+             * measured with the clock that times the periods of \a task.
+             * @return the latency in nanoseconds, or a negative value
+             * if this target does not measure it.
+             */
+            NANO_TIME rtos_task_get_wakeup_latency( const RTOS_TASK* task );
+
+            /**
+             * Returns the time elapsed since the start of the current
+             * period of \a task, measured with the clock that times the
+             * periods of \a task. The current period is the one the last
+             * rtos_task_wait_period() waited for, or the first one.
+             * @return the elapsed time in nanoseconds, or a negative value
+             * if \a task is not periodic or this target does not measure it.
+             */
+            NANO_TIME rtos_task_get_period_elapsed( const RTOS_TASK* task );
+
             /**
              * This function must join the thread created with
              * rtos_task_create and then clean up the RTOS_TASK struct.
@@ -241,6 +293,47 @@ namespace RTT {
              */
             unsigned rtos_task_get_cpu_affinity(const RTOS_TASK * task);
 
+            /**
+             * Set the cpu affinity of a thread to a set of CPUs, which
+             * may contain CPUs above 31.
+             * @param task The thread to change the cpu affinity of
+             * @param cpus The CPUs the thread may run on. An empty set
+             *        allows all CPUs.
+             * @return 0 if the cpu affinity could be set.
+             */
+            int rtos_task_set_cpu_set(RTOS_TASK * task, const CpuSet& cpus);
+
+            /**
+             * Return the set of CPUs a thread may run on.
+             * @param task The thread to get the cpu affinity of
+             * @param cpus Is filled in with the CPUs of \a task.
+             * @return 0 if the cpu affinity could be read.
+             */
+            int rtos_task_get_cpu_set(const RTOS_TASK * task, CpuSet& cpus);
+
+            /**
+             * Return the CPUs which belong to NUMA node \a node.
+             * @return 0 if \a node exists.
+             */
+            int rtos_numa_node_cpus(int node, CpuSet& cpus);
+
+            /**
+             * Let the calling thread allocate new memory pages on NUMA
+             * node \a node when possible, or reset it to the default
+             * policy, which is allocating on the local node, if \a node is -1.
+             * @return 0 if the memory policy could be changed.
+             */
+            int rtos_numa_set_preferred_node(int node);
+
+            /**
+             * Return the NUMA node the calling thread prefers to
+             * allocate memory on.
+             * @retval -1 if the thread uses the default policy.
+             * @retval -2 if the thread uses another memory policy or
+             * if the OS does not support NUMA.
+             */
+            int rtos_numa_get_preferred_node();
+
             /**
              * Returns the name by which a task is known in the RTOS.
              * @param task The task to query.
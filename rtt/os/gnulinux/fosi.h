@@ -74,17 +74,31 @@ extern "C"
 
     TIME_SPEC periodMark;
     NANO_TIME period;
+    /** The clock periodMark is measured with, CLOCK_MONOTONIC by default,
+        such that setting the system time does not shift the period. */
+    clockid_t clock;
+    /** The time between periodMark and the return of the last
+        rtos_task_wait_period(), measured with clock. */
+    NANO_TIME wake_latency;
 
     char* name;
 
     int priority;
     int wait_policy;
     pid_t pid;
+    /** Set when the thread was taken from the thread cache,
+        see rtos_task_set_thread_cache(). */
+    void* cache_job;
   } RTOS_TASK;
 
 
 #define ORO_SCHED_RT    SCHED_FIFO /** Linux FIFO scheduler */
 #define ORO_SCHED_OTHER SCHED_OTHER /** Linux normal scheduler */
+#ifdef SCHED_DEADLINE
+#define ORO_SCHED_DEADLINE SCHED_DEADLINE /** Linux deadline scheduler, see rtos_task_set_deadline() */
+#else
+#define ORO_SCHED_DEADLINE 6
+#endif
 
 
 	// high-resolution time to timespec
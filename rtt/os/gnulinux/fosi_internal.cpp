@@ -50,6 +50,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <stdint.h>
+#include <linux/mempolicy.h>
 
 using namespace std;
 
@@ -58,10 +60,23 @@ using namespace std;
 namespace RTT
 { namespace os {
 
+    /**
+     * The current time in nanoseconds of the clock that
+     * times the periods of \a task.
+     */
+    static NANO_TIME rtos_task_get_time_ns( const RTOS_TASK* task )
+    {
+        TIME_SPEC tv;
+        clock_gettime(task->clock, &tv);
+        return NANO_TIME( tv.tv_sec ) * 1000000000LL + NANO_TIME( tv.tv_nsec );
+    }
+
 	INTERNAL_QUAL int rtos_task_create_main(RTOS_TASK* main_task)
 	{
         const char* name = "main";
         main_task->wait_policy = ORO_WAIT_ABS;
+        main_task->clock = CLOCK_MONOTONIC;
+        main_task->wake_latency = 0;
 	    main_task->name = strcpy( (char*)malloc( (strlen(name) + 1) * sizeof(char)), name);
         main_task->thread = pthread_self();
 	    pthread_attr_init( &(main_task->attr) );
@@ -72,11 +87,13 @@ namespace RTT
 	    pthread_attr_setschedparam(&(main_task->attr), &sp);
         main_task->priority = sp.sched_priority;
         main_task->pid = getpid();
+        main_task->cache_job = 0;
 	    return 0;
 	}
 
 	INTERNAL_QUAL int rtos_task_delete_main(RTOS_TASK* main_task)
 	{
+        rtos_task_set_thread_cache(0, 0);
         pthread_attr_destroy( &(main_task->attr) );
         free(main_task->name);
         main_task->name = NULL;
@@ -101,6 +118,160 @@ namespace RTT
         return 0;
     }
 
+    /**
+     * The task a cached thread executes, and how rtos_task_delete()
+     * learns that it finished.
+     */
+    struct CachedJob {
+        PosixCookie* cookie;
+        sem_t done;
+        /** True if the thread exits instead of being parked. */
+        bool exiting;
+    };
+
+    /**
+     * A thread which is parked in the thread cache when its task
+     * finished, until rtos_task_create() hands it a new one.
+     */
+    struct CachedThread {
+        pthread_t thread;
+        size_t stack_size;
+        sem_t wake;
+        /** The next task, or null to let the thread exit. */
+        CachedJob* volatile job;
+        CachedThread* next;
+    };
+
+    static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+    static CachedThread* cache_parked = 0;
+    static unsigned int cache_parked_count = 0;
+    static unsigned int cache_size = 0;
+
+    static bool rtos_thread_cache_park(CachedThread* host)
+    {
+        pthread_mutex_lock(&cache_lock);
+        bool parked = cache_parked_count < cache_size;
+        if (parked) {
+            host->next = cache_parked;
+            cache_parked = host;
+            ++cache_parked_count;
+        }
+        pthread_mutex_unlock(&cache_lock);
+        return parked;
+    }
+
+    static CachedThread* rtos_thread_cache_take(size_t stack_size)
+    {
+        pthread_mutex_lock(&cache_lock);
+        CachedThread** p = &cache_parked;
+        while ( *p && (*p)->stack_size != stack_size )
+            p = &(*p)->next;
+        CachedThread* host = *p;
+        if (host) {
+            *p = host->next;
+            --cache_parked_count;
+        }
+        pthread_mutex_unlock(&cache_lock);
+        return host;
+    }
+
+    INTERNAL_QUAL void* rtos_cached_thread( void* arg )
+    {
+        CachedThread* host = (CachedThread*)arg;
+        while (true) {
+            while ( sem_wait( &host->wake ) != 0 ) {}
+            CachedJob* job = host->job;
+            if (job == 0)
+                break;
+            host->job = 0;
+            rtos_posix_thread_wrapper( job->cookie );
+
+            bool parked = rtos_thread_cache_park(host);
+            if (!parked) {
+                sem_destroy( &host->wake );
+                free(host);
+            }
+            // job may be freed as soon as done is signalled.
+            job->exiting = !parked;
+            sem_post( &job->done );
+            if (!parked)
+                return 0;
+        }
+        sem_destroy( &host->wake );
+        free(host);
+        return 0;
+    }
+
+    static CachedThread* rtos_thread_cache_spawn(pthread_attr_t* attr, size_t stack_size, CachedJob* job)
+    {
+        CachedThread* host = (CachedThread*)malloc( sizeof(CachedThread) );
+        if (host == 0)
+            return 0;
+        host->stack_size = stack_size;
+        host->job = job;
+        host->next = 0;
+        sem_init( &host->wake, 0, job ? 1 : 0 );
+        int rv = pthread_create( &host->thread, attr, rtos_cached_thread, host );
+        if (rv != 0) {
+            log(Error) << "Failed to create a cached thread: " << strerror(rv) << endlog();
+            sem_destroy( &host->wake );
+            free(host);
+            return 0;
+        }
+        return host;
+    }
+
+    INTERNAL_QUAL int rtos_task_set_thread_cache(unsigned int size, size_t stack_size)
+    {
+        pthread_mutex_lock(&cache_lock);
+        cache_size = size;
+        CachedThread* stopped = 0;
+        while ( cache_parked_count > size ) {
+            CachedThread* host = cache_parked;
+            cache_parked = host->next;
+            --cache_parked_count;
+            host->next = stopped;
+            stopped = host;
+        }
+        unsigned int missing = size - cache_parked_count;
+        pthread_mutex_unlock(&cache_lock);
+
+        while (stopped) {
+            CachedThread* host = stopped;
+            stopped = host->next;
+            pthread_t thread = host->thread;
+            host->job = 0;
+            sem_post( &host->wake );
+            pthread_join( thread, 0 );
+        }
+
+        pthread_attr_t attr;
+        pthread_attr_init( &attr );
+        if ( stack_size )
+            pthread_attr_setstacksize( &attr, stack_size );
+        for (unsigned int i = 0; i != missing; ++i) {
+            CachedThread* host = rtos_thread_cache_spawn( &attr, stack_size, 0 );
+            if ( host == 0 || !rtos_thread_cache_park(host) ) {
+                if (host) {
+                    pthread_t thread = host->thread;
+                    sem_post( &host->wake );
+                    pthread_join( thread, 0 );
+                }
+                break;
+            }
+        }
+        pthread_attr_destroy( &attr );
+        return 0;
+    }
+
+    INTERNAL_QUAL unsigned int rtos_task_get_cached_threads()
+    {
+        pthread_mutex_lock(&cache_lock);
+        unsigned int count = cache_parked_count;
+        pthread_mutex_unlock(&cache_lock);
+        return count;
+    }
+
 
 
 	INTERNAL_QUAL int rtos_task_create(RTOS_TASK* task,
@@ -114,6 +285,8 @@ namespace RTT
 	{
         int rv; // return value
         task->wait_policy = ORO_WAIT_ABS;
+        task->clock = CLOCK_MONOTONIC;
+        task->wake_latency = 0;
         rtos_task_check_priority( &sched_type, &priority );
         // Save priority internally, since the pthread_attr* calls are broken !
         // we will pick it up later in rtos_task_set_scheduler().
@@ -153,6 +326,42 @@ namespace RTT
                 return rv;
             }
 	    }
+        task->cache_job = 0;
+        // Without memory for the job, the thread is created the usual way.
+        CachedJob* job = cache_size ? (CachedJob*)malloc( sizeof(CachedJob) ) : 0;
+        if ( job ) {
+            // Take a parked thread, or spawn one which can be parked later on.
+            job->cookie = xcookie;
+            job->exiting = false;
+            sem_init( &job->done, 0, 0 );
+            CachedThread* host = rtos_thread_cache_take( stack_size );
+            if ( host ) {
+                // A new thread inherits the scheduling of its creator, so
+                // does a parked one.
+                int policy;
+                struct sched_param param;
+                cpu_set_t cs;
+                if ( pthread_getschedparam( pthread_self(), &policy, &param ) == 0 )
+                    pthread_setschedparam( host->thread, policy, &param );
+                if ( pthread_getaffinity_np( pthread_self(), sizeof(cs), &cs ) == 0 )
+                    pthread_setaffinity_np( host->thread, sizeof(cs), &cs );
+                task->thread = host->thread;
+                host->job = job;
+                sem_post( &host->wake );
+                rv = 0;
+            } else {
+                host = rtos_thread_cache_spawn( &(task->attr), stack_size, job );
+                if ( host )
+                    task->thread = host->thread;
+                rv = host ? 0 : EAGAIN;
+            }
+            if ( rv == 0 )
+                task->cache_job = job;
+            else {
+                sem_destroy( &job->done );
+                free(job);
+            }
+        } else
 	    rv = pthread_create(&(task->thread), &(task->attr),
 	    		rtos_posix_thread_wrapper, xcookie);
         if (rv != 0) {
@@ -246,12 +455,52 @@ namespace RTT
         return -1;
     }
 
+#if defined(SYS_sched_setattr)
+    /**
+     * The argument of sched_setattr(2), which glibc does not declare.
+     */
+    struct rtos_sched_attr {
+        uint32_t size;
+        uint32_t sched_policy;
+        uint64_t sched_flags;
+        int32_t  sched_nice;
+        uint32_t sched_priority;
+        uint64_t sched_runtime;
+        uint64_t sched_deadline;
+        uint64_t sched_period;
+    };
+#endif
+
+    INTERNAL_QUAL int rtos_task_set_deadline(RTOS_TASK* task, NANO_TIME runtime, NANO_TIME deadline, NANO_TIME period)
+    {
+#if defined(SYS_sched_setattr)
+        if ( !task || task->pid == 0 || runtime == 0 || runtime > deadline || deadline > period )
+            return -1;
+        struct rtos_sched_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.sched_policy = ORO_SCHED_DEADLINE;
+        attr.sched_runtime = runtime;
+        attr.sched_deadline = deadline;
+        attr.sched_period = period;
+        if ( syscall(SYS_sched_setattr, task->pid, &attr, 0) != 0 ) {
+            // EBUSY: admission control refused, EPERM: not privileged or
+            // restricted to less CPUs than its scheduling domain.
+            log(Warning) << "Could not schedule " << task->name << " by deadline: " << strerror(errno) << endlog();
+            return -1;
+        }
+        return 0;
+#else
+        return -1;
+#endif
+    }
+
 	INTERNAL_QUAL void rtos_task_make_periodic(RTOS_TASK* mytask, NANO_TIME nanosecs )
 	{
 	    // set period
 	    mytask->period = nanosecs;
 	    // set next wake-up time.
-	    mytask->periodMark = ticks2timespec( nano2ticks( rtos_get_time_ns() + nanosecs ) );
+	    mytask->periodMark = ticks2timespec( nano2ticks( rtos_task_get_time_ns(mytask) + nanosecs ) );
 	}
 
 	INTERNAL_QUAL void rtos_task_set_period( RTOS_TASK* mytask, NANO_TIME nanosecs )
@@ -270,13 +519,14 @@ namespace RTT
             return 0;
 
         // record this to detect overrun.
-	    NANO_TIME now = rtos_get_time_ns();
+	    NANO_TIME now = rtos_task_get_time_ns(task);
 	    NANO_TIME wake= task->periodMark.tv_sec * 1000000000LL + task->periodMark.tv_nsec;
 
         // inspired by nanosleep man page for this construct:
-        while ( clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &(task->periodMark), NULL) != 0 && errno == EINTR ) {
+        while ( clock_nanosleep(task->clock, TIMER_ABSTIME, &(task->periodMark), NULL) != 0 && errno == EINTR ) {
             errno = 0;
         }
+        task->wake_latency = rtos_task_get_time_ns(task) - wake;
 
         if (task->wait_policy == ORO_WAIT_ABS)
         {
@@ -298,7 +548,7 @@ namespace RTT
         else
         {
           TIME_SPEC ts = ticks2timespec( nano2ticks( task->period) );
-          TIME_SPEC now = ticks2timespec( rtos_get_time_ns() );
+          TIME_SPEC now = ticks2timespec( rtos_task_get_time_ns(task) );
           NANO_TIME tn = (now.tv_nsec + ts.tv_nsec);
           task->periodMark.tv_nsec = tn % 1000000000LL;
           task->periodMark.tv_sec = ts.tv_sec + now.tv_sec + tn / 1000000000LL;
@@ -307,7 +557,31 @@ namespace RTT
 	    return now > wake ? -1 : 0;
 	}
 
+    INTERNAL_QUAL NANO_TIME rtos_task_get_wakeup_latency( const RTOS_TASK* task )
+    {
+        return task->wake_latency;
+    }
+
+    INTERNAL_QUAL NANO_TIME rtos_task_get_period_elapsed( const RTOS_TASK* task )
+    {
+        if ( task->period == 0 )
+            return -1;
+        // periodMark is the end of the current period.
+        NANO_TIME mark = task->periodMark.tv_sec * 1000000000LL + task->periodMark.tv_nsec;
+        return rtos_task_get_time_ns(task) - (mark - task->period);
+    }
+
 	INTERNAL_QUAL void rtos_task_delete(RTOS_TASK* mytask) {
+        CachedJob* job = (CachedJob*)mytask->cache_job;
+        if ( job ) {
+            // The thread is parked instead of joined, unless the cache is full.
+            while ( sem_wait( &job->done ) != 0 ) {}
+            if ( job->exiting )
+                pthread_join( mytask->thread, 0);
+            sem_destroy( &job->done );
+            free(job);
+            mytask->cache_job = 0;
+        } else
         pthread_join( mytask->thread, 0);
         pthread_attr_destroy( &(mytask->attr) );
 	    free(mytask->name);
@@ -463,6 +737,85 @@ namespace RTT
         return ~0;
         }
 
+	INTERNAL_QUAL int rtos_task_set_cpu_set(RTOS_TASK * task, const CpuSet& cpus)
+	{
+        if( task && task->thread != 0 ) {
+            cpu_set_t cs;
+            CPU_ZERO(&cs);
+            for(unsigned i = 0; i < CPU_SETSIZE && i < CpuSet::MaxCpus; i++)
+                {
+                    if(cpus.empty() || cpus.isSet(i)) { CPU_SET(i, &cs); }
+                }
+            return pthread_setaffinity_np(task->thread, sizeof(cs), &cs);
+        }
+        return -1;
+    }
+
+	INTERNAL_QUAL int rtos_task_get_cpu_set(const RTOS_TASK * task, CpuSet& cpus)
+	{
+        cpus = CpuSet();
+        cpu_set_t cs;
+        if( task && task->thread != 0 && pthread_getaffinity_np(task->thread, sizeof(cs), &cs) == 0) {
+            for(unsigned i = 0; i < CPU_SETSIZE && i < CpuSet::MaxCpus; i++)
+                {
+                    if(CPU_ISSET(i, &cs)) { cpus.set(i); }
+                }
+            return 0;
+        }
+        return -1;
+    }
+
+    INTERNAL_QUAL int rtos_numa_node_cpus(int node, CpuSet& cpus)
+    {
+        cpus = CpuSet();
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE* f = node >= 0 ? fopen(path, "r") : 0;
+        if ( f == 0 )
+            return -1;
+        // the list looks like "0-3,8-11"
+        unsigned first, last;
+        int n;
+        while ( (n = fscanf(f, "%u-%u", &first, &last)) >= 1 ) {
+            if ( n == 1 )
+                last = first;
+            for (unsigned i = first; i <= last && i < CpuSet::MaxCpus; ++i)
+                cpus.set(i);
+            if ( fgetc(f) != ',' )
+                break;
+        }
+        fclose(f);
+        return cpus.empty() ? -1 : 0;
+    }
+
+    INTERNAL_QUAL int rtos_numa_set_preferred_node(int node)
+    {
+        if ( node < 0 )
+            return syscall(SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0) == 0 ? 0 : -1;
+        unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+        if ( unsigned(node) >= 8 * sizeof(mask) )
+            return -1;
+        mask[node / (8 * sizeof(unsigned long))] = 1ul << (node % (8 * sizeof(unsigned long)));
+        return syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, 8 * sizeof(mask)) == 0 ? 0 : -1;
+    }
+
+    INTERNAL_QUAL int rtos_numa_get_preferred_node()
+    {
+        int mode = -1;
+        unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+        if ( syscall(SYS_get_mempolicy, &mode, mask, 8 * sizeof(mask), NULL, 0) != 0 )
+            return -2;
+        if ( mode == MPOL_DEFAULT )
+            return -1;
+        if ( mode != MPOL_PREFERRED )
+            return -2;
+        for (unsigned i = 0; i != 8 * sizeof(mask); ++i)
+            if ( mask[i / (8 * sizeof(unsigned long))] & (1ul << (i % (8 * sizeof(unsigned long)))) )
+                return i;
+        // preferring no node means allocating on the local node.
+        return -1;
+    }
+
 	INTERNAL_QUAL const char * rtos_task_get_name(const RTOS_TASK* task)
 	{
         return task->name ? task->name : "(destroyed)";
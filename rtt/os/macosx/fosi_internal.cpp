@@ -152,6 +152,21 @@ namespace RTT
             return -1;
         }
 
+        INTERNAL_QUAL int rtos_task_set_deadline(RTOS_TASK* t, NANO_TIME runtime, NANO_TIME deadline, NANO_TIME period)
+        {
+            return -1;
+        }
+
+        INTERNAL_QUAL int rtos_task_set_thread_cache(unsigned int size, size_t stack_size)
+        {
+            return -1;
+        }
+
+        INTERNAL_QUAL unsigned int rtos_task_get_cached_threads()
+        {
+            return 0;
+        }
+
 	INTERNAL_QUAL void rtos_task_make_periodic(RTOS_TASK* mytask, NANO_TIME nanosecs )
 	{
 	    // set period
@@ -200,6 +215,18 @@ namespace RTT
 	    return -1;
 	}
 
+	INTERNAL_QUAL NANO_TIME rtos_task_get_wakeup_latency( const RTOS_TASK* task )
+	{
+	    // not measured on this target.
+	    return -1;
+	}
+
+	INTERNAL_QUAL NANO_TIME rtos_task_get_period_elapsed( const RTOS_TASK* task )
+	{
+	    // not measured on this target.
+	    return -1;
+	}
+
 	INTERNAL_QUAL void rtos_task_delete(RTOS_TASK* mytask)
 	{
             pthread_join( mytask->thread, 0);
@@ -281,6 +308,32 @@ namespace RTT
         return ~0;
         }
 
+	INTERNAL_QUAL int rtos_task_set_cpu_set(RTOS_TASK * task, const CpuSet& cpus)
+	{
+	    return cpus.fitsMask() ? rtos_task_set_cpu_affinity(task, cpus.toMask()) : -1;
+	}
+
+	INTERNAL_QUAL int rtos_task_get_cpu_set(const RTOS_TASK * task, CpuSet& cpus)
+	{
+	    cpus = CpuSet( rtos_task_get_cpu_affinity(task) );
+	    return 0;
+	}
+
+	INTERNAL_QUAL int rtos_numa_node_cpus(int node, CpuSet& cpus)
+	{
+	    return -1;
+	}
+
+	INTERNAL_QUAL int rtos_numa_set_preferred_node(int node)
+	{
+	    return -1;
+	}
+
+	INTERNAL_QUAL int rtos_numa_get_preferred_node()
+	{
+	    return -2;
+	}
+
 	INTERNAL_QUAL const char * rtos_task_get_name(const RTOS_TASK* task)
 	{
         return task->name ? task->name : "(destroyed)";
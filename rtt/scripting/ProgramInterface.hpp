@@ -159,6 +159,8 @@ namespace RTT
          */
         virtual const std::string& getName() const = 0;
 
+        virtual std::string getExecutableName() const { return getName(); }
+
         /**
          * Get the argument list of this program.
          */
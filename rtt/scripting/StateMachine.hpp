@@ -573,6 +573,8 @@ namespace RTT
             return _name;
         }
 
+        virtual std::string getExecutableName() const { return _name; }
+
         /**
          * Returns the current program line in execution,
          * @return 1 if not active
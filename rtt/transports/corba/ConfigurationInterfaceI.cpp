@@ -74,6 +74,8 @@
 #include "../../PropertyBag.hpp"
 #include "../../Property.hpp"
 #include "../../rtt-detail-fwd.hpp"
+#include "../../types/Operators.hpp"
+#include "../../os/MutexLock.hpp"
 
 using namespace RTT;
 using namespace RTT::detail;
@@ -81,12 +83,12 @@ using namespace std;
 
 // Implementation skeleton constructor
 RTT_corba_CConfigurationInterface_i::RTT_corba_CConfigurationInterface_i (ConfigurationInterface* ar, PortableServer::POA_ptr the_poa)
-    :mar (ar), mbag(0), mpoa( PortableServer::POA::_duplicate(the_poa))
+    :mar (ar), mbag(0), mpoa( PortableServer::POA::_duplicate(the_poa)), mversion(0)
 {
 }
 
 RTT_corba_CConfigurationInterface_i::RTT_corba_CConfigurationInterface_i (PropertyBag* bag, PortableServer::POA_ptr the_poa)
-    :mar (0), mbag(bag), mpoa( PortableServer::POA::_duplicate(the_poa))
+    :mar (0), mbag(bag), mpoa( PortableServer::POA::_duplicate(the_poa)), mversion(0)
 {
 }
 
@@ -223,6 +225,176 @@ RTT_corba_CConfigurationInterface_i::~RTT_corba_CConfigurationInterface_i (void)
     return ctt->updateFromAny( &value, ds );
 }
 
+::RTT::base::DataSourceBase::shared_ptr RTT_corba_CConfigurationInterface_i::getValueDataSource(const std::string& name, bool property)
+{
+    if ( !property )
+        return getAttributeDataSource( name );
+    if (mar)
+        mbag = mar->properties(); // leave this here to get latest propertybag.
+    if ( mbag && findProperty( *mbag, name ) )
+        return findProperty( *mbag, name )->getDataSource();
+    return DataSourceBase::shared_ptr();
+}
+
+bool RTT_corba_CConfigurationInterface_i::toCValue(const std::string& name, DataSourceBase::shared_ptr ds, ::RTT::corba::CConfigurationInterface::CValue& value)
+{
+    CorbaTypeTransporter* ctt = dynamic_cast<CorbaTypeTransporter*>( ds->getTypeInfo()->getProtocol(ORO_CORBA_PROTOCOL_ID) );
+    if ( !ctt )
+        return false;
+    CORBA::Any_var any;
+    try {
+        any = ctt->createAny( ds );
+    } catch(std::exception const& e) {
+        throw StdException(e.what());
+    }
+    if ( any.ptr() == 0 )
+        return false;
+    value.name = CORBA::string_dup( name.c_str() );
+    value.value = any.in();
+    return true;
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getValues(const vector<string>& names, bool property)
+{
+    ::RTT::corba::CConfigurationInterface::CValues_var ret = new ::RTT::corba::CConfigurationInterface::CValues();
+    ret->length( names.size() );
+    CORBA::ULong count = 0;
+    for(size_t i=0; i != names.size(); ++i) {
+        DataSourceBase::shared_ptr ds = getValueDataSource( names[i], property );
+        if ( ds && toCValue( names[i], ds, ret[count] ) )
+            ++count;
+    }
+    ret->length( count );
+    return ret._retn();
+}
+
+namespace {
+    /**
+     * Returns true if the snapshot's copy differs from its source.
+     */
+    bool snapshotChanged(DataSourceBase::shared_ptr source, DataSourceBase::shared_ptr copy, DataSourceBase::shared_ptr equal)
+    {
+        if ( !copy )
+            return true;
+        internal::DataSource<bool>::shared_ptr eq = internal::DataSource<bool>::narrow( equal.get() );
+        if ( eq )
+            return !eq->get();
+        if ( source->getTypeInfo()->isStreamable() )
+            return source->toString() != copy->toString();
+        return true;
+    }
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getChangedValues(const vector<string>& names, bool property, ::CORBA::ULongLong& version)
+{
+    os::MutexLock lock( msnapshot_lock );
+    Snapshots& snapshots = property ? mproperty_snapshots : mattribute_snapshots;
+    Snapshots current;
+    CORBA::ULongLong next = mversion + 1;
+    bool changed = false;
+
+    // compare all values with the copies taken during the previous call.
+    for(size_t i=0; i != names.size(); ++i) {
+        DataSourceBase::shared_ptr ds = getValueDataSource( names[i], property );
+        // a copy of a bag shares the data sources of the original, so
+        // only the properties it contains are compared.
+        if ( !ds || internal::DataSource<PropertyBag>::narrow( ds.get() ) )
+            continue;
+        Snapshots::iterator it = snapshots.find( names[i] );
+        Snapshot snapshot;
+        if ( it != snapshots.end() && it->second.source == ds ) {
+            snapshot = it->second;
+            if ( snapshotChanged( snapshot.source, snapshot.copy, snapshot.equal ) ) {
+                if ( snapshot.copy )
+                    snapshot.copy->update( ds.get() );
+                snapshot.version = next;
+                changed = true;
+            }
+        } else {
+            snapshot.source = ds;
+            snapshot.copy = ds->getTypeInfo()->buildValue();
+            if ( snapshot.copy && snapshot.copy->update( ds.get() ) )
+                snapshot.equal = types::OperatorRepository::Instance()->applyBinary( "==", snapshot.copy.get(), ds.get() );
+            else
+                snapshot.copy = DataSourceBase::shared_ptr();
+            snapshot.version = next;
+            changed = true;
+        }
+        current[ names[i] ] = snapshot;
+    }
+    snapshots.swap( current );
+    if ( changed )
+        mversion = next;
+
+    ::RTT::corba::CConfigurationInterface::CValues_var ret = new ::RTT::corba::CConfigurationInterface::CValues();
+    ret->length( snapshots.size() );
+    CORBA::ULong count = 0;
+    for( Snapshots::iterator it = snapshots.begin(); it != snapshots.end(); ++it) {
+        if ( it->second.version <= version )
+            continue;
+        DataSourceBase::shared_ptr value = it->second.copy ? it->second.copy : it->second.source;
+        if ( toCValue( it->first, value, ret[count] ) )
+            ++count;
+    }
+    ret->length( count );
+    version = mversion;
+    return ret._retn();
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getProperties (
+    const ::RTT::corba::CConfigurationInterface::CValueNames & names)
+{
+    vector<string> list;
+    for(CORBA::ULong i=0; i != names.length(); ++i)
+        list.push_back( string(names[i].in()) );
+    return getValues( list, true );
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getAllProperties (
+    void)
+{
+    if (mar)
+        mbag = mar->properties(); // leave this here to get latest propertybag.
+    if ( mbag == 0 )
+        return new ::RTT::corba::CConfigurationInterface::CValues();
+    return getValues( listProperties( *mbag ), true );
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getAttributes (
+    const ::RTT::corba::CConfigurationInterface::CValueNames & names)
+{
+    vector<string> list;
+    for(CORBA::ULong i=0; i != names.length(); ++i)
+        list.push_back( string(names[i].in()) );
+    return getValues( list, false );
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getAllAttributes (
+    void)
+{
+    if ( !mar )
+        return new ::RTT::corba::CConfigurationInterface::CValues();
+    return getValues( mar->getAttributeNames(), false );
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getChangedProperties (
+    ::CORBA::ULongLong & version)
+{
+    if (mar)
+        mbag = mar->properties(); // leave this here to get latest propertybag.
+    if ( mbag == 0 )
+        return new ::RTT::corba::CConfigurationInterface::CValues();
+    return getChangedValues( listProperties( *mbag ), true, version );
+}
+
+::RTT::corba::CConfigurationInterface::CValues * RTT_corba_CConfigurationInterface_i::getChangedAttributes (
+    ::CORBA::ULongLong & version)
+{
+    if ( !mar )
+        return new ::RTT::corba::CConfigurationInterface::CValues();
+    return getChangedValues( mar->getAttributeNames(), false, version );
+}
+
 CORBA::Boolean RTT_corba_CConfigurationInterface_i::hasAttribute (
     const char * name)
 {
@@ -78,6 +78,10 @@
 
 #include "../../ConfigurationInterface.hpp"
 #include "../../PropertyBag.hpp"
+#include "../../os/Mutex.hpp"
+#include <map>
+#include <vector>
+#include <string>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -90,6 +94,32 @@ class  RTT_corba_CConfigurationInterface_i
      RTT::PropertyBag* mbag;
      PortableServer::POA_var mpoa;
 
+     /**
+      * A copy of a value as it was returned by the last
+      * getChangedProperties() or getChangedAttributes() call.
+      */
+     struct Snapshot {
+         /** The property or attribute. */
+         RTT::base::DataSourceBase::shared_ptr source;
+         /** A copy of source, null if the type can not be copied. */
+         RTT::base::DataSourceBase::shared_ptr copy;
+         /** Evaluates copy == source, null if the type has no such operator. */
+         RTT::base::DataSourceBase::shared_ptr equal;
+         /** The version in which the value last changed. */
+         CORBA::ULongLong version;
+     };
+     typedef std::map<std::string, Snapshot> Snapshots;
+     Snapshots mproperty_snapshots;
+     Snapshots mattribute_snapshots;
+     /** The version of the last change seen in any snapshot. */
+     CORBA::ULongLong mversion;
+     RTT::os::Mutex msnapshot_lock;
+
+     RTT::base::DataSourceBase::shared_ptr getValueDataSource(const std::string& name, bool property);
+     bool toCValue(const std::string& name, RTT::base::DataSourceBase::shared_ptr ds, ::RTT::corba::CConfigurationInterface::CValue& value);
+     ::RTT::corba::CConfigurationInterface::CValues* getValues(const std::vector<std::string>& names, bool property);
+     ::RTT::corba::CConfigurationInterface::CValues* getChangedValues(const std::vector<std::string>& names, bool property, ::CORBA::ULongLong& version);
+
   public:
     //Constructor
     RTT_corba_CConfigurationInterface_i ( RTT::ConfigurationInterface* ar, PortableServer::POA_ptr the_poa);
@@ -134,6 +164,30 @@ class  RTT_corba_CConfigurationInterface_i
       const char * name,
       const ::CORBA::Any & value);
 
+  virtual
+  ::RTT::corba::CConfigurationInterface::CValues * getProperties (
+      const ::RTT::corba::CConfigurationInterface::CValueNames & names);
+
+  virtual
+  ::RTT::corba::CConfigurationInterface::CValues * getAllProperties (
+      void);
+
+  virtual
+  ::RTT::corba::CConfigurationInterface::CValues * getAttributes (
+      const ::RTT::corba::CConfigurationInterface::CValueNames & names);
+
+  virtual
+  ::RTT::corba::CConfigurationInterface::CValues * getAllAttributes (
+      void);
+
+  virtual
+  ::RTT::corba::CConfigurationInterface::CValues * getChangedProperties (
+      ::CORBA::ULongLong & version);
+
+  virtual
+  ::RTT::corba::CConfigurationInterface::CValues * getChangedAttributes (
+      ::CORBA::ULongLong & version);
+
     CORBA::Boolean hasAttribute(const char* name);
     CORBA::Boolean isAttributeAssignable(const char* name);
   virtual
@@ -40,49 +40,137 @@
 #define ORO_CORBA_DISPATCHER_HPP
 
 #include "../../os/MutexLock.hpp"
+#include "../../os/Semaphore.hpp"
 #include "../../Activity.hpp"
 #include "../../base/ChannelElementBase.hpp"
 #include "../../Logger.hpp"
-#include "../../internal/List.hpp"
+#include "../../internal/SegmentedMWSRQueue.hpp"
 #include "DataFlowI.h"
 #include "../../DataFlowInterface.hpp"
 #include "../../TaskContext.hpp"
+#include <sstream>
+#include <vector>
 
 namespace RTT {
     namespace corba {
         /**
          * This object sends over data flow messages
          * from local buffers to a remote channel element.
+         *
+         * Signalled channels are queued once, and a pool of worker
+         * threads transfers them, such that a slow remote side only
+         * delays the channels its worker is busy with. Each channel is
+         * transferred by one worker at a time, which keeps its samples
+         * in order.
          */
-        class CorbaDispatcher : public Activity
+        class CorbaDispatcher
         {
             typedef std::map<DataFlowInterface*,CorbaDispatcher*> DispatchMap;
             RTT_CORBA_API static DispatchMap DispatchI;
 
-            typedef internal::List<base::ChannelElementBase::shared_ptr> RCList;
-            RCList RClist;
-
-            bool do_exit;
-
             RTT_CORBA_API static os::Mutex* mlock;
 
             RTT_CORBA_API static int defaultScheduler;
             RTT_CORBA_API static int defaultPriority;
+            RTT_CORBA_API static unsigned int defaultWorkers;
 
-            CorbaDispatcher( const std::string& name)
-            : Activity(defaultScheduler, defaultPriority, 0.0, 0, name),
-              RClist(20,2),
-              do_exit(false)
-              {}
+            /**
+             * A thread of the pool, which transfers queued channels.
+             */
+            class Worker : public Activity
+            {
+                CorbaDispatcher* mowner;
+            public:
+                Worker(CorbaDispatcher* owner, const std::string& name, int scheduler, int priority)
+                : Activity(scheduler, priority, 0.0, 0, name),
+                  mowner(owner)
+                  {}
+
+                ~Worker() {
+                    this->stop();
+                }
+
+                bool initialize() {
+                    log(Info) <<"Started " << this->getName() << "." <<endlog();
+                    return true;
+                }
+
+                void loop() {
+                    mowner->work();
+                }
 
-            CorbaDispatcher( const std::string& name, int scheduler, int priority)
-            : Activity(scheduler, priority, 0.0, 0, name),
-              RClist(20,2),
+                bool breakLoop() {
+                    mowner->do_exit = true;
+                    mowner->mwork.signal();
+                    return true;
+                }
+            };
+
+            typedef internal::SegmentedMWSRQueue<CRemoteChannelElement_i*> ChannelQueue;
+            ChannelQueue mqueue;
+            /** Counts the channels in mqueue. */
+            os::Semaphore mwork;
+            /** Serialises the workers taking channels from mqueue. */
+            os::Mutex mtake;
+            std::vector<Worker*> mworkers;
+
+            bool do_exit;
+
+            CorbaDispatcher( const std::string& name, int scheduler, int priority, unsigned int workers)
+            : mqueue(16, 1),
+              mwork(0),
               do_exit(false)
-              {}
+            {
+                if (workers == 0)
+                    workers = 1;
+                for (unsigned int i = 0; i != workers; ++i) {
+                    std::stringstream wname;
+                    wname << name;
+                    if (i != 0)
+                        wname << i;
+                    mworkers.push_back( new Worker(this, wname.str(), scheduler, priority) );
+                }
+            }
 
             ~CorbaDispatcher() {
-                this->stop();
+                do_exit = true;
+                mwork.signal();
+                for (unsigned int i = 0; i != mworkers.size(); ++i)
+                    delete mworkers[i];
+                CRemoteChannelElement_i* chan;
+                while ( mqueue.dequeue(chan) )
+                    chan->_remove_ref();
+            }
+
+            /**
+             * Worker loop: transfer queued channels until the dispatcher exits.
+             */
+            void work() {
+                while (true) {
+                    mwork.wait();
+                    if (do_exit) {
+                        // wake up the next worker, such that all of them exit.
+                        mwork.signal();
+                        return;
+                    }
+                    CRemoteChannelElement_i* chan = 0;
+                    {
+                        os::MutexLock lock(mtake);
+                        if ( !mqueue.dequeue(chan) )
+                            continue;
+                    }
+                    if ( chan->dispatchTransfer() ) {
+                        // signalled meanwhile, let the other channels go first.
+                        mqueue.enqueue(chan);
+                        mwork.signal();
+                    } else
+                        chan->_remove_ref();
+                }
+            }
+
+            void start() {
+                for (unsigned int i = 0; i != mworkers.size(); ++i)
+                    mworkers[i]->start();
             }
 
         public:
@@ -92,9 +180,11 @@ namespace RTT {
              * otherwise, the access is lock-free and real-time.
              * One dispatcher per \a iface is created.
              * @param iface The interface to dispatch data flow messages for.
+             * @param workers The number of threads transferring data of \a iface
+             * in parallel. Only used when the dispatcher is created.
              * @return
              */
-            static CorbaDispatcher* Instance(DataFlowInterface* iface, int scheduler = defaultScheduler, int priority = defaultPriority) {
+            static CorbaDispatcher* Instance(DataFlowInterface* iface, int scheduler = defaultScheduler, int priority = defaultPriority, unsigned int workers = defaultWorkers) {
                 if (!mlock)
                     mlock = new os::Mutex();
                 DispatchMap::iterator result = DispatchI.find(iface);
@@ -111,13 +201,25 @@ namespace RTT {
                     else
                         name = iface->getOwner()->getName();
                     name += ".CorbaDispatch";
-                    DispatchI[iface] = new CorbaDispatcher( name, scheduler, priority );
+                    DispatchI[iface] = new CorbaDispatcher( name, scheduler, priority, workers );
                     DispatchI[iface]->start();
                     return DispatchI[iface];
                 }
                 return result->second;
             }
 
+            /**
+             * Sets the number of worker threads of the dispatchers created
+             * from now on. The default is two, such that one slow remote
+             * side does not delay all other channels of a component. A
+             * channel is transferred by one worker at a time, so its samples
+             * always arrive in order; only the order between channels is
+             * not kept. Set it to one to transfer all channels in order.
+             */
+            static void setDefaultWorkers(unsigned int workers) {
+                defaultWorkers = workers;
+            }
+
             /**
              * Releases and cleans up a specific interface from dispatching.
              * @param iface
@@ -148,42 +250,58 @@ namespace RTT {
                 mlock = 0;
             }
 
-	    static void hasElement(base::ChannelElementBase::shared_ptr c0, base::ChannelElementBase::shared_ptr c1, bool& result)
-	    {
-		result = result || (c0 == c1);
-	    }
+            /**
+             * Queues \a chan for transferring its samples, unless it is
+             * queued already. This function is real-time.
+             */
+            void dispatchChannel( CRemoteChannelElement_i* chan ) {
+                if ( !chan->dispatchPending() )
+                    return;
+                chan->_add_ref();
+                mqueue.enqueue( chan );
+                mwork.signal();
+            }
 
             void dispatchChannel( base::ChannelElementBase::shared_ptr chan ) {
-		bool has_element = false;
-		RClist.apply(boost::bind(&CorbaDispatcher::hasElement, _1, chan, boost::ref(has_element)));
-                if (!has_element)
-	            RClist.append( chan );
-                this->trigger();
+                CRemoteChannelElement_i* rbase = dynamic_cast<CRemoteChannelElement_i*>(chan.get());
+                if (rbase)
+                    dispatchChannel( rbase );
+            }
+
+            /**
+             * Stops transferring \a chan. It is not queued anymore when it
+             * is signalled, and a worker which takes it from the queue or
+             * finishes its transfer only releases it. This function is real-time.
+             */
+            void cancelChannel( CRemoteChannelElement_i* chan ) {
+                chan->dispatchCancel();
             }
 
             void cancelChannel( base::ChannelElementBase::shared_ptr chan ) {
-                RClist.erase( chan );
+                CRemoteChannelElement_i* rbase = dynamic_cast<CRemoteChannelElement_i*>(chan.get());
+                if (rbase)
+                    cancelChannel( rbase );
             }
 
-            bool initialize() {
-                log(Info) <<"Started " << this->getName() << "." <<endlog();
-                do_exit = false;
-                return true;
+            /**
+             * Returns the number of worker threads.
+             */
+            unsigned int getWorkerCount() const {
+                return mworkers.size();
             }
 
-            void loop() {
-                while ( !RClist.empty() && !do_exit) {
-                    base::ChannelElementBase::shared_ptr chan = RClist.front();
-                    CRemoteChannelElement_i* rbase = dynamic_cast<CRemoteChannelElement_i*>(chan.get());
-                    if (rbase)
-                        rbase->transferSamples();
-                    RClist.erase( chan );
-                }
+            /**
+             * Returns the number of channels waiting for a worker.
+             */
+            unsigned int getQueuedChannels() const {
+                return mqueue.size();
             }
 
-            bool breakLoop() {
-                do_exit = true;
-                return true;
+            /**
+             * Returns the worker thread \a i, for example to change its priority.
+             */
+            Activity* getWorker(unsigned int i) const {
+                return i < mworkers.size() ? mworkers[i] : 0;
             }
         };
     }
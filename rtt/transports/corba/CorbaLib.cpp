@@ -47,6 +47,7 @@
 
 #include "TransportPlugin.hpp"
 #include "CorbaTemplateProtocol.hpp"
+#include "CorbaRawTemplateProtocol.hpp"
 #include "RTTCorbaConversion.hpp"
 #include "../../types/TransportPlugin.hpp"
 #include "../../types/TypekitPlugin.hpp"
@@ -172,7 +173,7 @@ namespace RTT {
             if ( name == "string" )
                 return ti->addProtocol(ORO_CORBA_PROTOCOL_ID, new CorbaTemplateProtocol<std::string>() );
             if ( name == "array" )
-                return ti->addProtocol(ORO_CORBA_PROTOCOL_ID, new CorbaTemplateProtocol< std::vector<double> >() );
+                return ti->addProtocol(ORO_CORBA_PROTOCOL_ID, new CorbaRawTemplateProtocol< std::vector<double> >() );
 #endif
 #ifdef OS_RT_MALLOC
             if ( name == "rt_string")
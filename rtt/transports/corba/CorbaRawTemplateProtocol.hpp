@@ -0,0 +1,214 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 06:05:56 UTC 2026  CorbaRawTemplateProtocol.hpp
+
+                        CorbaRawTemplateProtocol.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef ORO_CORBA_RAW_TEMPLATE_PROTOCOL_HPP
+#define ORO_CORBA_RAW_TEMPLATE_PROTOCOL_HPP
+
+#include "CorbaTemplateProtocol.hpp"
+#include "../../internal/DataSourceTypeInfo.hpp"
+#include "../../Logger.hpp"
+#include <boost/type_traits/is_pod.hpp>
+#include <boost/static_assert.hpp>
+#include <vector>
+#include <string>
+#include <cstring>
+
+namespace RTT
+{ namespace corba
+  {
+      /**
+       * The header in front of the data of each CRawSample.
+       */
+      struct RawSampleHeader
+      {
+          /**
+           * Identifies the type, element size and byte order of the data.
+           */
+          CORBA::ULongLong type_hash;
+          /**
+           * The number of elements which follow this header.
+           */
+          CORBA::ULong count;
+          CORBA::ULong reserved;
+      };
+
+      /**
+       * Describes how a type is laid out in memory, for
+       * CorbaRawTemplateProtocol. The default treats \a T as one
+       * trivially copyable element.
+       */
+      template<class T>
+      struct RawConversion
+      {
+          typedef T value_type;
+
+          static const void* data(const T& t) { return &t; }
+
+          static CORBA::ULong count(const T&) { return 1; }
+
+          /**
+           * Prepares \a t to receive \a count elements.
+           * @return the memory to copy the elements to, or null if \a t can not hold \a count elements.
+           */
+          static void* resize(T& t, CORBA::ULong count) { return count == 1 ? &t : 0; }
+      };
+
+      /**
+       * A std::vector of trivially copyable elements is stored contiguously,
+       * so it can be copied in one go as well.
+       */
+      template<class T, class A>
+      struct RawConversion< std::vector<T, A> >
+      {
+          typedef T value_type;
+
+          static const void* data(const std::vector<T, A>& t) { return t.empty() ? 0 : &t[0]; }
+
+          static CORBA::ULong count(const std::vector<T, A>& t) { return t.size(); }
+
+          static void* resize(std::vector<T, A>& t, CORBA::ULong count) {
+              t.resize(count);
+              return count == 0 ? static_cast<void*>(&t) : static_cast<void*>(&t[0]);
+          }
+      };
+
+      /**
+       * A CorbaTemplateProtocol which sends data flow samples as one
+       * CRawSample, a block of octets which is copied with memcpy,
+       * instead of converting each element to a CORBA type.
+       * Register this protocol instead of CorbaTemplateProtocol for
+       * trivially copyable types and for std::vector's of trivially copyable
+       * types. Properties, attributes and operations still use the
+       * conversions of AnyConversion.
+       *
+       * Raw samples are only sent if both sides of a connection agree
+       * on the type hash, which is formed from the type name, the element
+       * size and the byte order. Otherwise, the connection falls back to
+       * the AnyConversion. The writing side negotiates the hash the
+       * first time it transfers samples, so in pull mode the first
+       * sample the reader takes may still be converted.
+       */
+      template<class T>
+      class CorbaRawTemplateProtocol
+          : public CorbaTemplateProtocol<T>
+      {
+          typedef RawConversion<T> Raw;
+          typedef typename Raw::value_type value_type;
+          // the elements are copied with memcpy.
+          BOOST_STATIC_ASSERT( boost::is_pod<value_type>::value );
+          mutable CORBA::ULongLong mhash;
+      public:
+          CorbaRawTemplateProtocol()
+              : mhash(0)
+          {}
+
+          virtual CORBA::ULongLong getRawTypeHash() const
+          {
+              if ( mhash == 0 ) {
+                  // FNV-1a over the type name, the element size and the byte order.
+                  const std::string& name = internal::DataSourceTypeInfo<T>::getTypeName();
+                  CORBA::ULongLong hash = 14695981039346656037ULL;
+                  for (std::string::size_type i = 0; i != name.size(); ++i)
+                      hash = (hash ^ (unsigned char)name[i]) * 1099511628211ULL;
+                  CORBA::ULong layout[2] = { sizeof(value_type), 0x01020304 };
+                  const unsigned char* octets = reinterpret_cast<const unsigned char*>(layout);
+                  for (unsigned int i = 0; i != sizeof(layout); ++i)
+                      hash = (hash ^ octets[i]) * 1099511628211ULL;
+                  mhash = hash ? hash : 1;
+              }
+              return mhash;
+          }
+
+          virtual bool updateRawAny( base::DataSourceBase::shared_ptr source, CORBA::Any& any) const
+          {
+              typename internal::DataSource<T>::shared_ptr d = internal::DataSource<T>::narrow( source.get() );
+              if ( !d || !d->evaluate() )
+                  return false;
+              typename internal::DataSource<T>::const_reference_t value = d->rvalue();
+              RawSampleHeader header;
+              header.type_hash = getRawTypeHash();
+              header.count = Raw::count(value);
+              header.reserved = 0;
+              CORBA::ULong size = header.count * sizeof(value_type);
+              CRawSample* blob = new CRawSample( sizeof(header) + size );
+              blob->length( sizeof(header) + size );
+              memcpy( blob->get_buffer(), &header, sizeof(header) );
+              if ( size )
+                  memcpy( blob->get_buffer() + sizeof(header), Raw::data(value), size );
+              any <<= blob; // any takes ownership
+              return true;
+          }
+
+          /**
+           * Copies a CRawSample straight into \a target, or uses the
+           * AnyConversion for any other contents of \a any.
+           */
+          virtual bool updateFromAny(const CORBA::Any* any, base::DataSourceBase::shared_ptr target) const
+          {
+              const CRawSample* blob = 0;
+              if ( !(*any >>= blob) )
+                  return CorbaTemplateProtocol<T>::updateFromAny(any, target);
+
+              typename internal::AssignableDataSource<T>::shared_ptr ad = internal::AssignableDataSource<T>::narrow( target.get() );
+              if ( !ad )
+                  return false;
+              RawSampleHeader header;
+              if ( blob->length() < sizeof(header) )
+                  return false;
+              memcpy( &header, blob->get_buffer(), sizeof(header) );
+              if ( header.type_hash != getRawTypeHash() ) {
+                  log(Error) << "Corba: received a raw sample of another type or byte order than "
+                             << internal::DataSourceTypeInfo<T>::getTypeName() << endlog();
+                  return false;
+              }
+              CORBA::ULong size = blob->length() - sizeof(header);
+              if ( size / sizeof(value_type) != header.count || size % sizeof(value_type) != 0 )
+                  return false;
+              void* dest = Raw::resize( ad->set(), header.count );
+              if ( !dest )
+                  return false;
+              if ( size )
+                  memcpy( dest, blob->get_buffer() + sizeof(header), size );
+              ad->updated();
+              return true;
+          }
+      };
+}
+}
+
+#endif
@@ -77,6 +77,22 @@ namespace RTT {
          */
         virtual bool updateFromAny(const CORBA::Any* blob, base::DataSourceBase::shared_ptr target) const = 0;
 
+        /**
+         * Returns the hash which identifies the raw octet layout of this type,
+         * or zero if this transporter does not support raw samples.
+         * Both sides of a connection must return the same non-zero hash
+         * before raw samples are sent.
+         */
+        virtual CORBA::ULongLong getRawTypeHash() const { return 0; }
+
+        /**
+         * Evaluate \a source and update an any which contains the value of
+         * \a source as a CRawSample. The default implementation
+         * falls back to updateAny().
+         */
+        virtual bool updateRawAny( base::DataSourceBase::shared_ptr source, CORBA::Any& any) const
+        { return updateAny(source, any); }
+
 	    /**
 	     * Builds a channel element for remote transport in both directions.
 	     * @param sender The data flow interface which will be sending or receiving this channel.
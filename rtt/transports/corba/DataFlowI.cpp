@@ -54,9 +54,16 @@
 #include "RemotePorts.hpp"
 #include "RemoteConnID.hpp"
 #include <rtt/os/MutexLock.hpp>
+#include <rtt/os/CAS.hpp>
+#include <rtt/os/TimeService.hpp>
 
 #include <iostream>
 
+/**
+ * The number of samples in flight on a oneway data connection.
+ */
+#define ORONUM_CORBA_ONEWAY_WINDOW 64
+
 using namespace std;
 using namespace RTT::corba;
 using namespace RTT::base;
@@ -394,6 +401,7 @@ CChannelElement_ptr CDataFlowInterface_i::buildChannelOutput(
     CRemoteChannelElement_i* this_element =
         transporter->createChannelElement_i(mdf, mpoa, corba_policy.pull);
     this_element->setCDataFlowInterface(this);
+    this_element->setFlowControl(corba_policy);
 
     /*
      * This part is for out-of band (needs to be factored out).
@@ -428,7 +436,13 @@ CChannelElement_ptr CDataFlowInterface_i::buildChannelOutput(
         if ( !corba_policy.pull ) {
             ChannelElementBase::shared_ptr buf = type_info->buildDataStorage(toRTT(corba_policy));
             dynamic_cast<ChannelElementBase*>(this_element)->setOutput(buf);
-            buf->setOutput(end);
+            if ( this_element->isOneway() ) {
+                // grants credit again when the port takes samples.
+                ChannelElementBase::shared_ptr credit = this_element->buildCreditElement();
+                buf->setOutput(credit);
+                credit->setOutput(end);
+            } else
+                buf->setOutput(end);
         } else {
             dynamic_cast<ChannelElementBase*>(this_element)->setOutput(end);
         }
@@ -481,6 +495,7 @@ CChannelElement_ptr CDataFlowInterface_i::buildChannelInput(
     CRemoteChannelElement_i* this_element;
     PortableServer::ServantBase_var servant = this_element = transporter->createChannelElement_i(mdf, mpoa, corba_policy.pull);
     this_element->setCDataFlowInterface(this);
+    this_element->setFlowControl(corba_policy);
 
     // Attach the corba channel element first (so OOB is after corba).
     assert( dynamic_cast<ChannelElementBase*>(this_element) );
@@ -593,8 +608,102 @@ CRemoteChannelElement_i::CRemoteChannelElement_i(RTT::corba::CorbaTypeTransporte
     : transport(transport)
     , mpoa(PortableServer::POA::_duplicate(poa))
     , mdataflow(0)
+    , moneway(false), mwindow(0), mnext(0), mcredit(0), mdropped(0)
+    , mdispatch(Idle), mpending(0), mpending_max(0)
+    , mraw(false), mraw_checked(false)
     { }
 CRemoteChannelElement_i::~CRemoteChannelElement_i() {}
+bool CRemoteChannelElement_i::dispatchPending()
+{
+    while ( true ) {
+        int state = mdispatch;
+        if ( state == Cancelled )
+            return false;
+        mpending.inc();
+        if ( state == Idle && os::CAS(&mdispatch, int(Idle), int(Queued)) )
+            return true;
+        // the worker transfers us again when it is done.
+        if ( state == Running && os::CAS(&mdispatch, int(Running), int(Rerun)) )
+            return false;
+        if ( state == Queued || state == Rerun )
+            return false;
+        mpending.dec();
+    }
+}
+bool CRemoteChannelElement_i::dispatchTransfer()
+{
+    // cancelled while it was queued.
+    if ( !os::CAS(&mdispatch, int(Queued), int(Running)) )
+        return false;
+    int pending = mpending.read();
+    mpending.sub(pending);
+    if ( pending > mpending_max )
+        mpending_max = pending;
+    os::TimeService::nsecs start = os::TimeService::Instance()->getNSecs();
+    transferSamples();
+    mtransfer.record( os::TimeService::Instance()->getNSecs() - start );
+    if ( os::CAS(&mdispatch, int(Running), int(Idle)) )
+        return false;
+    // signalled meanwhile, unless it was cancelled.
+    return os::CAS(&mdispatch, int(Rerun), int(Queued));
+}
+void CRemoteChannelElement_i::dispatchCancel()
+{
+    int state;
+    do {
+        state = mdispatch;
+    } while ( state != Cancelled && !os::CAS(&mdispatch, state, int(Cancelled)) );
+}
+void CRemoteChannelElement_i::resetStatistics()
+{
+    mpending_max = 0;
+    mtransfer.reset();
+}
+void CRemoteChannelElement_i::setFlowControl(CConnPolicy const& policy)
+{
+    moneway = policy.oneway && !policy.pull;
+    if ( !moneway )
+        return;
+    // a buffer can take at most 'size' samples at once.
+    mwindow = policy.type != CData && policy.size > 0 ? policy.size : ORONUM_CORBA_ONEWAY_WINDOW;
+    mnext = 0;
+    mcredit = mwindow;
+    mdropped = 0;
+}
+void CRemoteChannelElement_i::raiseCounter(volatile CORBA::ULong& counter, CORBA::ULong value)
+{
+    CORBA::ULong old = counter;
+    while ( CORBA::Long(value - old) > 0 && !os::CAS(&counter, old, value) )
+        old = counter;
+}
+CORBA::ULong CRemoteChannelElement_i::addDropped(CORBA::ULong count)
+{
+    CORBA::ULong old;
+    do {
+        old = mdropped;
+    } while ( !os::CAS(&mdropped, old, old + count) );
+    return old + count;
+}
+bool CRemoteChannelElement_i::useRawSamples()
+{
+    if ( mraw_checked )
+        return mraw;
+    mraw_checked = true;
+    CORBA::ULongLong hash = transport.getRawTypeHash();
+    if ( hash == 0 || CORBA::is_nil(remote_side.in()) )
+        return mraw;
+    try {
+        mraw = remote_side->getRawTypeHash() == hash;
+    }
+    catch(CORBA::Exception& e) {
+        log(Warning) << "Corba: could not query the raw sample type of the remote side, using any conversion: " << e._name() << endlog();
+    }
+    return mraw;
+}
+CORBA::ULongLong CRemoteChannelElement_i::getRawTypeHash() ACE_THROW_SPEC ((
+	      CORBA::SystemException
+	    ))
+{ return transport.getRawTypeHash(); }
 PortableServer::POA_ptr CRemoteChannelElement_i::_default_POA()
 { return PortableServer::POA::_duplicate(mpoa); }
 void CRemoteChannelElement_i::setRemoteSide(CRemoteChannelElement_ptr remote) ACE_THROW_SPEC ((
@@ -50,6 +50,8 @@
 #include "CorbaTypeTransporter.hpp"
 #include <list>
 #include <rtt/os/Mutex.hpp>
+#include <rtt/os/Atomic.hpp>
+#include "LatencyStatistics.hpp"
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -76,7 +78,83 @@ namespace RTT {
             PortableServer::POA_var mpoa;
             CDataFlowInterface_i* mdataflow;
 
+            /**
+             * True if samples are pushed with writeOneway().
+             */
+            bool moneway;
+            /**
+             * The number of samples a oneway writer may have in flight.
+             */
+            CORBA::ULong mwindow;
+            /**
+             * On the writing side, the sequence number of the next sample sent.
+             * On the reading side, the sequence number of the next sample expected.
+             */
+            CORBA::ULong mnext;
+            /**
+             * The writing side may send samples up to this sequence number.
+             * Only raised with raiseCounter(), since grants may arrive out of order.
+             */
+            volatile CORBA::ULong mcredit;
+            /**
+             * The number of samples the reading side lost or could not store.
+             * Only raised with raiseCounter() or addDropped().
+             */
+            volatile CORBA::ULong mdropped;
+
+            /**
+             * Sets \a counter to \a value, unless \a counter is already
+             * beyond it. Sequence numbers wrap around.
+             */
+            static void raiseCounter(volatile CORBA::ULong& counter, CORBA::ULong value);
+
+            /**
+             * Adds \a count to mdropped.
+             * @return the new total.
+             */
+            CORBA::ULong addDropped(CORBA::ULong count);
+
+            /**
+             * The DispatchState of this channel in the CorbaDispatcher.
+             */
+            volatile int mdispatch;
+            /**
+             * The number of signals since the last transfer started.
+             */
+            os::AtomicInt mpending;
+            /**
+             * The largest value of mpending at the start of a transfer.
+             */
+            int mpending_max;
+            /**
+             * The duration of each transferSamples() call.
+             */
+            LatencyStatistics mtransfer;
+
+            /**
+             * True if the writing side sends CRawSample values, see useRawSamples().
+             */
+            bool mraw;
+            /**
+             * True once mraw has been negotiated with the remote side.
+             */
+            bool mraw_checked;
+
+            /**
+             * Asks the remote side, the first time only, if it decodes the
+             * CRawSample values of our transport.
+             * Must not be called from a real-time thread.
+             */
+            bool useRawSamples();
+
         public:
+            /**
+             * The states of a channel in the CorbaDispatcher. A channel is
+             * queued at most once and transferred by one worker at a time.
+             * A Cancelled channel is never transferred again.
+             */
+            enum DispatchState { Idle, Queued, Running, Rerun, Cancelled };
+
             // standard constructor
             CRemoteChannelElement_i(corba::CorbaTypeTransporter const& transport,
 			  PortableServer::POA_ptr poa);
@@ -90,10 +168,93 @@ namespace RTT {
 
             virtual void transferSamples() = 0;
 
+            /**
+             * Builds the element which the reading side of a oneway
+             * connection puts between its buffer and the output endpoint,
+             * in order to grant credit when the input port takes samples.
+             */
+            virtual RTT::base::ChannelElementBase::shared_ptr buildCreditElement() = 0;
+
             void setCDataFlowInterface(CDataFlowInterface_i* dataflow) {
                 mdataflow = dataflow;
             }
 
+            /**
+             * Sets up oneway writes if \a policy asks for them.
+             * Must be called on both sides of the connection, before
+             * any data is transferred.
+             */
+            void setFlowControl(CConnPolicy const& policy);
+
+            /**
+             * Returns true if this channel pushes data with writeOneway().
+             */
+            bool isOneway() const { return moneway; }
+
+            /**
+             * Returns the number of samples which the reading side of a
+             * oneway connection lost or could not store.
+             */
+            CORBA::ULong getDroppedSamples() const { return mdropped; }
+
+            /**
+             * Returns true if this channel sends its samples as CRawSample values.
+             * Only known after the first transfer.
+             */
+            bool isRaw() const { return mraw; }
+
+            /**
+             * CORBA IDL function.
+             */
+            CORBA::ULongLong getRawTypeHash() ACE_THROW_SPEC ((
+          	      CORBA::SystemException
+          	    ));
+
+            /**
+             * Called by the CorbaDispatcher each time this channel is signalled.
+             * This function is real-time.
+             * @return true if the caller must queue this channel, false if
+             * it is queued or being transferred already.
+             */
+            bool dispatchPending();
+
+            /**
+             * Called by a CorbaDispatcher worker to transfer the samples of a
+             * queued channel and to record how long this took.
+             * @return true if this channel was signalled during the transfer
+             * and must be queued again.
+             */
+            bool dispatchTransfer();
+
+            /**
+             * Called by the CorbaDispatcher when this channel is disconnected.
+             * A queued channel stays in the queue, but the worker which takes
+             * it only releases it. This function is real-time.
+             */
+            void dispatchCancel();
+
+            /**
+             * Returns the number of signals which were not handled by a
+             * transfer yet. One transfer handles all signals before it.
+             */
+            int getPendingSignals() const { return mpending.read(); }
+
+            /**
+             * Returns the largest number of signals which waited for one transfer.
+             */
+            int getPendingSignalsHighWatermark() const { return mpending_max; }
+
+            /**
+             * Returns the statistics of the duration of the transfers to the
+             * remote side, which is dominated by the CORBA calls.
+             */
+            const LatencyStatistics& getTransferStatistics() const { return mtransfer; }
+
+            /**
+             * Resets the queue high watermark and the transfer statistics.
+             */
+            void resetStatistics();
+
             PortableServer::POA_ptr _default_POA();
 
             void setRemoteSide(CRemoteChannelElement_ptr remote) ACE_THROW_SPEC ((
@@ -0,0 +1,95 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 03:19:30 UTC 2026  LatencyStatistics.cpp
+
+                        LatencyStatistics.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "LatencyStatistics.hpp"
+
+namespace RTT {
+    using namespace corba;
+
+    LatencyStatistics::LatencyStatistics()
+        : mcount(0), mlast(0), mmin(0), mmax(0), msum(0), mreset(0)
+    {
+    }
+
+    void LatencyStatistics::record(nsecs duration)
+    {
+        if ( mreset.read() ) {
+            mcount = 0;
+            msum = 0;
+            mreset.set(0);
+        }
+        if ( mcount == 0 || duration < mmin )
+            mmin = duration;
+        if ( mcount == 0 || duration > mmax )
+            mmax = duration;
+        mlast = duration;
+        msum = msum + duration;
+        mcount = mcount + 1;
+    }
+
+    void LatencyStatistics::reset()
+    {
+        mreset.set(1);
+    }
+
+    unsigned long LatencyStatistics::getCount() const
+    {
+        return mreset.read() ? 0 : mcount;
+    }
+
+    nsecs LatencyStatistics::getLast() const
+    {
+        return getCount() ? nsecs(mlast) : 0;
+    }
+
+    nsecs LatencyStatistics::getMin() const
+    {
+        return getCount() ? nsecs(mmin) : 0;
+    }
+
+    nsecs LatencyStatistics::getMean() const
+    {
+        unsigned long count = getCount();
+        return count ? nsecs(msum) / nsecs(count) : 0;
+    }
+
+    nsecs LatencyStatistics::getMax() const
+    {
+        return getCount() ? nsecs(mmax) : 0;
+    }
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 03:19:30 UTC 2026  LatencyStatistics.hpp
+
+                        LatencyStatistics.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef ORO_CORBA_LATENCY_STATISTICS_HPP
+#define ORO_CORBA_LATENCY_STATISTICS_HPP
+
+#include "rtt-corba-config.h"
+#include "../../os/Time.hpp"
+#include "../../os/Atomic.hpp"
+
+namespace RTT {
+    namespace corba {
+        /**
+         * The count, last, minimum, mean and maximum of the durations of
+         * the remote calls of a channel, in nanoseconds. All are zero when
+         * nothing was recorded.
+         *
+         * Durations are recorded by one thread at a time, without locking.
+         * Any thread may read or reset the statistics meanwhile. A read
+         * may be slightly inconsistent while a duration is recorded.
+         */
+        class RTT_CORBA_API LatencyStatistics
+        {
+        public:
+            LatencyStatistics();
+
+            /**
+             * Records the duration of one call.
+             */
+            void record(nsecs duration);
+
+            /**
+             * Clears the statistics. They are emptied by the recording
+             * thread when it records its next duration, and reported as
+             * empty until then.
+             */
+            void reset();
+
+            unsigned long getCount() const;
+            nsecs getLast() const;
+            nsecs getMin() const;
+            nsecs getMean() const;
+            nsecs getMax() const;
+
+        private:
+            LatencyStatistics(const LatencyStatistics&);
+            LatencyStatistics& operator=(const LatencyStatistics&);
+
+            volatile unsigned long mcount;
+            volatile nsecs mlast;
+            volatile nsecs mmin;
+            volatile nsecs mmax;
+            volatile nsecs msum;
+            os::AtomicInt mreset;
+        };
+    }
+}
+
+#endif
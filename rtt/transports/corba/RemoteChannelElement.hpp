@@ -43,11 +43,70 @@
 #include "CorbaTypeTransporter.hpp"
 #include "CorbaDispatcher.hpp"
 #include "ApplicationServer.hpp"
+#include "../../internal/ChannelBufferElement.hpp"
+#include "../../os/CAS.hpp"
+
+/**
+ * The maximum number of samples which a push connection
+ * sends in one writeMany() call.
+ */
+#define ORONUM_CORBA_WRITE_BATCH 64
 
 namespace RTT {
 
     namespace corba {
 
+        template<typename T>
+        class RemoteChannelElement;
+
+        /**
+         * Placed between the buffer and the output endpoint at the reading
+         * side of a oneway connection. Tells the RemoteChannelElement when
+         * the input port takes samples, such that it can grant the writing
+         * side credit again without being asked for it.
+         */
+        template<typename T>
+        class RemoteCreditElement
+            : public base::ChannelElement<T>
+        {
+            boost::intrusive_ptr< RemoteChannelElement<T> > mowner;
+        public:
+            RemoteCreditElement(RemoteChannelElement<T>* owner)
+                : mowner(owner)
+            {}
+
+            FlowStatus read(typename base::ChannelElement<T>::reference_t sample, bool copy_old_data)
+            {
+                FlowStatus fs = base::ChannelElement<T>::read(sample, copy_old_data);
+                if ( fs == NewData )
+                    mowner->samplesConsumed();
+                return fs;
+            }
+
+            size_t readMany(std::vector<typename base::ChannelElement<T>::value_t>& samples, size_t max)
+            {
+                typename base::ChannelElement<T>::shared_ptr input = this->getInput();
+                size_t count = input ? input->readMany(samples, max) : 0;
+                if ( count )
+                    mowner->samplesConsumed();
+                return count;
+            }
+
+            FlowStatus readShared(boost::shared_ptr<const T>& sample, bool copy_old_data)
+            {
+                typename base::ChannelElement<T>::shared_ptr input = this->getInput();
+                FlowStatus fs = input ? input->readShared(sample, copy_old_data) : NoData;
+                if ( fs == NewData )
+                    mowner->samplesConsumed();
+                return fs;
+            }
+
+            virtual std::string getElementName() const
+            {
+                return "CorbaRemoteCreditElement";
+            }
+        };
+
 	/**
 	 * Implements the CRemoteChannelElement of the CORBA IDL interface.
 	 * It converts the C++ calls into CORBA calls and vice versa.
@@ -72,6 +131,23 @@ namespace RTT {
 
 	    DataFlowInterface* msender;
 
+            /**
+             * At the reading side of a oneway connection, the buffer
+             * which the samples are written to, or zero for a data
+             * connection.
+             */
+            internal::ChannelBufferElementBase* mbuffer;
+            /**
+             * True at the reading side of a oneway connection, where
+             * transferSamples() grants credit instead of sending samples.
+             */
+            bool mgranting;
+            /**
+             * Set to 1 when the last grant was less than the buffer
+             * size, such that the writing side may be waiting for more.
+             */
+            volatile int mshort;
+
             PortableServer::ObjectId_var oid;
 
             std::string localUri;
@@ -84,7 +160,7 @@ namespace RTT {
 	    RemoteChannelElement(CorbaTypeTransporter const& transport, DataFlowInterface* sender, PortableServer::POA_ptr poa, bool is_pull)
         : CRemoteChannelElement_i(transport, poa)
         , valid(true), pull(is_pull)
-        , msender(sender)
+        , msender(sender), mbuffer(0), mgranting(false), mshort(0)
             {
                 // Big note about cleanup: The RTT will dispose this object through
 	            // the ChannelElement<T> refcounting. So we only need to inform the
@@ -137,9 +213,16 @@ namespace RTT {
             virtual void transferSamples() {
                 if (!valid)
                     return;
+                if ( mgranting ) {
+                    // the input port took samples after a short grant.
+                    grantCredit();
+                    return;
+                }
                 //log(Debug) <<"transfering..." <<endlog();
                 // in push mode, transfer all data, in pull mode, only signal once for each sample.
                 if ( pull ) {
+                    // negotiate raw samples here, not in our read() servant.
+                    this->useRawSamples();
                     try
                     { remote_side->remoteSignal(); }
 #ifdef CORBA_IS_OMNIORB
@@ -154,10 +237,11 @@ namespace RTT {
                         log(Error) << "caught CORBA exception while signalling our remote endpoint: " << e._name() << endlog();
                         valid = false;
                     }
-                } else {
+                } else if ( this->getOutput() ) {
                     /** This is used on to read the channel */
                     typename base::ChannelElement<T>::value_t sample;
 
+                    // an out-of-band transport takes the samples one by one.
                     //log(Debug) <<"...read..."<<endlog();
                     while ( this->read(sample, false) == NewData && valid) {
                         //log(Debug) <<"...write..."<<endlog();
@@ -165,6 +249,55 @@ namespace RTT {
                             valid = false;
                         //log(Debug) <<"...next read?..."<<endlog();
                     }
+                } else if ( moneway ) {
+                    // send no more samples than the reader granted credit
+                    // for. The others stay buffered until the reader frees
+                    // room in its buffer and sends remoteCredit().
+                    typename base::ChannelElement<T>::value_t sample;
+                    CAnySequence samples;
+                    bool raw = this->useRawSamples();
+                    CORBA::Long credit;
+                    while ( valid && (credit = CORBA::Long(mcredit - mnext)) > 0 ) {
+                        CORBA::ULong max = credit < ORONUM_CORBA_WRITE_BATCH ? credit : ORONUM_CORBA_WRITE_BATCH;
+                        samples.length(max);
+                        CORBA::ULong count = 0;
+                        // a two-way read() of the remote side would defeat oneway writes.
+                        while ( count != max && base::ChannelElement<T>::read(sample, false) == NewData ) {
+                            this->marshal(sample, samples[count], raw);
+                            ++count;
+                        }
+                        if ( count == 0 )
+                            break;
+                        samples.length(count);
+                        CORBA::ULong sequence = mnext;
+                        mnext += count;
+                        if ( this->sendOneway(samples, sequence) == false )
+                            valid = false;
+                        if ( count != max )
+                            break;
+                    }
+                } else {
+                    // send the buffered samples in batches, instead of
+                    // doing a round-trip for each sample.
+                    typename base::ChannelElement<T>::value_t sample;
+                    CAnySequence samples;
+                    bool raw = this->useRawSamples();
+                    CORBA::ULong count = ORONUM_CORBA_WRITE_BATCH;
+                    while ( count == ORONUM_CORBA_WRITE_BATCH && valid ) {
+                        samples.length(ORONUM_CORBA_WRITE_BATCH);
+                        count = 0;
+                        // only take local samples: our read() would ask the
+                        // remote side once the buffer is empty.
+                        while ( count != ORONUM_CORBA_WRITE_BATCH && base::ChannelElement<T>::read(sample, false) == NewData ) {
+                            this->marshal(sample, samples[count], raw);
+                            ++count;
+                        }
+                        if ( count == 0 )
+                            break;
+                        samples.length(count);
+                        if ( this->sendSamples(samples) == false )
+                            valid = false;
+                    }
                 }
                 //log(Debug) <<"... done." <<endlog();
 
@@ -198,6 +331,9 @@ namespace RTT {
                 // an oob channel may be sitting at our other end. If not, this is a nop.
                 base::ChannelElement<T>::disconnect(!writer_to_reader);
 
+                // no more transfers once disconnected.
+                CorbaDispatcher::Instance(msender)->cancelChannel( this );
+
                 // Will fail at shutdown if all objects are already deactivated
                 try {
                     if (mdataflow)
@@ -222,6 +358,9 @@ namespace RTT {
 
                 base::ChannelElement<T>::disconnect(writer_to_reader);
 
+                // no more transfers once disconnected.
+                CorbaDispatcher::Instance(msender)->cancelChannel( this );
+
                 // Will fail at shutdown if all objects are already deactivated
                 try {
                     if (mdataflow)
@@ -287,6 +426,13 @@ namespace RTT {
                 value_data_source.ref();
                 fs = base::ChannelElement<T>::read(value_data_source.set(), copy_old_data);
                 if (fs == NewData || (fs == OldData && copy_old_data)) {
+                    if ( mraw ) {
+                        CORBA::Any_var any = new CORBA::Any();
+                        if ( transport.updateRawAny(&value_data_source, any.inout()) ) {
+                            sample = any._retn();
+                            return (CFlowStatus)fs;
+                        }
+                    }
                     sample = transport.createAny(&value_data_source);
                     if ( sample != 0) {
                         return (CFlowStatus)fs;
@@ -349,6 +495,202 @@ namespace RTT {
                 return base::ChannelElement<T>::write(value_data_source.rvalue());
             }
 
+            /**
+             * Stores \a sample in \a any, as a CRawSample if \a raw is true.
+             */
+            void marshal(typename base::ChannelElement<T>::param_t sample, CORBA::Any& any, bool raw)
+            {
+                internal::LateConstReferenceDataSource<T> const_ref_data_source(&sample);
+                const_ref_data_source.ref();
+                if ( raw )
+                    transport.updateRawAny(&const_ref_data_source, any);
+                else
+                    transport.updateAny(&const_ref_data_source, any);
+            }
+
+            /**
+             * Sends a batch of samples to the remote side.
+             * @return false if the samples could not be marshalled.
+             */
+            bool sendSamples(CAnySequence const& samples)
+            {
+                assert( remote_side.in() != 0 && "Got sendSamples() without remote side.");
+                try
+                {
+                    remote_side->writeMany(samples);
+                    return true;
+                }
+#ifdef CORBA_IS_OMNIORB
+                catch(CORBA::SystemException& e)
+                {
+                    log(Error) << "caught CORBA exception while marshalling: " << e._name() << " " << e.NP_minorString() << endlog();
+                    return false;
+                }
+#endif
+                catch(CORBA::Exception& e)
+                {
+                    log(Error) << "caught CORBA exception while marshalling: " << e._name() << endlog();
+                    return false;
+                }
+            }
+
+            /**
+             * Sends a batch of samples to the remote side without waiting for it.
+             * @return false if the samples could not be marshalled.
+             */
+            bool sendOneway(CAnySequence const& samples, CORBA::ULong sequence)
+            {
+                assert( remote_side.in() != 0 && "Got sendOneway() without remote side.");
+                try
+                {
+                    remote_side->writeOneway(samples, sequence);
+                    return true;
+                }
+#ifdef CORBA_IS_OMNIORB
+                catch(CORBA::SystemException& e)
+                {
+                    log(Error) << "caught CORBA exception while marshalling: " << e._name() << " " << e.NP_minorString() << endlog();
+                    return false;
+                }
+#endif
+                catch(CORBA::Exception& e)
+                {
+                    log(Error) << "caught CORBA exception while marshalling: " << e._name() << endlog();
+                    return false;
+                }
+            }
+
+            /**
+             * On the reading side of a oneway connection, returns the
+             * sequence number up to which the writing side may send:
+             * the samples received so far plus the free slots of the
+             * buffer they are written to.
+             */
+            CORBA::ULong creditLimit()
+            {
+                // read mnext first: samples which arrive meanwhile
+                // only make the grant smaller.
+                CORBA::ULong next = mnext;
+                base::ChannelElementBase::shared_ptr output = this->getOutput();
+                internal::ChannelBufferElementBase* buffer = dynamic_cast<internal::ChannelBufferElementBase*>( output.get() );
+                // a data element always takes the next sample.
+                if ( !buffer )
+                    return next + mwindow;
+                size_t size = buffer->getBufferSize();
+                size_t fill = buffer->getBufferFillSize();
+                return next + CORBA::ULong( fill < size ? size - fill : 0 );
+            }
+
+            /**
+             * Sends the writing side the credit of creditLimit(), and
+             * remembers if it was less than a full buffer.
+             */
+            void grantCredit()
+            {
+                if ( CORBA::is_nil(remote_side.in()) )
+                    return;
+                // mark the grant short before reading the fill level, such
+                // that samplesConsumed() sees the mark for every sample
+                // taken after that.
+                if ( mbuffer )
+                    os::CAS(&mshort, 0, 1);
+                CORBA::ULong limit = creditLimit();
+                if ( mbuffer && limit - mnext >= CORBA::ULong(mbuffer->getBufferSize()) )
+                    os::CAS(&mshort, 1, 0);
+                try
+                { remote_side->remoteCredit(limit, mdropped); }
+                catch(CORBA::Exception& e)
+                {
+                    log(Error) << "caught CORBA exception while granting credit to our remote endpoint: " << e._name() << endlog();
+                }
+            }
+
+            /**
+             * Builds the element which the reading side of a oneway
+             * connection puts between its buffer and the output endpoint,
+             * see RemoteCreditElement. Must be called after the buffer
+             * was set as the output of this element.
+             */
+            base::ChannelElementBase::shared_ptr buildCreditElement()
+            {
+                mbuffer = dynamic_cast<internal::ChannelBufferElementBase*>( this->getOutput().get() );
+                mgranting = true;
+                return new RemoteCreditElement<T>(this);
+            }
+
+            /**
+             * Called by the RemoteCreditElement in the thread of the input
+             * port, each time it took samples. Once at least half of the
+             * buffer is free after a short grant, the CorbaDispatcher
+             * grants the writing side the free room.
+             */
+            void samplesConsumed()
+            {
+                if ( !mshort || !mbuffer )
+                    return;
+                if ( mbuffer->getBufferFillSize() > mbuffer->getBufferSize() / 2 )
+                    return;
+                if ( os::CAS(&mshort, 1, 0) )
+                    CorbaDispatcher::Instance(msender)->dispatchChannel( this );
+            }
+
+            /**
+             * CORBA IDL function.
+             */
+            void writeOneway(const ::RTT::corba::CAnySequence& samples, CORBA::ULong sequence) ACE_THROW_SPEC ((
+          	      CORBA::SystemException
+          	    ))
+            {
+                CORBA::ULong dropped = 0;
+                // samples between the previous batch and this one never arrived.
+                if ( CORBA::Long(sequence - mnext) > 0 )
+                    dropped += sequence - mnext;
+                typename internal::ValueDataSource<T> value_data_source;
+                value_data_source.ref();
+                for (CORBA::ULong i = 0; i != samples.length(); ++i) {
+                    transport.updateFromAny(&samples[i], &value_data_source);
+                    if ( !base::ChannelElement<T>::write(value_data_source.rvalue()) )
+                        ++dropped;
+                }
+                mnext = sequence + samples.length();
+                if ( dropped ) {
+                    CORBA::ULong total = addDropped(dropped);
+                    log(Warning) << "Dropped " << dropped << " samples of a oneway connection, "
+                                 << total << " in total." << endlog();
+                }
+                grantCredit();
+            }
+
+            /**
+             * CORBA IDL function.
+             */
+            void remoteCredit(CORBA::ULong limit, CORBA::ULong dropped) ACE_THROW_SPEC ((
+          	      CORBA::SystemException
+          	    ))
+            {
+                raiseCounter(mdropped, dropped);
+                raiseCounter(mcredit, limit);
+                // send what was kept back for lack of credit.
+                CorbaDispatcher::Instance(msender)->dispatchChannel( this );
+            }
+
+            /**
+             * CORBA IDL function.
+             */
+            CORBA::Boolean writeMany(const ::RTT::corba::CAnySequence& samples) ACE_THROW_SPEC ((
+          	      CORBA::SystemException
+          	    ))
+            {
+                typename internal::ValueDataSource<T> value_data_source;
+                value_data_source.ref();
+                bool result = true;
+                for (CORBA::ULong i = 0; i != samples.length(); ++i) {
+                    transport.updateFromAny(&samples[i], &value_data_source);
+                    result = base::ChannelElement<T>::write(value_data_source.rvalue()) && result;
+                }
+                return result;
+            }
+
             virtual bool data_sample(typename base::ChannelElement<T>::param_t sample)
             {
                 // we don't pass it on through CORBA (yet).
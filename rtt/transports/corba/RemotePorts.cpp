@@ -145,6 +145,7 @@ RTT::base::ChannelElementBase::shared_ptr RemoteInputPort::buildRemoteChannelOut
     CRemoteChannelElement_i*  local =
         static_cast<CorbaTypeTransporter*>(type->getProtocol(ORO_CORBA_PROTOCOL_ID))
                             ->createChannelElement_i(output_port.getInterface(), mpoa, policy.pull);
+    local->setFlowControl( toCORBA(policy) );
 
     CRemoteChannelElement_var proxy = local->_this();
     local->setRemoteSide(remote);
@@ -42,8 +42,20 @@
 #include "../../base/ChannelElementBase.hpp"
 #include "../../Logger.hpp"
 #include <map>
-#include <sys/select.h>
 #include <mqueue.h>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) && !defined(OROPKG_OS_XENOMAI)
+// On Linux, a mqd_t is a file descriptor which can be monitored with epoll.
+#define ORO_MQ_DISPATCHER_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <stdint.h>
+#else
+#include <sys/select.h>
+#endif
 
 namespace RTT { namespace mqueue { class Dispatcher; } }
 
@@ -58,6 +70,12 @@ namespace RTT {
          * received new data.
          * Reasonably, there should be one dispatcher for each
          * peer component sending us data.
+         *
+         * On Linux, the queues are registered once in an epoll set
+         * when they are added, and the thread sleeps until one of
+         * them becomes readable or until an eventfd wakes it up to
+         * stop. Other targets rebuild an fd_set and poll it with
+         * select().
          */
         class Dispatcher : public Activity
         {
@@ -69,14 +87,63 @@ namespace RTT {
             typedef std::map<mqd_t,base::ChannelElementBase*> MQMap;
             MQMap mqmap;
 
+#ifdef ORO_MQ_DISPATCHER_EPOLL
+            enum { MAX_EVENTS = 64 };
+
+            int epfd;            /* The epoll set in which all queues are registered */
+
+            int evfd;            /* eventfd that wakes up loop() when it must quit */
+#else
             fd_set socks;        /* Socket file descriptors we want to wake up for, using select() */
 
             int highsock;        /* Highest #'d file descriptor, needed for select() */
+#endif
 
             bool do_exit;
 
             os::Mutex maplock;
 
+#ifdef ORO_MQ_DISPATCHER_EPOLL
+            Dispatcher( const std::string& name)
+            : Activity(ORO_SCHED_RT, os::HighestPriority, 0.0, 0, name),
+              epfd( epoll_create1(EPOLL_CLOEXEC) ), evfd( eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) ),
+              do_exit(false)
+            {
+                Logger::In in("Dispatcher");
+                struct epoll_event ev;
+                ev.events = EPOLLIN;
+                ev.data.fd = evfd;
+                if ( epfd < 0 || evfd < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, evfd, &ev) != 0 )
+                    log(Error) <<"Dispatcher could not set up epoll: "<<strerror(errno)<<endlog();
+            }
+
+            ~Dispatcher() {
+                Logger::In in("Dispatcher");
+                log(Info) << "Dispacher cleans up: no more work."<<endlog();
+                stop();
+                if ( evfd >= 0 )
+                    close(evfd);
+                if ( epfd >= 0 )
+                    close(epfd);
+                DispatchI = 0;
+            }
+
+            void read_events(struct epoll_event* events, int count) {
+                os::MutexLock lock(maplock);
+                for (int i = 0; i != count; ++i) {
+                    if ( events[i].data.fd == evfd ) {
+                        uint64_t value;
+                        if ( read(evfd, &value, sizeof(value)) < 0 && errno != EAGAIN )
+                            log(Error) <<"Dispatcher failed to read its eventfd: "<<strerror(errno)<<endlog();
+                        continue;
+                    }
+                    // The queue may have been removed since epoll_wait() returned.
+                    MQMap::iterator it = mqmap.find( events[i].data.fd );
+                    if ( it != mqmap.end() )
+                        it->second->signal();
+                }
+            }
+#else
             Dispatcher( const std::string& name)
             : Activity(ORO_SCHED_RT, os::HighestPriority, 0.0, 0, name),
               highsock(0), do_exit(false)
@@ -127,6 +194,7 @@ namespace RTT {
                     }
                 }
             }
+#endif
 
         public:
             typedef boost::intrusive_ptr<Dispatcher> shared_ptr;
@@ -148,8 +216,19 @@ namespace RTT {
                 log(Debug) <<"Dispatcher is monitoring mqdes "<< mqdes <<endlog();
                 os::MutexLock lock(maplock);
                 // we add a refcount per channel we monitor.
-                if (mqmap.count(mqdes) == 0)
+                if (mqmap.count(mqdes) == 0) {
+#ifdef ORO_MQ_DISPATCHER_EPOLL
+                    // A running epoll_wait() picks up the new queue by itself.
+                    struct epoll_event ev;
+                    ev.events = EPOLLIN;
+                    ev.data.fd = mqdes;
+                    if ( epoll_ctl(epfd, EPOLL_CTL_ADD, mqdes, &ev) != 0 ) {
+                        log(Error) <<"Dispatcher can not monitor mqdes "<< mqdes <<": "<<strerror(errno)<<endlog();
+                        return;
+                    }
+#endif
                     refcount.inc();
+                }
                 mqmap[mqdes] = chan;
             }
 
@@ -159,6 +238,9 @@ namespace RTT {
                 os::MutexLock lock(maplock);
                 if (mqmap.count(mqdes)) {
                     mqmap.erase( mqmap.find(mqdes) );
+#ifdef ORO_MQ_DISPATCHER_EPOLL
+                    epoll_ctl(epfd, EPOLL_CTL_DEL, mqdes, 0);
+#endif
                     refcount.dec();
                 }
             }
@@ -168,6 +250,29 @@ namespace RTT {
                 return true;
             }
 
+#ifdef ORO_MQ_DISPATCHER_EPOLL
+            void loop() {
+                struct epoll_event events[MAX_EVENTS];
+                while ( !do_exit ) {
+                    // No timeout: breakLoop() wakes us up through evfd.
+                    int count = epoll_wait(epfd, events, MAX_EVENTS, -1);
+                    if (count < 0) {
+                        if (errno != EINTR)
+                        {
+                            log(Error) <<"Dispatcher failed to wait on message queues. Stopped thread. error: "<<strerror(errno)<<endlog();
+                            return;
+                        }
+                    } else
+                        read_events(events, count);
+                }
+            }
+
+            bool breakLoop() {
+                do_exit = true;
+                uint64_t one = 1;
+                return write(evfd, &one, sizeof(one)) == sizeof(one);
+            }
+#else
             void loop() {
                 struct timeval timeout;  /* Timeout for select */
                 int readsocks;       /* Number of sockets ready for reading */
@@ -212,6 +317,7 @@ namespace RTT {
                 do_exit = true;
                 return true;
             }
+#endif
         };
     }
 }
@@ -49,28 +49,39 @@ using namespace RTT::detail;
 
 namespace RTT {
     namespace mqueue {
+        /**
+         * Registers protocol \a P for both the message queue and the
+         * shared memory transport, which share their marshalling.
+         */
+        template<class P>
+        static bool addProtocols(TypeInfo* ti)
+        {
+            return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new P() )
+                && ti->addProtocol(ORO_SHM_PROTOCOL_ID, new P() );
+        }
+
         bool MQLibPlugin::registerTransport(std::string name, TypeInfo* ti)
         {
             if ( name == "int" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<int>() );
+                return addProtocols< MQTemplateProtocol<int> >(ti);
             if ( name == "double" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<double>() );
+                return addProtocols< MQTemplateProtocol<double> >(ti);
             //if ( name == "string" )
             //    return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<std::string>() );
             if ( name == "float" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<float>() );
+                return addProtocols< MQTemplateProtocol<float> >(ti);
             if ( name == "uint" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<unsigned int>() );
+                return addProtocols< MQTemplateProtocol<unsigned int> >(ti);
             if ( name == "char" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<char>() );
+                return addProtocols< MQTemplateProtocol<char> >(ti);
             //if ( name == "long" )
             //    return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<long>() );
             //if ( name == "PropertyBag" )
             //    return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<PropertyBag>() );
             if ( name == "bool" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQTemplateProtocol<bool>() );
+                return addProtocols< MQTemplateProtocol<bool> >(ti);
             if ( name == "array" )
-                return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQSerializationProtocol< std::vector<double> >() );
+                return addProtocols< MQSerializationProtocol< std::vector<double> > >(ti);
             //if ( name == "void" )
             //    return ti->addProtocol(ORO_MQUEUE_PROTOCOL_ID, new MQFallBackProtocol(false)); // warn=false
             return false;
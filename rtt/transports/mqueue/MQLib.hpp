@@ -55,4 +55,9 @@ namespace RTT {
 }
 
 #define ORO_MQUEUE_PROTOCOL_ID 2
+/**
+ * Selects a shared memory ring instead of a message queue in the ConnPolicy.
+ * It uses the same type protocols as ORO_MQUEUE_PROTOCOL_ID.
+ */
+#define ORO_SHM_PROTOCOL_ID 4
 #endif
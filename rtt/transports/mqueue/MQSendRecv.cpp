@@ -48,6 +48,8 @@
 #include <boost/algorithm/string.hpp>
 
 #include "MQSendRecv.hpp"
+#include "MQLib.hpp"
+#include "ShmRing.hpp"
 #include "../../types/TypeTransporter.hpp"
 #include "../../types/TypeMarshaller.hpp"
 #include "../../Logger.hpp"
@@ -62,7 +64,8 @@ using namespace RTT::mqueue;
 
 
 MQSendRecv::MQSendRecv(types::TypeMarshaller const& transport) :
-    mtransport(transport), marshaller_cookie(0), buf(0), mis_sender(false), minit_done(false), max_size(0), mdata_size(0)
+    mtransport(transport), marshaller_cookie(0), mqdes(-1), buf(0), mis_sender(false), minit_done(false), max_size(0), mdata_size(0),
+    mring(0), mreceiver(0)
 {
 }
 
@@ -88,6 +91,27 @@ void MQSendRecv::setupStream(base::DataSourceBase::shared_ptr ds, base::PortInte
         policy.name_id = "/" + name;
     }
 
+    if (policy.transport == ORO_SHM_PROTOCOL_ID)
+    {
+        if (policy.name_id[0] != '/')
+            throw std::runtime_error("Could not open shared memory with wrong name. Names must start with '/' and contain no more '/' after the first one.");
+        if (max_size <= 0)
+            throw std::runtime_error("Could not open shared memory with zero message size.");
+        mring = new ShmRing();
+        if ( !mring->open(policy.name_id, policy.size ? policy.size : 10, max_size) )
+        {
+            delete mring;
+            mring = 0;
+            throw std::runtime_error("Could not open shared memory ring.");
+        }
+        // the other side may have created the ring with another slot size.
+        max_size = mring->slotSize();
+        buf = new char[max_size];
+        memset(buf, 0, max_size); // necessary to trick valgrind
+        mqname = policy.name_id;
+        return;
+    }
+
     struct mq_attr mattr;
     mattr.mq_maxmsg = policy.size ? policy.size : 10;
     mattr.mq_msgsize = max_size;
@@ -154,25 +178,45 @@ MQSendRecv::~MQSendRecv()
 {
     if ( mqdes > 0)
         mq_close(mqdes);
+    delete mreceiver;
+    delete mring;
 }
 
 void MQSendRecv::cleanupStream()
 {
-    if (!mis_sender)
+    if (mring)
     {
-        if (minit_done)
+        if (mreceiver)
         {
-            Dispatcher::Instance()->removeQueue(mqdes);
-            minit_done = false;
+            mreceiver->stop();
+            delete mreceiver;
+            mreceiver = 0;
         }
+        minit_done = false;
+        // sender unlinks to avoid future re-use of new readers.
+        mring->close(mis_sender);
+        delete mring;
+        mring = 0;
     }
     else
     {
-        // sender unlinks to avoid future re-use of new readers.
-        mq_unlink(mqname.c_str());
+        if (!mis_sender)
+        {
+            if (minit_done)
+            {
+                Dispatcher::Instance()->removeQueue(mqdes);
+                minit_done = false;
+            }
+        }
+        else
+        {
+            // sender unlinks to avoid future re-use of new readers.
+            mq_unlink(mqname.c_str());
+        }
+        // both sender and receiver close their end.
+        mq_close( mqdes);
+        mqdes = -1;
     }
-    // both sender and receiver close their end.
-    mq_close( mqdes);
 
     if (marshaller_cookie)
         mtransport.deleteCookie(marshaller_cookie);
@@ -187,8 +231,9 @@ void MQSendRecv::cleanupStream()
 
 void MQSendRecv::mqNewSample(RTT::base::DataSourceBase::shared_ptr ds)
 {
-    // only deduce if user did not specify it explicitly:
-    if (mdata_size == 0)
+    // only deduce if user did not specify it explicitly. The slots of
+    // a ring have a fixed size.
+    if (mdata_size == 0 && !mring)
         max_size = mtransport.getSampleSize(ds);
     delete[] buf;
     buf = new char[max_size];
@@ -206,6 +251,27 @@ bool MQSendRecv::mqReady(base::DataSourceBase::shared_ptr ds, base::ChannelEleme
         //
         // The output port implementation guarantees that there will be one
         // after the connection is ready
+        if (mring)
+        {
+            int length = 0;
+            const char* slot = mring->waitForData(0.5) ? mring->readSlot(length) : 0;
+            if (!slot)
+            {
+                log(Error) << "Failed to receive initial data sample for shm Channel Element." << endlog();
+                return false;
+            }
+            bool ok = mtransport.updateFromBlob((void*) slot, length, ds, marshaller_cookie);
+            mring->commitRead();
+            if (!ok)
+            {
+                log(Error) << "Failed to initialize shm Channel Element with initial data sample." << endlog();
+                return false;
+            }
+            minit_done = true;
+            mreceiver = new ShmReceiver(*mring, chan);
+            mreceiver->start();
+            return true;
+        }
         struct timespec abs_timeout;
         clock_gettime(CLOCK_REALTIME, &abs_timeout);
         abs_timeout.tv_nsec += Seconds_to_nsecs(0.5);
@@ -246,6 +312,16 @@ bool MQSendRecv::mqReady(base::DataSourceBase::shared_ptr ds, base::ChannelEleme
 bool MQSendRecv::mqRead(RTT::base::DataSourceBase::shared_ptr ds)
 {
     int bytes = 0;
+    if (mring)
+    {
+        // decode in place, the slot is only freed afterwards.
+        const char* slot = mring->readSlot(bytes);
+        if (!slot)
+            return false;
+        bool ok = mtransport.updateFromBlob((void*) slot, bytes, ds, marshaller_cookie);
+        mring->commitRead();
+        return ok;
+    }
     if ((bytes = mq_receive(mqdes, buf, max_size, 0)) == -1)
     {
         //log(Debug) << "Tried read on empty mq!" <<endlog();
@@ -260,6 +336,25 @@ bool MQSendRecv::mqRead(RTT::base::DataSourceBase::shared_ptr ds)
 
 bool MQSendRecv::mqWrite(RTT::base::DataSourceBase::shared_ptr ds)
 {
+    if (mring)
+    {
+        char* slot = mring->writeSlot();
+        // a full ring drops the sample, like a full message queue does.
+        if (slot == 0)
+            return true;
+        // marshal straight into the slot. Types that are their own blob
+        // return a pointer to the sample instead, which we copy once.
+        std::pair<void const*, int> blob = mtransport.fillBlob(ds, slot, max_size, marshaller_cookie);
+        if (blob.first == 0 || blob.second > max_size)
+        {
+            log(Error) << "ShmChannel: failed to marshal sample" << endlog();
+            return false;
+        }
+        if (blob.first != slot)
+            memcpy(slot, blob.first, blob.second);
+        mring->commitWrite(blob.second);
+        return true;
+    }
     std::pair<void const*, int> blob = mtransport.fillBlob(ds, buf, max_size, marshaller_cookie);
     if (blob.first == 0)
     {
@@ -47,9 +47,17 @@ namespace RTT
 {
     namespace mqueue
     {
+        class ShmRing;
+        class ShmReceiver;
+
         /**
          * Implements the sending/receiving of mqueue messages.
          * It can only be OR sender OR receiver (logical XOR).
+         *
+         * If the ConnPolicy selects the ORO_SHM_PROTOCOL_ID transport,
+         * the samples are exchanged through a ShmRing instead of a
+         * message queue. They are then marshalled into and decoded from
+         * the shared memory directly, without going through buf.
          */
         class MQSendRecv
         {
@@ -100,6 +108,15 @@ namespace RTT
              * that size was zero.
              */
             int mdata_size;
+            /**
+             * The shared memory ring, if the shm transport is used instead
+             * of a message queue.
+             */
+            ShmRing* mring;
+            /**
+             * The thread that forwards samples from mring, on the reading side.
+             */
+            ShmReceiver* mreceiver;
 
         public:
             /**
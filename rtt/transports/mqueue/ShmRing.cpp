@@ -0,0 +1,342 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 01:41:25 UTC 2026  ShmRing.cpp
+
+                        ShmRing.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "ShmRing.hpp"
+#include "../../base/BufferLockFreeSPSC.hpp"
+#include "../../os/oro_arch.h"
+#include "../../Logger.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace RTT;
+using namespace RTT::mqueue;
+using RTT::base::detail::spsc_load;
+using RTT::base::detail::spsc_store;
+
+namespace {
+    enum { CACHE_LINE_SIZE = 64, SLOT_HEADER = 8, MAGIC = 0x4f524f53 };
+
+    /** Time to wait for the other side to initialize a ring it just created. */
+    const int INIT_TIMEOUT_MS = 500;
+
+    int align(int size, int to) { return (size + to - 1) / to * to; }
+
+    typedef ShmRing::Index Index;
+
+    /** Loads an index written by the other side, with acquire semantics. */
+    inline Index index_load(const volatile Index* value) {
+#if defined(__ATOMIC_ACQUIRE)
+        return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#else
+        return oro_cmpxchg(const_cast<volatile Index*>(value), 0, 0);
+#endif
+    }
+
+    /** Publishes our own index, with release semantics. */
+    inline void index_store(volatile Index* value, Index v) {
+#if defined(__ATOMIC_RELEASE)
+        __atomic_store_n(value, v, __ATOMIC_RELEASE);
+#else
+        Index old = *value;
+        while ( oro_cmpxchg(value, old, v) != old )
+            old = *value;
+#endif
+    }
+
+#ifdef __linux__
+    // Not FUTEX_PRIVATE: the futex word is shared between processes.
+    void futex_wait(volatile int* addr, int value, const struct timespec* rel_timeout) {
+        syscall(SYS_futex, addr, FUTEX_WAIT, value, rel_timeout, 0, 0);
+    }
+    void futex_wake(volatile int* addr) {
+        syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, 0, 0, 0);
+    }
+#else
+    // Without futexes, the reader polls.
+    void futex_wait(volatile int* addr, int value, const struct timespec* rel_timeout) {
+        struct timespec ts = { 0, 1000000 };
+        if ( *addr == value )
+            nanosleep(&ts, 0);
+    }
+    void futex_wake(volatile int*) {}
+#endif
+}
+
+/**
+ * The layout of the shared segment. The slots follow the header,
+ * each one starting with the length of its contents.
+ */
+struct ShmRing::Header
+{
+    volatile int magic;
+    int slots;
+    int slot_size;
+    char pad0[CACHE_LINE_SIZE - 3 * sizeof(int)];
+    /// Number of slots written modulo 2^32, only modified by the writer.
+    volatile Index write_index;
+    char pad1[CACHE_LINE_SIZE - sizeof(Index)];
+    /// Number of slots read modulo 2^32, only modified by the reader.
+    volatile Index read_index;
+    /// Non-zero while the reader sleeps on this futex.
+    volatile int reader_waiting;
+    char pad2[CACHE_LINE_SIZE - sizeof(Index) - sizeof(int)];
+};
+
+ShmRing::ShmRing()
+    : mheader(0), mlength(0), mstride(0)
+{
+}
+
+ShmRing::~ShmRing()
+{
+    close(false);
+}
+
+bool ShmRing::open(const std::string& name, int slots, int slot_size)
+{
+    Logger::In in("ShmRing");
+    close(false);
+
+    // The indices wrap around at 2^32, which is a multiple of the
+    // number of slots only if that is a power of two.
+    if ( slots <= 0 || slots > (1 << 30) ) {
+        log(Error) << "Invalid number of slots for shared memory '" << name << "': " << slots << endlog();
+        return false;
+    }
+    int rounded = 1;
+    while ( rounded < slots )
+        rounded <<= 1;
+    slots = rounded;
+
+    bool creator = true;
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IREAD | S_IWRITE);
+    if ( fd < 0 && errno == EEXIST ) {
+        creator = false;
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if ( fd < 0 ) {
+        log(Error) << "FAILED opening shared memory '" << name << "': " << strerror(errno) << endlog();
+        return false;
+    }
+
+    size_t length = 0;
+    if ( creator ) {
+        length = sizeof(Header) + size_t(slots) * align(SLOT_HEADER + slot_size, SLOT_HEADER);
+        if ( ftruncate(fd, length) != 0 ) {
+            log(Error) << "Could not size shared memory '" << name << "' to " << length << " bytes: " << strerror(errno) << endlog();
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+    } else {
+        // The creator may still be sizing the segment.
+        struct stat st;
+        int waited = 0;
+        while ( fstat(fd, &st) == 0 && size_t(st.st_size) < sizeof(Header) && waited++ != INIT_TIMEOUT_MS )
+            usleep(1000);
+        length = st.st_size;
+    }
+    if ( length < sizeof(Header) ) {
+        log(Error) << "Shared memory '" << name << "' was not initialized by its creator." << endlog();
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if ( addr == MAP_FAILED ) {
+        log(Error) << "Could not map shared memory '" << name << "': " << strerror(errno) << endlog();
+        if ( creator )
+            shm_unlink(name.c_str());
+        return false;
+    }
+    mheader = static_cast<Header*>(addr);
+    mlength = length;
+    mname = name;
+
+    if ( creator ) {
+        mheader->slots = slots;
+        mheader->slot_size = slot_size;
+        mheader->write_index = 0;
+        mheader->read_index = 0;
+        mheader->reader_waiting = 0;
+        spsc_store( &mheader->magic, MAGIC );
+    } else {
+        int waited = 0;
+        while ( spsc_load( &mheader->magic ) != MAGIC && waited++ != INIT_TIMEOUT_MS )
+            usleep(1000);
+        if ( mheader->magic != MAGIC
+             || mheader->slots <= 0 || (mheader->slots & (mheader->slots - 1)) != 0
+             || sizeof(Header) + size_t(mheader->slots) * align(SLOT_HEADER + mheader->slot_size, SLOT_HEADER) > mlength ) {
+            log(Error) << "Shared memory '" << name << "' is not a valid ring." << endlog();
+            close(false);
+            return false;
+        }
+    }
+    mstride = align(SLOT_HEADER + mheader->slot_size, SLOT_HEADER);
+    log(Debug) << "Opened shared memory '" << name << "' with " << mheader->slots << " slots of " << mheader->slot_size << " bytes." << endlog();
+    return true;
+}
+
+void ShmRing::close(bool unlink)
+{
+    if ( mheader ) {
+        munmap(mheader, mlength);
+        mheader = 0;
+        mlength = 0;
+    }
+    if ( unlink && !mname.empty() )
+        shm_unlink( mname.c_str() );
+}
+
+int ShmRing::slotSize() const
+{
+    return mheader ? mheader->slot_size : 0;
+}
+
+char* ShmRing::slot(Index index) const
+{
+    return reinterpret_cast<char*>(mheader + 1) + size_t( index & Index(mheader->slots - 1) ) * mstride;
+}
+
+char* ShmRing::writeSlot()
+{
+    Index w = mheader->write_index;
+    if ( Index( w - index_load( &mheader->read_index ) ) >= Index(mheader->slots) )
+        return 0;
+    return slot(w) + SLOT_HEADER;
+}
+
+void ShmRing::commitWrite(int length)
+{
+    Index w = mheader->write_index;
+    *reinterpret_cast<int*>( slot(w) ) = length;
+    // A locked exchange is a full barrier: either the reader sees the new
+    // index before it sleeps, or we see that it is waiting.
+    oro_cmpxchg( &mheader->write_index, w, w + 1 );
+    if ( spsc_load( &mheader->reader_waiting ) )
+        wakeReader();
+}
+
+const char* ShmRing::readSlot(int& length) const
+{
+    Index r = mheader->read_index;
+    if ( r == index_load( &mheader->write_index ) )
+        return 0;
+    const char* s = slot(r);
+    length = *reinterpret_cast<const int*>( s );
+    return s + SLOT_HEADER;
+}
+
+void ShmRing::commitRead()
+{
+    index_store( &mheader->read_index, Index(mheader->read_index + 1) );
+}
+
+bool ShmRing::empty() const
+{
+    return mheader->read_index == index_load( &mheader->write_index );
+}
+
+bool ShmRing::waitForData(Seconds timeout, const volatile bool* abort)
+{
+    if ( !empty() )
+        return true;
+    struct timespec ts;
+    ts.tv_sec = timeout >= 0 ? long(timeout) : 0;
+    ts.tv_nsec = timeout >= 0 ? long( (timeout - ts.tv_sec) * 1e9 ) : 0;
+    // Announce that we wait with a full barrier, then check again.
+    oro_cmpxchg( &mheader->reader_waiting, 0, 1 );
+    if ( empty() && !(abort && *abort) )
+        futex_wait( &mheader->reader_waiting, 1, timeout >= 0 ? &ts : 0 );
+    oro_cmpxchg( &mheader->reader_waiting, 1, 0 );
+    return !empty();
+}
+
+void ShmRing::wakeReader()
+{
+    if ( oro_cmpxchg( &mheader->reader_waiting, 1, 0 ) == 1 )
+        futex_wake( &mheader->reader_waiting );
+}
+
+ShmReceiver::ShmReceiver(ShmRing& ring, base::ChannelElementBase* chan)
+    : Activity(ORO_SCHED_RT, os::HighestPriority, 0.0, 0, "ShmReceiver"),
+      mring(ring), mchan(chan), do_exit(false)
+{
+}
+
+ShmReceiver::~ShmReceiver()
+{
+    stop();
+}
+
+bool ShmReceiver::initialize()
+{
+    do_exit = false;
+    return true;
+}
+
+void ShmReceiver::loop()
+{
+    while ( !do_exit ) {
+        if ( mring.waitForData(-1.0, &do_exit) ) {
+            // signal() reads one sample from the ring and forwards it.
+            while ( !do_exit && mchan->signal() )
+                ;
+        }
+    }
+}
+
+bool ShmReceiver::breakLoop()
+{
+    do_exit = true;
+    mring.wakeReader();
+    return true;
+}
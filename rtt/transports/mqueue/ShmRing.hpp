@@ -0,0 +1,179 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 01:41:25 UTC 2026  ShmRing.hpp
+
+                        ShmRing.hpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public                   *
+ *   License as published by the Free Software Foundation;                 *
+ *   version 2 of the License.                                             *
+ *                                                                         *
+ *   As a special exception, you may use this file as part of a free       *
+ *   software library without restriction.  Specifically, if other files   *
+ *   instantiate templates or use macros or inline functions from this     *
+ *   file, or you compile this file and link it with other files to        *
+ *   produce an executable, this file does not by itself cause the         *
+ *   resulting executable to be covered by the GNU General Public          *
+ *   License.  This exception does not however invalidate any other        *
+ *   reasons why the executable file might be covered by the GNU General   *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public             *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 59 Temple Place,                                    *
+ *   Suite 330, Boston, MA  02111-1307  USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef ORO_MQUEUE_SHMRING_HPP
+#define ORO_MQUEUE_SHMRING_HPP
+
+#include "../../Activity.hpp"
+#include "../../base/ChannelElementBase.hpp"
+#include <string>
+#include <boost/cstdint.hpp>
+
+namespace RTT
+{
+    namespace mqueue
+    {
+        /**
+         * A ring of fixed-size slots in POSIX shared memory, which
+         * transports samples from one writer process to one reader
+         * process without system calls on the data path.
+         *
+         * The writer marshals a sample directly into a free slot and
+         * publishes it by advancing the write index; the reader decodes
+         * it from the slot in place. A reader that found the ring empty
+         * sleeps on a futex in the shared segment, which the writer only
+         * wakes up when the reader announced that it is waiting.
+         *
+         * Both sides open the ring with the same name. The first one
+         * creates and initializes it, the other one uses the geometry
+         * chosen by the first, just like for message queues.
+         */
+        class ShmRing
+        {
+        public:
+            struct Header;
+
+            /**
+             * The write and read indices count the slots modulo 2^32.
+             */
+            typedef boost::uint32_t Index;
+
+            ShmRing();
+
+            ~ShmRing();
+
+            /**
+             * Opens the ring \a name, creating it with \a slots slots of
+             * \a slot_size bytes if it does not exist yet. The number of
+             * slots is rounded up to a power of two.
+             * @return false if the ring could not be opened, the reason is logged.
+             */
+            bool open(const std::string& name, int slots, int slot_size);
+
+            /**
+             * Unmaps the ring and removes its name if \a unlink is true.
+             */
+            void close(bool unlink);
+
+            /**
+             * The number of bytes that fit in one slot.
+             */
+            int slotSize() const;
+
+            /**
+             * Writer side: returns the next free slot, or zero if the ring is full.
+             * Fill it in and then call commitWrite().
+             */
+            char* writeSlot();
+
+            /**
+             * Writer side: publishes the slot returned by writeSlot(), which
+             * holds \a length bytes, and wakes up a waiting reader.
+             */
+            void commitWrite(int length);
+
+            /**
+             * Reader side: returns the oldest written slot and its
+             * length, or zero if the ring is empty. The slot remains
+             * valid until commitRead() is called.
+             */
+            const char* readSlot(int& length) const;
+
+            /**
+             * Reader side: frees the slot returned by readSlot().
+             */
+            void commitRead();
+
+            /**
+             * Returns true if no slot is waiting to be read.
+             */
+            bool empty() const;
+
+            /**
+             * Reader side: waits until a slot can be read.
+             * @param timeout The maximum time to wait in seconds, or a negative
+             * value to wait until data arrives or wakeReader() is called.
+             * @param abort Optional flag which is checked after the reader announced
+             * that it waits, such that a wakeReader() after setting it is never lost.
+             * @return true if a slot can be read.
+             */
+            bool waitForData(Seconds timeout, const volatile bool* abort = 0);
+
+            /**
+             * Wakes up the reader if it is blocked in waitForData().
+             */
+            void wakeReader();
+
+        private:
+            ShmRing(const ShmRing&);
+            ShmRing& operator=(const ShmRing&);
+
+            char* slot(Index index) const;
+
+            Header* mheader;
+            size_t mlength;
+            int mstride;
+            std::string mname;
+        };
+
+        /**
+         * Waits for data on the reading side of a ShmRing and signals
+         * the channel element of each sample, as the Dispatcher does
+         * for message queues. A futex can not be added to an epoll
+         * set, so each ring has its own thread.
+         */
+        class ShmReceiver : public Activity
+        {
+            ShmRing& mring;
+            base::ChannelElementBase* mchan;
+            volatile bool do_exit;
+        public:
+            ShmReceiver(ShmRing& ring, base::ChannelElementBase* chan);
+
+            ~ShmReceiver();
+
+            bool initialize();
+
+            void loop();
+
+            bool breakLoop();
+        };
+    }
+}
+
+#endif
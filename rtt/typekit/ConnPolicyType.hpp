@@ -55,6 +55,7 @@ namespace boost {
             a & boost::serialization::make_nvp("init", c.init );
             a & boost::serialization::make_nvp("lock_policy", c.lock_policy );
             a & boost::serialization::make_nvp("pull", c.pull );
+            a & boost::serialization::make_nvp("oneway", c.oneway );
             a & boost::serialization::make_nvp("size", c.size );
             a & boost::serialization::make_nvp("transport", c.transport );
             a & boost::serialization::make_nvp("data_size", c.data_size );
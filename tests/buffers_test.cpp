@@ -23,17 +23,20 @@
 
 #include <internal/AtomicQueue.hpp>
 #include <internal/AtomicMWSRQueue.hpp>
+#include <internal/SegmentedMWSRQueue.hpp>
 
 #include <Activity.hpp>
 
 #include <RTT.hpp>
 #include <base/Buffer.hpp>
+#include <base/BufferLockFreeSPSC.hpp>
 #include <internal/ListLockFree.hpp>
 #include <base/DataObject.hpp>
 #include <internal/TsPool.hpp>
 //#include <internal/SortedList.hpp>
 
 #include <os/Thread.hpp>
+#include <os/MainThread.hpp>
 #include <rtt-config.h>
 
 using namespace std;
@@ -123,6 +126,7 @@ public:
     DataObjectInterface<Dummy>* dataobj;
 
     BufferLockFree<Dummy>* lockfree;
+    BufferLockFreeSPSC<Dummy>* spsc;
     BufferLocked<Dummy>* locked;
     BufferUnSync<Dummy>* unsync;
 
@@ -145,6 +149,7 @@ public:
     {
         // clasical variants
         lockfree = new BufferLockFree<Dummy>(QS);
+        spsc = new BufferLockFreeSPSC<Dummy>(QS);
         locked = new BufferLocked<Dummy>(QS);
         unsync = new BufferUnSync<Dummy>(QS);
 
@@ -164,6 +169,7 @@ public:
 
     ~BuffersDataFlowTest(){
         delete lockfree;
+        delete spsc;
         delete locked;
         delete unsync;
         delete clockfree;
@@ -695,6 +701,40 @@ struct AQEater : public RunnableInterface
 };
 
 
+/**
+ * A SegmentedProducer enqueues a fixed number of distinct items.
+ */
+struct SegmentedProducer : public RunnableInterface
+{
+    SegmentedMWSRQueue<Dummy*>* mq;
+    std::vector<Dummy> items;
+    int sent;
+    SegmentedProducer(SegmentedMWSRQueue<Dummy*>* q, int count ) : mq(q), items(count), sent(0) {}
+    bool initialize() { return true; }
+    void step() {
+        for (unsigned int i = 0; i != items.size(); ++i)
+            if ( mq->enqueue( &items[i] ) )
+                ++sent;
+    }
+    void finalize() {}
+};
+
+struct SPSCProducer : public RunnableInterface
+{
+    BufferLockFreeSPSC<Dummy>* mbuf;
+    int count;
+    SPSCProducer(BufferLockFreeSPSC<Dummy>* b, int count ) : mbuf(b), count(count) {}
+    bool initialize() { return true; }
+    void step() {
+        // retry until the consumer made room, such that every sample arrives.
+        for (int i = 0; i != count; ++i)
+            while ( mbuf->Push( Dummy(i, i, i) ) == false )
+                this->getThread()->yield();
+    }
+    void finalize() {}
+};
+
+
 BOOST_FIXTURE_TEST_SUITE( BuffersAtomicTestSuite, BuffersAQueueTest )
 
 BOOST_AUTO_TEST_CASE( testAtomicQueue )
@@ -783,6 +823,85 @@ BOOST_AUTO_TEST_CASE( testAtomicMWSRQueue )
     delete d;
 }
 
+BOOST_AUTO_TEST_CASE( testSegmentedMWSRQueue )
+{
+    SegmentedMWSRQueue<Dummy*> squeue(4, 1);
+    std::vector<Dummy> items(20);
+    Dummy* d = 0;
+
+    BOOST_REQUIRE_EQUAL( squeue.capacity(), 8u );
+    BOOST_CHECK( squeue.isEmpty() );
+    BOOST_CHECK( squeue.dequeue(d) == false );
+    BOOST_CHECK( squeue.enqueue(0) == false );
+
+    // The queue grows beyond its segments and keeps the FIFO order.
+    for (int i = 0; i != 20; ++i)
+        BOOST_CHECK( squeue.enqueue( &items[i] ) );
+    BOOST_CHECK_EQUAL( squeue.size(), 20u );
+    BOOST_CHECK_EQUAL( squeue.capacity(), 20u );
+    BOOST_CHECK_EQUAL( squeue.allocatedSegments(), 3u );
+    BOOST_CHECK_EQUAL( squeue.highWatermark(), 20u );
+    for (int i = 0; i != 20; ++i) {
+        BOOST_REQUIRE( squeue.dequeue(d) );
+        BOOST_CHECK_EQUAL( d, &items[i] );
+    }
+    BOOST_CHECK( squeue.isEmpty() );
+    BOOST_CHECK( squeue.dequeue(d) == false );
+
+    // The emptied segments are reused by the next bursts.
+    for (int j = 0; j != 3; ++j) {
+        for (int i = 0; i != 20; ++i)
+            BOOST_CHECK( squeue.enqueue( &items[i] ) );
+        for (int i = 0; i != 20; ++i) {
+            BOOST_REQUIRE( squeue.dequeue(d) );
+            BOOST_CHECK_EQUAL( d, &items[i] );
+        }
+        BOOST_CHECK( squeue.dequeue(d) == false );
+    }
+    BOOST_CHECK_EQUAL( squeue.allocatedSegments(), 3u );
+    BOOST_CHECK_EQUAL( squeue.capacity(), 20u );
+    squeue.resetHighWatermark();
+    BOOST_CHECK_EQUAL( squeue.highWatermark(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( testSegmentedMWSRQueueWriters )
+{
+    SegmentedMWSRQueue<Dummy*> squeue(8, 1);
+    const int count = 20000;
+    SegmentedProducer a(&squeue, count), b(&squeue, count), c(&squeue, count);
+    SegmentedProducer* producers[] = { &a, &b, &c };
+    std::vector<int> next(3, 0);
+    {
+        boost::scoped_ptr<Activity> athread( new Activity(ORO_SCHED_OTHER, 0, 0, &a, "ProducerA" ));
+        boost::scoped_ptr<Activity> bthread( new Activity(ORO_SCHED_OTHER, 0, 0, &b, "ProducerB" ));
+        boost::scoped_ptr<Activity> cthread( new Activity(ORO_SCHED_OTHER, 0, 0, &c, "ProducerC" ));
+        athread->start();
+        bthread->start();
+        cthread->start();
+        // Every item arrives once and in the order of its producer.
+        int received = 0;
+        Dummy* d = 0;
+        TimeService::ticks start = TimeService::Instance()->getTicks();
+        while ( received != 3 * count && TimeService::Instance()->secondsSince(start) < 10.0 ) {
+            if ( !squeue.dequeue(d) )
+                continue;
+            ++received;
+            int p = 0;
+            while ( p != 3 && (d < &producers[p]->items[0] || d >= &producers[p]->items[0] + count) )
+                ++p;
+            BOOST_REQUIRE( p != 3 );
+            BOOST_REQUIRE_EQUAL( d - &producers[p]->items[0], next[p] );
+            ++next[p];
+        }
+        athread->stop();
+        bthread->stop();
+        cthread->stop();
+        BOOST_CHECK_EQUAL( received, 3 * count );
+    }
+    BOOST_CHECK_EQUAL( a.sent + b.sent + c.sent, 3 * count );
+    BOOST_CHECK( squeue.isEmpty() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_FIXTURE_TEST_SUITE( BuffersDataFlowTestSuite, BuffersDataFlowTest )
@@ -795,6 +914,136 @@ BOOST_AUTO_TEST_CASE( testBufLockFree )
     testCirc();
 }
 
+BOOST_AUTO_TEST_CASE( testBufLockFreeSPSC )
+{
+    buffer = spsc;
+    testBuf();
+
+    // samples that are popped without release stay valid and take room in the ring.
+    Dummy* d = new Dummy;
+    Dummy* c = new Dummy(2.0, 1.0, 0.0);
+    BufferBase::size_type dropped = spsc->dropped();
+    BOOST_CHECK( spsc->Push( *d ) );
+    BOOST_CHECK( spsc->Push( *c ) );
+    Dummy* first = spsc->PopWithoutRelease();
+    BOOST_REQUIRE( first );
+    BOOST_CHECK( *first == *d );
+    for (int i = 0; i != QS; ++i)
+        BOOST_CHECK( spsc->Push( *d ) == (i < QS - 1) );
+    BOOST_CHECK( *first == *d );
+    Dummy* second = spsc->PopWithoutRelease();
+    BOOST_REQUIRE( second );
+    BOOST_CHECK( *second == *c );
+    spsc->Release( first );
+    BOOST_CHECK( spsc->Push( *c ) );
+    BOOST_CHECK( spsc->Push( *c ) == false );
+    spsc->Release( second );
+    BOOST_CHECK( spsc->size() == QS );
+    BOOST_CHECK( spsc->dropped() == dropped + 2 );
+    spsc->clear();
+    BOOST_CHECK( spsc->empty() );
+    BOOST_CHECK( spsc->PopWithoutRelease() == 0 );
+    delete d;
+    delete c;
+}
+
+BOOST_AUTO_TEST_CASE( testBufLoan )
+{
+    Dummy c(2.0, 1.0, 0.0);
+    BufferInterface<Dummy>* bufs[] = { lockfree, spsc };
+    for (int b = 0; b != 2; ++b) {
+        BufferInterface<Dummy>* buf = bufs[b];
+        BOOST_CHECK( buf->supportsZeroCopy() );
+
+        // fill the buffer in place.
+        for (int i = 0; i != QS; ++i) {
+            Dummy* s = buf->Loan();
+            BOOST_REQUIRE( s );
+            *s = Dummy(i, i, i);
+            BOOST_CHECK( buf->Commit( s ) );
+        }
+        BOOST_CHECK( buf->full() );
+        BOOST_CHECK( buf->Loan() == 0 );
+
+        // popped samples may be released in any order.
+        Dummy* first = buf->PopWithoutRelease();
+        Dummy* second = buf->PopWithoutRelease();
+        BOOST_REQUIRE( first && second );
+        BOOST_CHECK( *first == Dummy(0, 0, 0) );
+        BOOST_CHECK( *second == Dummy(1, 1, 1) );
+        buf->Release( second );
+        buf->Release( first );
+        for (int i = 0; i != 2; ++i) {
+            Dummy* s = buf->Loan();
+            BOOST_REQUIRE( s );
+            *s = c;
+            BOOST_CHECK( buf->Commit( s ) );
+        }
+        BOOST_CHECK( buf->full() );
+
+        Dummy r;
+        for (int i = 2; i != QS; ++i) {
+            BOOST_CHECK( buf->Pop( r ) );
+            BOOST_CHECK( r == Dummy(i, i, i) );
+        }
+        BOOST_CHECK( buf->Pop( r ) && r == c );
+        BOOST_CHECK( buf->Pop( r ) && r == c );
+        BOOST_CHECK( buf->empty() );
+    }
+
+    // buffers that copy out do not loan samples.
+    BOOST_CHECK( !locked->supportsZeroCopy() );
+    BOOST_CHECK( locked->Loan() == 0 );
+    BOOST_CHECK( !unsync->supportsZeroCopy() );
+    BOOST_CHECK( unsync->Loan() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testBufBatch )
+{
+    std::vector<Dummy> in, out;
+    out.reserve( QS );
+    for (int i = 0; i != QS + 3; ++i)
+        in.push_back( Dummy(i, i, i) );
+
+    BufferInterface<Dummy>* bufs[] = { lockfree, spsc, locked, unsync };
+    for (int b = 0; b != 4; ++b) {
+        BufferInterface<Dummy>* buf = bufs[b];
+        // only the first QS samples fit.
+        BOOST_CHECK_EQUAL( buf->Push( in ), QS );
+        BOOST_CHECK( buf->full() );
+
+        // read them back in pieces, oldest first.
+        BOOST_CHECK_EQUAL( buf->Pop( out, 3 ), 3 );
+        BOOST_REQUIRE_EQUAL( out.size(), 3u );
+        for (int i = 0; i != 3; ++i)
+            BOOST_CHECK( out[i] == in[i] );
+        BOOST_CHECK_EQUAL( buf->size(), QS - 3 );
+
+        BOOST_CHECK_EQUAL( buf->Pop( out, QS ), QS - 3 );
+        BOOST_REQUIRE_EQUAL( out.size(), (size_t)(QS - 3) );
+        for (int i = 0; i != QS - 3; ++i)
+            BOOST_CHECK( out[i] == in[i + 3] );
+        BOOST_CHECK( buf->empty() );
+        BOOST_CHECK_EQUAL( buf->Pop( out, QS ), 0 );
+        BOOST_CHECK( out.empty() );
+    }
+
+    // a batch that only partly fits counts the rest as dropped.
+    std::vector<Dummy> few( in.begin(), in.begin() + 3 );
+    BOOST_CHECK_EQUAL( lockfree->Push( few ), 3 );
+    BufferBase::size_type dropped = lockfree->dropped();
+    BOOST_CHECK_EQUAL( lockfree->Push( in ), QS - 3 );
+    BOOST_CHECK_EQUAL( lockfree->dropped(), dropped + 6 );
+    BOOST_CHECK_EQUAL( lockfree->Pop( out ), QS );
+    BOOST_CHECK( out[2] == in[2] );
+    BOOST_CHECK( out[3] == in[0] );
+    BOOST_CHECK( lockfree->empty() );
+
+    // the memory pool got all its items back.
+    BOOST_CHECK_EQUAL( lockfree->Push( in ), QS );
+    BOOST_CHECK_EQUAL( lockfree->Pop( out ), QS );
+}
+
 BOOST_AUTO_TEST_CASE( testBufLocked )
 {
     buffer = locked;
@@ -1155,5 +1404,40 @@ BOOST_AUTO_TEST_CASE( testAtomicMWSRQueue )
     delete grower;
     delete eater;
 }
+BOOST_AUTO_TEST_CASE( testBufLockFreeSPSC )
+{
+    const int count = 100000;
+    BufferLockFreeSPSC<Dummy>* buf = new BufferLockFreeSPSC<Dummy>(QS);
+    SPSCProducer* producer = new SPSCProducer( buf, count );
+    {
+        boost::scoped_ptr<Activity> pthread( new Activity(ORO_SCHED_OTHER, 0, 0, producer, "ActivityP" ));
+        pthread->start();
+        // consume the way ChannelBufferElement does: keep the last sample until the next one arrives.
+        Dummy* last = 0;
+        int next = 0;
+        while ( next != count ) {
+            Dummy* d = buf->PopWithoutRelease();
+            if ( d == 0 ) {
+                os::MainThread::Instance()->yield();
+                continue;
+            }
+            if ( *d != Dummy(next, next, next) ) {
+                BOOST_CHECK_EQUAL( d->d1, next );
+                break;
+            }
+            if ( last )
+                buf->Release( last );
+            last = d;
+            ++next;
+        }
+        if ( last )
+            buf->Release( last );
+        pthread->stop();
+        BOOST_CHECK_EQUAL( next, count );
+    }
+    BOOST_CHECK( buf->empty() );
+    delete producer;
+    delete buf;
+}
 #endif
 BOOST_AUTO_TEST_SUITE_END()
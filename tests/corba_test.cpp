@@ -33,6 +33,9 @@
 #include <transports/corba/ServiceC.h>
 #include <transports/corba/CorbaLib.hpp>
 #include <transports/corba/CorbaConnPolicy.hpp>
+#include <transports/corba/CorbaDispatcher.hpp>
+#include <transports/corba/CorbaRawTemplateProtocol.hpp>
+#include <rtt/internal/ConnectionManager.hpp>
 
 #include "operations_fixture.hpp"
 
@@ -268,6 +271,65 @@ BOOST_AUTO_TEST_CASE( testProperties )
     BOOST_CHECK_EQUAL( proxy_d.get(), 6.0);
 }
 
+BOOST_AUTO_TEST_CASE( testBulkProperties )
+{
+    ts = corba::TaskContextServer::Create( tc, false ); //no-naming
+    BOOST_CHECK( ts );
+    corba::CService_var serv = ts->server()->service();
+    BOOST_REQUIRE( serv.in() );
+
+    // one call reads the given values, unknown names are left out.
+    corba::CConfigurationInterface::CValueNames names;
+    names.length(3);
+    names[0] = CORBA::string_dup("pint1");
+    names[1] = CORBA::string_dup("s1.s2.pdouble1");
+    names[2] = CORBA::string_dup("nonexisting");
+    corba::CConfigurationInterface::CValues_var values = serv->getProperties( names );
+    BOOST_REQUIRE_EQUAL( values->length(), 2u );
+    CORBA::Long ival = 0;
+    CORBA::Double dval = 0;
+    BOOST_CHECK_EQUAL( string(values[0].name.in()), "pint1" );
+    BOOST_CHECK( values[0].value >>= ival );
+    BOOST_CHECK_EQUAL( ival, 3 );
+    BOOST_CHECK_EQUAL( string(values[1].name.in()), "s1.s2.pdouble1" );
+    BOOST_CHECK( values[1].value >>= dval );
+    BOOST_CHECK_EQUAL( dval, -3.0 );
+
+    values = serv->getAllProperties();
+    BOOST_CHECK_EQUAL( values->length(), listProperties( *tc->provides()->properties() ).size() );
+    values = serv->getAllAttributes();
+    BOOST_CHECK_EQUAL( values->length(), tc->provides()->getAttributeNames().size() );
+
+    // the first poll returns everything, an idle component nothing.
+    CORBA::ULongLong version = 0;
+    values = serv->getChangedAttributes( version );
+    BOOST_CHECK_EQUAL( values->length(), tc->provides()->getAttributeNames().size() );
+    BOOST_CHECK( version != 0 );
+    CORBA::ULongLong idle = version;
+    values = serv->getChangedAttributes( version );
+    BOOST_CHECK_EQUAL( values->length(), 0u );
+    BOOST_CHECK_EQUAL( version, idle );
+
+    // only the changed value is returned.
+    aint1 = 7;
+    values = serv->getChangedAttributes( version );
+    BOOST_REQUIRE_EQUAL( values->length(), 1u );
+    BOOST_CHECK_EQUAL( string(values[0].name.in()), "aint1" );
+    BOOST_CHECK( values[0].value >>= ival );
+    BOOST_CHECK_EQUAL( ival, 7 );
+    BOOST_CHECK( version > idle );
+
+    version = 0;
+    values = serv->getChangedProperties( version );
+    BOOST_CHECK_EQUAL( values->length(), 2u ); // pint1 and s1.s2.pdouble1, not the bags.
+    pdouble1->set( 8.0 );
+    values = serv->getChangedProperties( version );
+    BOOST_REQUIRE_EQUAL( values->length(), 1u );
+    BOOST_CHECK_EQUAL( string(values[0].name.in()), "s1.s2.pdouble1" );
+    BOOST_CHECK( values[0].value >>= dval );
+    BOOST_CHECK_EQUAL( dval, 8.0 );
+}
+
 BOOST_AUTO_TEST_CASE( testOperationCallerC_Call )
 {
 
@@ -814,5 +876,235 @@ BOOST_AUTO_TEST_CASE( testBufferHalfs )
     BOOST_CHECK_EQUAL( result, 4.44);
 }
 
+BOOST_AUTO_TEST_CASE( testBufferWriteMany )
+{
+    double result;
+    ts  = corba::TaskContextServer::Create( tc, false ); //no-naming
+    ts2 = corba::TaskContextServer::Create( t2, false ); //no-naming
+
+    RTT::corba::CConnPolicy policy = toCORBA(ConnPolicy::buffer(100));
+    policy.init = false;
+    policy.transport = ORO_CORBA_PROTOCOL_ID; // force creation of non-local connections
+
+    corba::CDataFlowInterface_var ports  = ts->server()->ports();
+    corba::CDataFlowInterface_var ports2 = ts2->server()->ports();
+    BOOST_REQUIRE( ports.in() );
+
+    // test Corba writeMany --> C++ read
+    CChannelElement_var cce = ports->buildChannelOutput("mi", policy);
+    ports->channelReady("mi", cce, policy);
+    CRemoteChannelElement_var rce = CRemoteChannelElement::_narrow( cce.in() );
+    BOOST_REQUIRE( rce.in() );
+
+    CAnySequence samples;
+    samples.length(3);
+    for (CORBA::ULong i = 0; i != 3; ++i)
+        samples[i] <<= double(i + 1);
+    BOOST_CHECK( rce->writeMany( samples ) );
+    for (int i = 1; i <= 3; ++i) {
+        BOOST_CHECK_EQUAL( mi1->read( result ), NewData );
+        BOOST_CHECK_EQUAL( result, double(i) );
+    }
+    BOOST_CHECK_EQUAL( mi1->read( result ), OldData );
+    cce->disconnect();
+
+    // a burst of writes is pushed in batches and arrives in order.
+    policy.pull = false;
+    BOOST_CHECK( ports->createConnection("mo", ports2, "mi", policy) );
+    for (int i = 0; i != 100; ++i)
+        mo1->write( double(i) );
+    int received = 0;
+    for (int wait = 0; received != 100 && wait != 50; ++wait) {
+        while ( mi2->read( result ) == NewData ) {
+            BOOST_CHECK_EQUAL( result, double(received) );
+            ++received;
+        }
+        usleep(100000);
+    }
+    BOOST_CHECK_EQUAL( received, 100 );
+}
+
+BOOST_AUTO_TEST_CASE( testOnewayConnection )
+{
+    double result;
+    ts  = corba::TaskContextServer::Create( tc, false ); //no-naming
+    ts2 = corba::TaskContextServer::Create( t2, false ); //no-naming
+
+    ConnPolicy cp = ConnPolicy::buffer(10);
+    cp.oneway = true;
+    RTT::corba::CConnPolicy policy = toCORBA(cp);
+    policy.init = false;
+    policy.transport = ORO_CORBA_PROTOCOL_ID; // force creation of non-local connections
+    BOOST_CHECK( policy.oneway );
+    BOOST_CHECK( toRTT(policy).oneway );
+
+    corba::CDataFlowInterface_var ports  = ts->server()->ports();
+    corba::CDataFlowInterface_var ports2 = ts2->server()->ports();
+
+    // must be running to catch event port signalling.
+    BOOST_CHECK( t2->start() );
+    BOOST_CHECK( ports->createConnection("mo", ports2, "mi", policy) );
+    testPortBufferConnection();
+
+    // a full window of samples arrives in order, once credit was returned
+    // for the previous writes.
+    for (int i = 0; i != 10; ++i)
+        mo1->write( double(i) );
+    int received = 0;
+    for (int wait = 0; received != 10 && wait != 50; ++wait) {
+        while ( mi2->read( result ) == NewData ) {
+            BOOST_CHECK_EQUAL( result, double(received) );
+            ++received;
+        }
+        usleep(100000);
+    }
+    BOOST_CHECK_EQUAL( received, 10 );
+
+    // Samples beyond the free slots of the reader's buffer are kept back
+    // by the writer instead of being dropped by the reader.
+    for (int i = 0; i != 10; ++i)
+        mo1->write( double(i) );
+    usleep(500000);
+    for (int i = 10; i != 15; ++i)
+        mo1->write( double(i) );
+    usleep(500000);
+    received = 0;
+    while ( mi2->read( result ) == NewData ) {
+        BOOST_CHECK_EQUAL( result, double(received) );
+        ++received;
+    }
+    BOOST_CHECK_EQUAL( received, 10 );
+    // These reads let the reader grant credit, so the samples which were
+    // kept back follow without another write.
+    for (int wait = 0; received != 15 && wait != 50; ++wait) {
+        while ( mi2->read( result ) == NewData ) {
+            BOOST_CHECK_EQUAL( result, double(received) );
+            ++received;
+        }
+        usleep(100000);
+    }
+    BOOST_CHECK_EQUAL( received, 15 );
+    std::list<internal::ConnectionManager::ChannelDescriptor> channels = mo1->getManager()->getChannels();
+    BOOST_REQUIRE_EQUAL( channels.size(), 1u );
+    CRemoteChannelElement_i* chan = dynamic_cast<CRemoteChannelElement_i*>( channels.front().get<1>()->getOutputEndPoint().get() );
+    BOOST_REQUIRE( chan );
+    BOOST_CHECK_EQUAL( chan->getDroppedSamples(), 0u );
+
+    ports->disconnectPort("mo");
+    testPortDisconnected();
+}
+
+BOOST_AUTO_TEST_CASE( testDispatcherStatistics )
+{
+    ts  = corba::TaskContextServer::Create( tc, false ); //no-naming
+    ts2 = corba::TaskContextServer::Create( t2, false ); //no-naming
+
+    RTT::corba::CConnPolicy policy = toCORBA(ConnPolicy::buffer(3));
+    policy.init = false;
+    policy.transport = ORO_CORBA_PROTOCOL_ID; // force creation of non-local connections
+
+    corba::CDataFlowInterface_var ports  = ts->server()->ports();
+    corba::CDataFlowInterface_var ports2 = ts2->server()->ports();
+
+    // must be running to catch event port signalling.
+    BOOST_CHECK( t2->start() );
+    BOOST_CHECK( ports->createConnection("mo", ports2, "mi", policy) );
+
+    corba::CorbaDispatcher* dispatcher = corba::CorbaDispatcher::Instance( tc->ports() );
+    BOOST_CHECK_EQUAL( dispatcher->getWorkerCount(), 2u );
+
+    std::list<internal::ConnectionManager::ChannelDescriptor> channels = mo1->getManager()->getChannels();
+    BOOST_REQUIRE_EQUAL( channels.size(), 1u );
+    CRemoteChannelElement_i* chan = dynamic_cast<CRemoteChannelElement_i*>( channels.front().get<1>()->getOutputEndPoint().get() );
+    BOOST_REQUIRE( chan );
+
+    testPortBufferConnection();
+    BOOST_CHECK_EQUAL( chan->getPendingSignals(), 0 );
+    BOOST_CHECK( chan->getPendingSignalsHighWatermark() >= 1 );
+    BOOST_CHECK( chan->getTransferStatistics().getCount() >= 1 );
+    BOOST_CHECK( chan->getTransferStatistics().getMin() <= chan->getTransferStatistics().getMax() );
+    BOOST_CHECK_EQUAL( dispatcher->getQueuedChannels(), 0u );
+
+    // A cancelled channel is not queued anymore when it is signalled.
+    dispatcher->cancelChannel( chan );
+    dispatcher->dispatchChannel( chan );
+    BOOST_CHECK_EQUAL( dispatcher->getQueuedChannels(), 0u );
+    BOOST_CHECK_EQUAL( chan->getPendingSignals(), 0 );
+
+    ports->disconnectPort("mo");
+    testPortDisconnected();
+}
+
+BOOST_AUTO_TEST_CASE( testRawSamples )
+{
+    types::TypeInfo* ti = types::Types()->type("array");
+    BOOST_REQUIRE( ti );
+    corba::CorbaTypeTransporter* ctt = dynamic_cast<corba::CorbaTypeTransporter*>( ti->getProtocol(ORO_CORBA_PROTOCOL_ID) );
+    BOOST_REQUIRE( ctt );
+    BOOST_CHECK( ctt->getRawTypeHash() != 0 );
+
+    // a vector is sent as one CRawSample and copied into the target.
+    std::vector<double> data(1000);
+    for (unsigned int i = 0; i != data.size(); ++i)
+        data[i] = i * 0.5;
+    internal::ValueDataSource< std::vector<double> >::shared_ptr source = new internal::ValueDataSource< std::vector<double> >( data );
+    internal::ValueDataSource< std::vector<double> >::shared_ptr target = new internal::ValueDataSource< std::vector<double> >();
+    CORBA::Any any;
+    BOOST_CHECK( ctt->updateRawAny( source, any ) );
+    const CRawSample* blob = 0;
+    BOOST_REQUIRE( any >>= blob );
+    BOOST_CHECK_EQUAL( blob->length(), sizeof(corba::RawSampleHeader) + data.size() * sizeof(double) );
+    BOOST_CHECK( ctt->updateFromAny( &any, target ) );
+    BOOST_CHECK( target->get() == data );
+
+    // the any conversion is still understood.
+    CORBA::Any_var converted = ctt->createAny( source );
+    target->set().clear();
+    BOOST_CHECK( ctt->updateFromAny( &converted.in(), target ) );
+    BOOST_CHECK( target->get() == data );
+
+    // a raw sample of another type is rejected.
+    corba::RawSampleHeader header;
+    header.type_hash = ctt->getRawTypeHash() + 1;
+    header.count = 0;
+    header.reserved = 0;
+    CRawSample* other = new CRawSample( sizeof(header) );
+    other->length( sizeof(header) );
+    memcpy( other->get_buffer(), &header, sizeof(header) );
+    any <<= other;
+    BOOST_CHECK( !ctt->updateFromAny( &any, target ) );
+
+    // and a connection sends raw samples when both sides agree.
+    ts  = corba::TaskContextServer::Create( tc, false ); //no-naming
+    ts2 = corba::TaskContextServer::Create( t2, false ); //no-naming
+    OutputPort< std::vector<double> > vo("vo");
+    InputPort< std::vector<double> > vi("vi");
+    tc->ports()->addPort( vo );
+    t2->ports()->addPort( vi );
+
+    RTT::corba::CConnPolicy policy = toCORBA(ConnPolicy::buffer(10));
+    policy.init = false;
+    policy.transport = ORO_CORBA_PROTOCOL_ID; // force creation of non-local connections
+    corba::CDataFlowInterface_var ports  = ts->server()->ports();
+    corba::CDataFlowInterface_var ports2 = ts2->server()->ports();
+    BOOST_CHECK( ports->createConnection("vo", ports2, "vi", policy) );
+
+    vo.write( data );
+    std::vector<double> result;
+    for (int wait = 0; vi.read( result ) != NewData && wait != 50; ++wait)
+        usleep(100000);
+    BOOST_CHECK( result == data );
+
+    std::list<internal::ConnectionManager::ChannelDescriptor> channels = vo.getManager()->getChannels();
+    BOOST_REQUIRE_EQUAL( channels.size(), 1u );
+    CRemoteChannelElement_i* chan = dynamic_cast<CRemoteChannelElement_i*>( channels.front().get<1>()->getOutputEndPoint().get() );
+    BOOST_REQUIRE( chan );
+    BOOST_CHECK( chan->isRaw() );
+
+    ports->disconnectPort("vo");
+    tc->ports()->removePort("vo");
+    t2->ports()->removePort("vi");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
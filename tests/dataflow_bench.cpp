@@ -0,0 +1,361 @@
+/***************************************************************************
+  tag: agent  Sat Oct 17 23:24:26 UTC 2026  dataflow_bench.cpp
+
+                        dataflow_bench.cpp -  description
+                           -------------------
+    begin                : Sat October 17 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/**
+ * Micro-benchmark of the OutputPort::write -> InputPort::read path.
+ *
+ * Every combination of connection type (DATA, BUFFER, CIRCULAR_BUFFER),
+ * lock policy (LOCKED, LOCK_FREE, LOCK_FREE_SPSC, UNSYNC), payload size and number of
+ * writer threads is measured. The results are printed on stdout as one
+ * JSON document, such that runs of different commits can be compared
+ * by a script. Log output goes to orocos.log as usual.
+ *
+ * Usage: dataflow-bench [--samples N] [--writers N] [--buffer-size N]
+ */
+
+#include <os/main.h>
+#include <os/TimeService.hpp>
+#include <os/Atomic.hpp>
+#include <Activity.hpp>
+#include <InputPort.hpp>
+#include <OutputPort.hpp>
+#include <Logger.hpp>
+#include <base/RunnableInterface.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+
+using namespace std;
+using namespace RTT;
+using namespace RTT::os;
+
+namespace {
+
+    /** Maximum number of bytes copied per measurement, to bound the run time of large payloads. */
+    const size_t BYTES_BUDGET = 256 * 1024 * 1024;
+
+    struct BenchConfig {
+        unsigned int samples;
+        unsigned int writers;
+        int buffer_size;
+        BenchConfig() : samples(10000), writers(4), buffer_size(64) {}
+    };
+
+    /**
+     * Latency statistics of one measured operation, in nanoseconds.
+     */
+    struct LatencyStats {
+        unsigned long count;
+        double p50, p99, p999, max;
+
+        LatencyStats() : count(0), p50(0), p99(0), p999(0), max(0) {}
+
+        static LatencyStats compute(vector<TimeService::nsecs>& lat) {
+            LatencyStats s;
+            s.count = lat.size();
+            if ( lat.empty() )
+                return s;
+            sort( lat.begin(), lat.end() );
+            s.p50  = percentile(lat, 0.5);
+            s.p99  = percentile(lat, 0.99);
+            s.p999 = percentile(lat, 0.999);
+            s.max  = lat.back();
+            return s;
+        }
+
+        static double percentile(const vector<TimeService::nsecs>& sorted, double p) {
+            size_t idx = (size_t)( p * (sorted.size() - 1) + 0.5 );
+            return sorted[ idx ];
+        }
+
+        string toJson() const {
+            stringstream ss;
+            ss << "{\"count\": " << count << ", \"p50_ns\": " << p50 << ", \"p99_ns\": " << p99
+               << ", \"p999_ns\": " << p999 << ", \"max_ns\": " << max << "}";
+            return ss.str();
+        }
+    };
+
+    inline TimeService::nsecs now_ns() {
+        return TimeService::ticks2nsecs( TimeService::Instance()->getTicks() );
+    }
+
+    /**
+     * Payload traits: creates a sample of a given size and reports its size in bytes.
+     */
+    template<class T>
+    struct Payload;
+
+    template<>
+    struct Payload<double> {
+        static double make(size_t) { return 3.14; }
+        static size_t bytes(const double&) { return sizeof(double); }
+        static string name(size_t) { return "double"; }
+    };
+
+    template<>
+    struct Payload< vector<double> > {
+        static vector<double> make(size_t bytes) { return vector<double>( bytes / sizeof(double), 3.14 ); }
+        static size_t bytes(const vector<double>& v) { return v.size() * sizeof(double); }
+        static string name(size_t bytes) {
+            stringstream ss;
+            ss << "vector<double>[" << bytes / sizeof(double) << "]";
+            return ss.str();
+        }
+    };
+
+    /**
+     * Writes \a count samples on its own OutputPort and records
+     * the duration of each write() call.
+     */
+    template<class T>
+    struct Writer : public base::RunnableInterface
+    {
+        OutputPort<T> port;
+        T sample;
+        unsigned int count;
+        AtomicInt* go;
+        AtomicInt* done;
+        vector<TimeService::nsecs> latencies;
+
+        Writer(const T& s, unsigned int count, AtomicInt* go, AtomicInt* done)
+            : port("out"), sample(s), count(count), go(go), done(done)
+        {
+            port.setDataSample(sample);
+            latencies.reserve(count);
+        }
+
+        bool initialize() { return true; }
+
+        void step() {
+            while ( go->read() == 0 )
+                ;
+            for (unsigned int i = 0; i != count; ++i) {
+                TimeService::nsecs start = now_ns();
+                port.write(sample);
+                latencies.push_back( now_ns() - start );
+            }
+            done->inc();
+        }
+
+        void finalize() {}
+    };
+
+    string typeName(int type) {
+        switch (type) {
+        case ConnPolicy::DATA: return "DATA";
+        case ConnPolicy::BUFFER: return "BUFFER";
+        case ConnPolicy::CIRCULAR_BUFFER: return "CIRCULAR_BUFFER";
+        }
+        return "UNKNOWN";
+    }
+
+    string lockName(int lock_policy) {
+        switch (lock_policy) {
+        case ConnPolicy::UNSYNC: return "UNSYNC";
+        case ConnPolicy::LOCKED: return "LOCKED";
+        case ConnPolicy::LOCK_FREE: return "LOCK_FREE";
+        case ConnPolicy::LOCK_FREE_SPSC: return "LOCK_FREE_SPSC";
+        }
+        return "UNKNOWN";
+    }
+
+    ConnPolicy makePolicy(int type, int lock_policy, int buffer_size) {
+        if ( type == ConnPolicy::DATA )
+            return ConnPolicy::data(lock_policy);
+        if ( type == ConnPolicy::BUFFER )
+            return ConnPolicy::buffer(buffer_size, lock_policy);
+        return ConnPolicy::circularBuffer(buffer_size, lock_policy);
+    }
+
+    /**
+     * Runs one write -> read measurement for \a writers writer threads.
+     * With one writer, write() and read() are interleaved in the calling
+     * thread, such that the UNSYNC policy can be measured as well. With more
+     * writers, each writer thread has its own connection to one InputPort,
+     * which is drained by the calling thread.
+     * @return the JSON object describing the result, or an empty string if the
+     * combination could not be set up.
+     */
+    template<class T>
+    string run(const BenchConfig& cfg, size_t payload, int type, int lock_policy, unsigned int writers)
+    {
+        T sample = Payload<T>::make(payload);
+        size_t bytes = Payload<T>::bytes(sample);
+        unsigned int count = cfg.samples;
+        if ( bytes * count > BYTES_BUDGET )
+            count = std::max<size_t>( 10, BYTES_BUDGET / bytes );
+
+        ConnPolicy policy = makePolicy(type, lock_policy, cfg.buffer_size);
+        InputPort<T> input("in");
+        T result = sample;
+        AtomicInt go(0), done(0);
+
+        vector< boost::shared_ptr< Writer<T> > > ws;
+        for (unsigned int w = 0; w != writers; ++w) {
+            ws.push_back( boost::shared_ptr< Writer<T> >( new Writer<T>(sample, count, &go, &done) ) );
+            if ( !ws.back()->port.connectTo(&input, policy) ) {
+                log(Error) << "Could not connect writer " << w << " using " << typeName(type) << "/" << lockName(lock_policy) << endlog();
+                return string();
+            }
+        }
+
+        vector<TimeService::nsecs> write_lat, read_lat;
+        read_lat.reserve( count * writers );
+        unsigned long received = 0;
+        TimeService::nsecs start, elapsed;
+
+        if ( writers == 1 ) {
+            Writer<T>& wr = *ws.front();
+            start = now_ns();
+            for (unsigned int i = 0; i != count; ++i) {
+                TimeService::nsecs t0 = now_ns();
+                wr.port.write(sample);
+                TimeService::nsecs t1 = now_ns();
+                FlowStatus fs = input.read(result, false);
+                TimeService::nsecs t2 = now_ns();
+                wr.latencies.push_back( t1 - t0 );
+                if ( fs == NewData ) {
+                    read_lat.push_back( t2 - t1 );
+                    ++received;
+                }
+            }
+            elapsed = now_ns() - start;
+        } else {
+            vector< boost::shared_ptr<Activity> > acts;
+            for (unsigned int w = 0; w != writers; ++w) {
+                stringstream name;
+                name << "BenchWriter" << w;
+                acts.push_back( boost::shared_ptr<Activity>( new Activity(ORO_SCHED_OTHER, 0, 0, ws[w].get(), name.str()) ) );
+                acts.back()->start();
+            }
+            start = now_ns();
+            go.set(1);
+            while (true) {
+                bool finished = ( done.read() == (int)writers );
+                TimeService::nsecs t0 = now_ns();
+                FlowStatus fs = input.read(result, false);
+                if ( fs == NewData ) {
+                    read_lat.push_back( now_ns() - t0 );
+                    ++received;
+                } else if ( finished ) {
+                    break;
+                }
+            }
+            elapsed = now_ns() - start;
+            for (unsigned int w = 0; w != writers; ++w)
+                acts[w]->stop();
+        }
+
+        for (unsigned int w = 0; w != writers; ++w) {
+            write_lat.insert( write_lat.end(), ws[w]->latencies.begin(), ws[w]->latencies.end() );
+            ws[w]->port.disconnect();
+        }
+
+        double seconds = elapsed / 1e9;
+        unsigned long written = (unsigned long)count * writers;
+        stringstream ss;
+        ss << "{\"type\": \"" << typeName(type) << "\", \"lock_policy\": \"" << lockName(lock_policy)
+           << "\", \"payload\": \"" << Payload<T>::name(payload) << "\", \"payload_bytes\": " << bytes
+           << ", \"writers\": " << writers
+           << ", \"written\": " << written << ", \"received\": " << received
+           << ", \"elapsed_s\": " << seconds
+           << ", \"write_throughput_hz\": " << ( seconds > 0 ? written / seconds : 0 )
+           << ", \"read_throughput_hz\": " << ( seconds > 0 ? received / seconds : 0 )
+           << ", \"write_latency\": " << LatencyStats::compute(write_lat).toJson()
+           << ", \"read_latency\": " << LatencyStats::compute(read_lat).toJson()
+           << "}";
+        return ss.str();
+    }
+
+    /**
+     * Runs all policy and writer combinations for one payload.
+     */
+    template<class T>
+    void runAll(const BenchConfig& cfg, size_t payload, vector<string>& results)
+    {
+        const int types[] = { ConnPolicy::DATA, ConnPolicy::BUFFER, ConnPolicy::CIRCULAR_BUFFER };
+        const int locks[] = { ConnPolicy::LOCKED, ConnPolicy::LOCK_FREE, ConnPolicy::LOCK_FREE_SPSC, ConnPolicy::UNSYNC };
+        for (unsigned int t = 0; t != sizeof(types)/sizeof(int); ++t)
+            for (unsigned int l = 0; l != sizeof(locks)/sizeof(int); ++l)
+                for (unsigned int w = 1; w <= cfg.writers; w *= 2) {
+                    // UNSYNC connections are not thread-safe.
+                    if ( locks[l] == ConnPolicy::UNSYNC && w != 1 )
+                        continue;
+                    string r = run<T>(cfg, payload, types[t], locks[l], w);
+                    if ( !r.empty() )
+                        results.push_back(r);
+                }
+    }
+
+    bool parseArgs(int argc, char** argv, BenchConfig& cfg)
+    {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if ( i + 1 >= argc ) {
+                cerr << "Missing value for " << arg << endl;
+                return false;
+            }
+            int value = atoi( argv[++i] );
+            if ( value <= 0 ) {
+                cerr << "Invalid value for " << arg << ": " << argv[i] << endl;
+                return false;
+            }
+            if ( arg == "--samples" )
+                cfg.samples = value;
+            else if ( arg == "--writers" )
+                cfg.writers = value;
+            else if ( arg == "--buffer-size" )
+                cfg.buffer_size = value;
+            else {
+                cerr << "Unknown option " << arg << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int ORO_main(int argc, char** argv)
+{
+    BenchConfig cfg;
+    if ( !parseArgs(argc, argv, cfg) ) {
+        cerr << "Usage: " << argv[0] << " [--samples N] [--writers N] [--buffer-size N]" << endl;
+        return 1;
+    }
+
+    vector<string> results;
+    runAll<double>(cfg, sizeof(double), results);
+    runAll< vector<double> >(cfg, 1024, results);
+    runAll< vector<double> >(cfg, 64 * 1024, results);
+    runAll< vector<double> >(cfg, 1024 * 1024, results);
+
+    cout << "{\"benchmark\": \"dataflow\", \"samples\": " << cfg.samples
+         << ", \"max_writers\": " << cfg.writers << ", \"buffer_size\": " << cfg.buffer_size
+         << ", \"results\": [" << endl;
+    for (unsigned int i = 0; i != results.size(); ++i)
+        cout << "  " << results[i] << ( i + 1 != results.size() ? "," : "" ) << endl;
+    cout << "]}" << endl;
+    return 0;
+}
@@ -22,9 +22,12 @@
 #include "logger_test.hpp"
 
 #include <iostream>
+#include <sstream>
 #include <boost/scoped_ptr.hpp>
 #include <Activity.hpp>
 #include <base/RunnableInterface.hpp>
+#include <os/MainThread.hpp>
+#include <os/Atomic.hpp>
 
 using namespace boost;
 using namespace std;
@@ -63,6 +66,27 @@ struct TestLog
   }
 };
 
+struct AsyncTestLog
+  : public RunnableInterface
+{
+  std::string module;
+  int count;
+  os::AtomicInt done;
+
+  AsyncTestLog(const std::string& module, int count) : module(module), count(count), done(0) {}
+
+  bool initialize() { return true; }
+
+  void step() {
+      Logger::In in(module);
+      for (int i = 0; i != count; ++i)
+          log(Warning) << "Line " << i << " of " << module << endlog();
+      done.set(1);
+  }
+
+  void finalize() {}
+};
+
 
 BOOST_FIXTURE_TEST_SUITE( LoggerTestSuite, LoggerTest )
 
@@ -118,4 +142,88 @@ BOOST_AUTO_TEST_CASE( testThreadLog )
 
 }
 
+BOOST_AUTO_TEST_CASE( testAsyncLog )
+{
+    std::stringstream out;
+    Logger::LogLevel level = logger->getLogLevel();
+    logger->setLogLevel( Logger::Warning );
+    logger->setStdStream( out );
+    logger->setAsynchronous( true );
+    BOOST_CHECK( logger->isAsynchronous() );
+
+    for (int i = 0; i != 100; ++i)
+        log(Warning) << "Async line " << i << endlog();
+    logger->setAsynchronous( false );
+    BOOST_CHECK( !logger->isAsynchronous() );
+    BOOST_CHECK_EQUAL( logger->getDroppedMessages(), 0u );
+
+    // All lines were written, in order.
+    std::string::size_type pos = 0;
+    for (int i = 0; i != 100; ++i) {
+        std::stringstream line;
+        line << "[ Warning][Logger] Async line " << i << "\n";
+        pos = out.str().find( line.str(), pos );
+        BOOST_REQUIRE_MESSAGE( pos != std::string::npos, "Missing: " << line.str() );
+    }
+
+    // Each line of a burst is either written or counted as dropped.
+    out.str("");
+    logger->setAsynchronous( true );
+    for (int i = 0; i != 2000; ++i)
+        log(Warning) << "Async burst" << endlog();
+    logger->setAsynchronous( false );
+    logger->setStdStream( std::cerr );
+    logger->setLogLevel( level );
+
+    unsigned int written = 0;
+    std::string text = out.str();
+    for (pos = text.find("Async burst\n"); pos != std::string::npos; pos = text.find("Async burst\n", pos + 1))
+        ++written;
+    BOOST_CHECK_EQUAL( written + logger->getDroppedMessages(), 2000u );
+    if ( logger->getDroppedMessages() )
+        BOOST_CHECK( text.find("log messages because the log buffer was full") != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( testAsyncLogThreads )
+{
+    std::stringstream out;
+    Logger::LogLevel level = logger->getLogLevel();
+    logger->setLogLevel( Logger::Warning );
+    logger->setStdStream( out );
+    logger->setAsynchronous( true );
+    unsigned int dropped = logger->getDroppedMessages();
+
+    // Each thread composes its own lines, in its own module.
+    AsyncTestLog run1("Async1", 100), run2("Async2", 100);
+    Activity t1(ORO_SCHED_OTHER, 0, 0, &run1, "AsyncLog1");
+    Activity t2(ORO_SCHED_OTHER, 0, 0, &run2, "AsyncLog2");
+    BOOST_REQUIRE( t1.start() );
+    BOOST_REQUIRE( t2.start() );
+    while ( run1.done.read() == 0 || run2.done.read() == 0 )
+        os::MainThread::Instance()->yield();
+
+    // The stream state of a thread carries over within its line.
+    log(Warning) << std::hex << 255 << std::dec << " " << 10 << endlog();
+
+    logger->setAsynchronous( false );
+    logger->setStdStream( std::cerr );
+    logger->setLogLevel( level );
+    BOOST_CHECK( t1.stop() );
+    BOOST_CHECK( t2.stop() );
+    BOOST_REQUIRE_EQUAL( logger->getDroppedMessages(), dropped );
+
+    std::string text = out.str();
+    const char* modules[] = { "Async1", "Async2" };
+    for (int m = 0; m != 2; ++m) {
+        std::string::size_type pos = 0;
+        for (int i = 0; i != 100; ++i) {
+            std::stringstream line;
+            line << "[ Warning][" << modules[m] << "] Line " << i << " of " << modules[m] << "\n";
+            pos = text.find( line.str(), pos );
+            BOOST_REQUIRE_MESSAGE( pos != std::string::npos, "Missing: " << line.str() );
+        }
+    }
+    BOOST_CHECK( text.find("[ Warning][Logger] ff 10\n") != std::string::npos );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
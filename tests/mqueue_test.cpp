@@ -24,6 +24,7 @@
 #include <transports/mqueue/MQLib.hpp>
 #include <transports/mqueue/MQChannelElement.hpp>
 #include <transports/mqueue/MQTemplateProtocol.hpp>
+#include <transports/mqueue/ShmRing.hpp>
 #include <os/fosi.h>
 
 using namespace std;
@@ -34,6 +35,7 @@ using namespace RTT::detail;
 #include <OutputPort.hpp>
 #include <TaskContext.hpp>
 #include <string>
+#include <sstream>
 
 using namespace RTT;
 using namespace RTT::detail;
@@ -286,6 +288,66 @@ BOOST_AUTO_TEST_CASE( testPortStreams )
     testPortDisconnected();
 }
 
+BOOST_AUTO_TEST_CASE( testShmStreams )
+{
+    // The same streams, over a shared memory ring instead of a message queue.
+    policy.transport = ORO_SHM_PROTOCOL_ID;
+
+    policy.type = ConnPolicy::DATA;
+    policy.pull = false;
+    policy.name_id = "/shmdata1";
+    BOOST_REQUIRE( mw1->createStream( policy ) );
+    BOOST_REQUIRE( mr2->createStream( policy ) );
+    testPortDataConnection();
+    mw1->disconnect();
+    mr2->disconnect();
+    testPortDisconnected();
+
+    policy.type = ConnPolicy::BUFFER;
+    policy.pull = false;
+    policy.size = 3;
+    policy.name_id = "/shmbuffer1";
+    BOOST_REQUIRE( mw1->createStream( policy ) );
+    BOOST_REQUIRE( mr2->createStream( policy ) );
+    testPortBufferConnection();
+    mw1->disconnect();
+    mr2->disconnect();
+    testPortDisconnected();
+}
+
+BOOST_AUTO_TEST_CASE( testShmRing )
+{
+    // The slots are rounded up to a power of two and reused in order.
+    mqueue::ShmRing writer, reader;
+    BOOST_REQUIRE( writer.open("/shmring1", 3, sizeof(int)) );
+    BOOST_REQUIRE( reader.open("/shmring1", 3, sizeof(int)) );
+    for (int i = 0; i != 4; ++i) {
+        char* slot = writer.writeSlot();
+        BOOST_REQUIRE( slot );
+        memcpy( slot, &i, sizeof(int) );
+        writer.commitWrite( sizeof(int) );
+    }
+    BOOST_CHECK( writer.writeSlot() == 0 );
+
+    int length = 0, value = 0;
+    for (int i = 0; i != 1000; ++i) {
+        const char* slot = reader.readSlot(length);
+        BOOST_REQUIRE( slot );
+        BOOST_CHECK_EQUAL( length, int(sizeof(int)) );
+        memcpy( &value, slot, sizeof(int) );
+        BOOST_CHECK_EQUAL( value, i );
+        reader.commitRead();
+        int next = i + 4;
+        char* wslot = writer.writeSlot();
+        BOOST_REQUIRE( wslot );
+        memcpy( wslot, &next, sizeof(int) );
+        writer.commitWrite( sizeof(int) );
+    }
+    BOOST_CHECK( !reader.empty() );
+    reader.close(false);
+    writer.close(true);
+}
+
 BOOST_AUTO_TEST_CASE( testPortStreamsTimeout )
 {
     // Test creating an input stream without an output stream available.
@@ -325,6 +387,55 @@ BOOST_AUTO_TEST_CASE( testPortStreamsWrongName )
     mw2->disconnect();
 }
 
+BOOST_AUTO_TEST_CASE( testManyStreams )
+{
+    // The dispatcher must deliver the data of each queue it monitors.
+    const int streams = 32;
+    std::vector< OutputPort<double>* > writers;
+    std::vector< InputPort<double>* > readers;
+    policy.type = ConnPolicy::DATA;
+    policy.pull = false;
+    for (int i = 0; i != streams; ++i) {
+        std::stringstream name;
+        name << "/many" << i;
+        policy.name_id = name.str();
+        writers.push_back( new OutputPort<double>("mw") );
+        readers.push_back( new InputPort<double>("mr") );
+        BOOST_REQUIRE( writers[i]->createStream( policy ) );
+        BOOST_REQUIRE( readers[i]->createStream( policy ) );
+    }
+
+    for (int i = 0; i != streams; ++i)
+        writers[i]->write( i );
+    usleep(200000);
+
+    double value = -1;
+    for (int i = 0; i != streams; ++i) {
+        BOOST_CHECK_EQUAL( readers[i]->read(value), NewData );
+        BOOST_CHECK_EQUAL( value, i );
+    }
+
+    // Removing half of the queues does not disturb the others.
+    for (int i = 0; i < streams; i += 2) {
+        readers[i]->disconnect();
+        writers[i]->disconnect();
+    }
+    for (int i = 1; i < streams; i += 2)
+        writers[i]->write( 2 * i );
+    usleep(200000);
+    for (int i = 1; i < streams; i += 2) {
+        BOOST_CHECK_EQUAL( readers[i]->read(value), NewData );
+        BOOST_CHECK_EQUAL( value, 2 * i );
+    }
+
+    for (int i = 0; i != streams; ++i) {
+        writers[i]->disconnect();
+        readers[i]->disconnect();
+        delete writers[i];
+        delete readers[i];
+    }
+}
+
 // copied from testPortStreams
 BOOST_AUTO_TEST_CASE( testVectorTransport )
 {
@@ -25,6 +25,9 @@
 #include <extras/SequentialActivity.hpp>
 #include <extras/SimulationActivity.hpp>
 #include <extras/SimulationThread.hpp>
+#include <Activity.hpp>
+#include <os/MainThread.hpp>
+#include <os/Atomic.hpp>
 
 #include <boost/function_types/function_type.hpp>
 #include <OperationCaller.hpp>
@@ -58,6 +61,55 @@ public:
 /**
  * Fixture.
  */
+/**
+ * Writes an increasing counter to a port until it is stopped.
+ */
+class PortWriter : public RunnableInterface
+{
+public:
+    OutputPort<int>& port;
+    volatile bool stop;
+    int written;
+
+    PortWriter(OutputPort<int>& port) : port(port), stop(false), written(0) {}
+
+    bool initialize() { stop = false; return true; }
+    void step() {}
+    void loop() {
+        while ( !stop ) {
+            port.write( ++written );
+            getThread()->yield();
+        }
+    }
+    bool breakLoop() { stop = true; return true; }
+    void finalize() {}
+};
+
+/**
+ * Writes \a count increasing values, starting at \a first, to a port.
+ */
+class PortBurstWriter : public RunnableInterface
+{
+public:
+    OutputPort<int>& port;
+    int first;
+    int count;
+    os::AtomicInt done;
+
+    PortBurstWriter(OutputPort<int>& port, int first, int count) : port(port), first(first), count(count), done(0) {}
+
+    bool initialize() { return true; }
+    void step() {
+        for (int i = 0; i != count; ++i) {
+            port.write( first + i );
+            if ( i % 16 == 0 )
+                getThread()->yield();
+        }
+        done.set(1);
+    }
+    void finalize() {}
+};
+
 class PortsTestFixture
 {
 public:
@@ -290,6 +342,103 @@ BOOST_AUTO_TEST_CASE(testPortSimpleConnections)
     BOOST_CHECK( !wp.connected() );
 }
 
+BOOST_AUTO_TEST_CASE(testPortLoanAndReadShared)
+{
+    OutputPort< std::vector<double> > wp("WriterName", false);
+    InputPort< std::vector<double> > rp("ReaderName", ConnPolicy::buffer(4, ConnPolicy::LOCK_FREE));
+    boost::shared_ptr< const std::vector<double> > shared;
+
+    // Not connected: the port loans its own sample.
+    std::vector<double>* loaned = wp.loan();
+    BOOST_REQUIRE( loaned );
+    loaned->assign(3, 1.0);
+    wp.commit();
+    BOOST_CHECK_EQUAL( rp.readShared(shared), NoData );
+
+    BOOST_REQUIRE( wp.createConnection(rp) );
+
+    // The sample is written and read in place.
+    loaned = wp.loan();
+    BOOST_REQUIRE( loaned );
+    loaned->assign(3, 2.0);
+    wp.commit();
+    BOOST_CHECK_EQUAL( rp.readShared(shared), NewData );
+    BOOST_REQUIRE( shared );
+    BOOST_CHECK( shared.get() == loaned );
+    BOOST_CHECK( *shared == std::vector<double>(3, 2.0) );
+
+    // The reader's sample stays valid while others are written and read.
+    boost::shared_ptr< const std::vector<double> > first = shared;
+    wp.write( std::vector<double>(3, 3.0) );
+    BOOST_CHECK_EQUAL( rp.readShared(shared), NewData );
+    BOOST_CHECK( *shared == std::vector<double>(3, 3.0) );
+    BOOST_CHECK( *first == std::vector<double>(3, 2.0) );
+    first.reset();
+
+    // read() and readShared() can be mixed.
+    std::vector<double> value;
+    BOOST_CHECK_EQUAL( rp.read(value), OldData );
+    BOOST_CHECK( value == std::vector<double>(3, 3.0) );
+    wp.write( std::vector<double>(3, 4.0) );
+    BOOST_CHECK_EQUAL( rp.read(value), NewData );
+    BOOST_CHECK_EQUAL( rp.readShared(shared), OldData );
+    BOOST_CHECK( *shared == std::vector<double>(3, 4.0) );
+    BOOST_CHECK_EQUAL( rp.read(value), OldData );
+    BOOST_CHECK( value == std::vector<double>(3, 4.0) );
+    shared.reset();
+    wp.disconnect();
+
+    // Data connections fall back to copying.
+    InputPort< std::vector<double> > dp("DataReader", ConnPolicy::data());
+    BOOST_REQUIRE( wp.createConnection(dp) );
+    loaned = wp.loan();
+    loaned->assign(2, 5.0);
+    wp.commit();
+    BOOST_CHECK_EQUAL( dp.readShared(shared), NewData );
+    BOOST_REQUIRE( shared );
+    BOOST_CHECK( *shared == std::vector<double>(2, 5.0) );
+    BOOST_CHECK_EQUAL( dp.readShared(shared), OldData );
+    BOOST_CHECK( *shared == std::vector<double>(2, 5.0) );
+}
+
+BOOST_AUTO_TEST_CASE(testPortReadMany)
+{
+    OutputPort<int> wp("W", false);
+    InputPort<int> rp("R", ConnPolicy::buffer(8, ConnPolicy::LOCK_FREE));
+    std::vector<int> samples;
+    samples.reserve(8);
+
+    BOOST_CHECK_EQUAL( rp.readMany(samples, 8), 0u );
+    BOOST_REQUIRE( wp.createConnection(rp) );
+    BOOST_CHECK_EQUAL( rp.readMany(samples, 8), 0u );
+
+    for (int i = 0; i != 6; ++i)
+        wp.write(i);
+    BOOST_CHECK_EQUAL( rp.readMany(samples, 4), 4u );
+    BOOST_REQUIRE_EQUAL( samples.size(), 4u );
+    for (int i = 0; i != 4; ++i)
+        BOOST_CHECK_EQUAL( samples[i], i );
+    BOOST_CHECK_EQUAL( rp.readMany(samples, 8), 2u );
+    BOOST_REQUIRE_EQUAL( samples.size(), 2u );
+    BOOST_CHECK_EQUAL( samples[0], 4 );
+    BOOST_CHECK_EQUAL( samples[1], 5 );
+    BOOST_CHECK_EQUAL( rp.readMany(samples, 8), 0u );
+    BOOST_CHECK( samples.empty() );
+
+    // The last sample read is kept as old data.
+    int value = -1;
+    BOOST_CHECK_EQUAL( rp.read(value), OldData );
+    BOOST_CHECK_EQUAL( value, 5 );
+
+    // Data connections return at most one sample.
+    InputPort<int> dp("D", ConnPolicy::data());
+    BOOST_REQUIRE( wp.createConnection(dp) );
+    wp.write(10);
+    BOOST_CHECK_EQUAL( dp.readMany(samples, 8), 1u );
+    BOOST_CHECK_EQUAL( samples[0], 10 );
+    BOOST_CHECK_EQUAL( dp.readMany(samples, 8), 0u );
+}
+
 BOOST_AUTO_TEST_CASE(testPortOneWriterThreeReaders)
 {
     OutputPort<int> wp("W");
@@ -456,6 +605,83 @@ BOOST_AUTO_TEST_CASE(testPortThreeWritersOneReader)
     BOOST_CHECK_EQUAL( rp.read(value), NoData );
 }
 
+BOOST_AUTO_TEST_CASE(testPortConnectWhileWriting)
+{
+    // Connections are added and removed while another thread keeps on writing.
+    OutputPort<int> wp("WriterName");
+    InputPort<int> rp1("ReaderName1", ConnPolicy::data());
+    InputPort<int> rp2("ReaderName2", ConnPolicy::buffer(10));
+    PortWriter writer(wp);
+    Activity activity(ORO_SCHED_OTHER, 0, 0, &writer, "PortWriter");
+    BOOST_REQUIRE( activity.start() );
+
+    for (int i = 0; i != 50; ++i) {
+        BOOST_REQUIRE( wp.createConnection(rp1) );
+        BOOST_REQUIRE( wp.createConnection(rp2) );
+        BOOST_CHECK( wp.connected() );
+
+        int value1 = 0, value2 = 0;
+        for (int tries = 0; tries != 10000 && rp1.read(value1) != NewData; ++tries)
+            os::MainThread::Instance()->yield();
+        for (int tries = 0; tries != 10000 && rp2.read(value2) != NewData; ++tries)
+            os::MainThread::Instance()->yield();
+        BOOST_CHECK( value1 > 0 );
+        BOOST_CHECK( value2 > 0 );
+
+        if (i % 2)
+            rp1.disconnect();
+        else
+            wp.disconnect(&rp1);
+        BOOST_CHECK( !rp1.connected() );
+        wp.disconnect();
+        BOOST_CHECK( !wp.connected() );
+        BOOST_CHECK( !rp2.connected() );
+    }
+
+    BOOST_REQUIRE( activity.stop() );
+    BOOST_CHECK( writer.written > 0 );
+}
+
+BOOST_AUTO_TEST_CASE(testPortTwoThreadsOneWriter)
+{
+    // Any number of threads may write the same output port, also over
+    // a lock-free buffer.
+    const int count = 5000;
+    OutputPort<int> wp("WriterName");
+    InputPort<int> rp("ReaderName", ConnPolicy::buffer(2 * count, ConnPolicy::LOCK_FREE));
+    BOOST_REQUIRE( wp.createConnection(rp) );
+    PortBurstWriter writer1(wp, 0, count);
+    PortBurstWriter writer2(wp, count, count);
+    Activity activity1(ORO_SCHED_OTHER, 0, 0, &writer1, "PortWriter1");
+    Activity activity2(ORO_SCHED_OTHER, 0, 0, &writer2, "PortWriter2");
+    BOOST_REQUIRE( activity1.start() );
+    BOOST_REQUIRE( activity2.start() );
+    while ( writer1.done.read() == 0 || writer2.done.read() == 0 )
+        os::MainThread::Instance()->yield();
+
+    // every sample arrives once, and each writer's samples in order.
+    std::vector<bool> seen(2 * count, false);
+    int last1 = -1, last2 = count - 1;
+    int value = 0, received = 0;
+    while ( rp.read(value) == NewData ) {
+        BOOST_REQUIRE( value >= 0 && value < 2 * count );
+        BOOST_CHECK( !seen[value] );
+        seen[value] = true;
+        if ( value < count ) {
+            BOOST_CHECK( value > last1 );
+            last1 = value;
+        } else {
+            BOOST_CHECK( value > last2 );
+            last2 = value;
+        }
+        ++received;
+    }
+    BOOST_CHECK_EQUAL( received, 2 * count );
+
+    BOOST_REQUIRE( activity1.stop() );
+    BOOST_REQUIRE( activity2.stop() );
+}
+
 BOOST_AUTO_TEST_CASE( testPortObjects)
 {
     OutputPort<double> wp1("Write");
@@ -22,6 +22,7 @@
 
 #include <TaskContext.hpp>
 #include <extras/SlaveActivity.hpp>
+#include <Activity.hpp>
 #include <extras/SequentialActivity.hpp>
 #include <extras/SimulationActivity.hpp>
 #include <extras/SimulationThread.hpp>
@@ -637,6 +638,250 @@ BOOST_AUTO_TEST_CASE( testExecutionEngine)
     tsim->run(0);
 }
 
+struct CountingMessage : public base::DisposableInterface
+{
+    int executed;
+    CountingMessage() : executed(0) {}
+    void executeAndDispose() { ++executed; }
+    void dispose() {}
+    bool isError() const { return false; }
+};
+
+BOOST_AUTO_TEST_CASE( testExecutionEngineWakeups)
+{
+    ExecutionEngine ee(0);
+    SlaveActivity slave(&ee);
+    CountingMessage msg;
+
+    BOOST_CHECK( slave.start() );
+    BOOST_CHECK_EQUAL( ee.getMessageCount(), 0 );
+
+    // A burst of messages wakes up the engine only once.
+    for (int i = 0; i != 10; ++i)
+        BOOST_CHECK( ee.process(&msg) );
+    BOOST_CHECK_EQUAL( ee.getMessageCount(), 10 );
+    BOOST_CHECK_EQUAL( ee.getWakeupCount(), 1 );
+    BOOST_CHECK_EQUAL( ee.getSuppressedWakeupCount(), 9 );
+
+    BOOST_CHECK( slave.execute() );
+    BOOST_CHECK_EQUAL( msg.executed, 10 );
+
+    // Once processed, the next message wakes it up again.
+    BOOST_CHECK( ee.process(&msg) );
+    BOOST_CHECK( ee.process(&msg) );
+    BOOST_CHECK_EQUAL( ee.getMessageCount(), 12 );
+    BOOST_CHECK_EQUAL( ee.getWakeupCount(), 2 );
+    BOOST_CHECK_EQUAL( ee.getSuppressedWakeupCount(), 10 );
+    BOOST_CHECK( slave.execute() );
+    BOOST_CHECK_EQUAL( msg.executed, 12 );
+    BOOST_CHECK( slave.stop() );
+}
+
+BOOST_AUTO_TEST_CASE( testExecutionEngineQueueGrowth)
+{
+    ExecutionEngine ee(0);
+    SlaveActivity slave(&ee);
+    CountingMessage msg;
+
+    BOOST_CHECK( ee.setQueueSize(16, 1) );
+    BOOST_CHECK_EQUAL( ee.getMessageQueueCapacity(), 64u );
+    BOOST_CHECK( slave.start() );
+    BOOST_CHECK( !ee.setQueueSize(16, 1) );
+
+    // A burst larger than the queues is not rejected.
+    for (int i = 0; i != 200; ++i)
+        BOOST_CHECK( ee.process(&msg) );
+    BOOST_CHECK_EQUAL( ee.getPendingMessageCount(), 200 );
+    BOOST_CHECK( ee.getMessageQueueCapacity() >= 200u );
+    BOOST_CHECK( ee.getAllocatedSegmentCount() > 0 );
+    BOOST_CHECK( slave.execute() );
+    BOOST_CHECK_EQUAL( msg.executed, 200 );
+
+    // Later bursts reuse the grown queue.
+    unsigned int allocated = 0;
+    for (int j = 0; j != 3; ++j) {
+        for (int i = 0; i != 200; ++i)
+            BOOST_CHECK( ee.process(&msg) );
+        BOOST_CHECK( slave.execute() );
+        if ( j == 0 )
+            allocated = ee.getAllocatedSegmentCount();
+    }
+    BOOST_CHECK_EQUAL( msg.executed, 800 );
+    BOOST_CHECK_EQUAL( ee.getAllocatedSegmentCount(), allocated );
+    BOOST_CHECK( slave.stop() );
+}
+
+/**
+ * Sends a burst of messages to an engine from its own thread.
+ */
+struct MessageSender : public base::RunnableInterface
+{
+    ExecutionEngine& ee;
+    CountingMessage& msg;
+    int count;
+    os::AtomicInt sent;
+
+    MessageSender(ExecutionEngine& ee, CountingMessage& msg, int count) : ee(ee), msg(msg), count(count), sent(0) {}
+
+    bool initialize() { return true; }
+    void step() {
+        for (int i = 0; i != count; ++i)
+            if ( ee.process(&msg) )
+                sent.inc();
+    }
+    void finalize() {}
+};
+
+BOOST_AUTO_TEST_CASE( testExecutionEngineResizeWhileQueueing)
+{
+    ExecutionEngine ee(0);
+    SlaveActivity slave(&ee);
+    CountingMessage msg;
+    const int count = 20000;
+
+    // Another thread queues messages while the queues are replaced.
+    MessageSender sender(ee, msg, count);
+    Activity act(0, &sender, "MessageSender");
+    BOOST_CHECK( act.start() );
+    for (int i = 0; sender.sent.read() != count; ++i)
+        BOOST_CHECK( ee.setQueueSize(4 + i % 8, 1) );
+    BOOST_CHECK( act.stop() );
+
+    // No message got lost.
+    BOOST_CHECK_EQUAL( ee.getPendingMessageCount(), count );
+    BOOST_CHECK( slave.start() );
+    BOOST_CHECK( slave.execute() );
+    BOOST_CHECK_EQUAL( msg.executed, count );
+    BOOST_CHECK( slave.stop() );
+}
+
+static void noop() {}
+
+struct OrderedMessage : public base::DisposableInterface
+{
+    std::vector<int>* order;
+    int id;
+    bool urgent;
+    OrderedMessage(std::vector<int>* o, int i, bool u = false) : order(o), id(i), urgent(u) {}
+    void executeAndDispose() { order->push_back(id); }
+    void dispose() {}
+    bool isUrgent() const { return urgent; }
+};
+
+BOOST_AUTO_TEST_CASE( testExecutionEngineBudget)
+{
+    ExecutionEngine ee(0);
+    SlaveActivity slave(&ee);
+    std::vector<int> order;
+    std::vector<OrderedMessage> msgs;
+    for (int i = 0; i != 5; ++i)
+        msgs.push_back( OrderedMessage(&order, i) );
+    OrderedMessage urgent(&order, 99, true);
+
+    BOOST_CHECK( slave.start() );
+    ee.setMessageBudget(3);
+    BOOST_CHECK_EQUAL( ee.getMessageBudgetCount(), 3u );
+    for (int i = 0; i != 5; ++i)
+        BOOST_CHECK( ee.process(&msgs[i]) );
+    BOOST_CHECK( ee.process(&urgent) );
+    BOOST_CHECK_EQUAL( ee.getPendingMessageCount(), 6 );
+
+    // The urgent message overtakes the others and the rest is deferred.
+    BOOST_CHECK( slave.execute() );
+    BOOST_REQUIRE_EQUAL( order.size(), 3u );
+    BOOST_CHECK_EQUAL( order[0], 99 );
+    BOOST_CHECK_EQUAL( order[1], 0 );
+    BOOST_CHECK_EQUAL( order[2], 1 );
+    BOOST_CHECK_EQUAL( ee.getPendingMessageCount(), 3 );
+    BOOST_CHECK_EQUAL( ee.getPendingMessageHighWatermark(), 6 );
+    BOOST_CHECK_EQUAL( ee.getDeferredCount(), 1 );
+
+    BOOST_CHECK( slave.execute() );
+    BOOST_REQUIRE_EQUAL( order.size(), 6u );
+    BOOST_CHECK_EQUAL( order[5], 4 );
+    BOOST_CHECK_EQUAL( ee.getPendingMessageCount(), 0 );
+    BOOST_CHECK_EQUAL( ee.getDeferredCount(), 1 );
+    BOOST_CHECK( ee.getMessageWaitStatistics().samples >= 1 );
+
+    ee.resetMessageStatistics();
+    BOOST_CHECK_EQUAL( ee.getPendingMessageHighWatermark(), 0 );
+    BOOST_CHECK_EQUAL( ee.getDeferredCount(), 0 );
+    BOOST_CHECK_EQUAL( ee.getMessageWaitStatistics().samples, 0u );
+    BOOST_CHECK( slave.stop() );
+
+    // The priority class of an operation is kept by its callers.
+    Operation<void(void)> op("op");
+    BOOST_CHECK( !op.isUrgent() );
+    op.urgent().calls( boost::function<void(void)>(&noop), OwnThread );
+    BOOST_CHECK( op.isUrgent() );
+    boost::shared_ptr<base::OperationCallerBase<void(void)> > caller( op.getOperationCaller()->cloneI(0) );
+    BOOST_CHECK( caller->isUrgent() );
+}
+
+BOOST_AUTO_TEST_CASE( testExecutionProfiler)
+{
+    StatesTC task;
+    task.setActivity( new SlaveActivity() );
+    CountingMessage msg;
+
+    // Every component is profiled by default.
+    BOOST_CHECK( task.provides()->hasService("profiler") );
+    BOOST_CHECK( task.engine()->getProfiler().isEnabled() );
+    BOOST_CHECK( task.configure() );
+    BOOST_CHECK( task.start() );
+    for (int i = 0; i != 3; ++i)
+        BOOST_CHECK( task.getActivity()->execute() );
+    BOOST_CHECK( task.engine()->process(&msg) );
+    BOOST_CHECK( task.getActivity()->execute() );
+    BOOST_CHECK_EQUAL( msg.executed, 1 );
+
+    // The hooks and messages are measured by the engine.
+    internal::ExecutionProfiler::Profile p;
+    BOOST_REQUIRE( task.engine()->getProfiler().getProfile("updateHook", p) );
+    BOOST_CHECK_EQUAL( p.count, task.updatecount );
+    BOOST_CHECK( p.min <= p.mean && p.mean <= p.max );
+    BOOST_CHECK( p.last <= p.max );
+    BOOST_REQUIRE( task.engine()->getProfiler().getProfile("prepareUpdateHook", p) );
+    BOOST_CHECK_EQUAL( p.count, task.updatecount );
+    BOOST_REQUIRE( task.engine()->getProfiler().getProfile("messages", p) );
+    BOOST_CHECK_EQUAL( p.count, 1 );
+    BOOST_CHECK( !task.engine()->getProfiler().getProfile("unknown", p) );
+
+    // And reported by the profiler service.
+    OperationCaller<unsigned int(const std::string&)> getCount = task.provides("profiler")->getOperation("getCount");
+    OperationCaller<std::vector<std::string>(void)> getEntries = task.provides("profiler")->getOperation("getEntries");
+    OperationCaller<void(void)> reset = task.provides("profiler")->getOperation("reset");
+    OperationCaller<void(bool)> setEnabled = task.provides("profiler")->getOperation("setEnabled");
+    BOOST_REQUIRE( getCount.ready() && getEntries.ready() && reset.ready() && setEnabled.ready() );
+    BOOST_CHECK_EQUAL( getCount("updateHook"), (unsigned int)task.updatecount );
+    BOOST_CHECK_EQUAL( getEntries().size(), (size_t)internal::ExecutionProfiler::FixedEntries );
+    reset();
+    BOOST_CHECK( task.getActivity()->execute() );
+    BOOST_CHECK_EQUAL( getCount("updateHook"), 1 );
+
+    // The hooks of a child are measured separately.
+    {
+        TaskContext child("child", task.engine());
+        BOOST_CHECK_EQUAL( getEntries().size(), (size_t)internal::ExecutionProfiler::FixedEntries + internal::ExecutionProfiler::HookEntries );
+        BOOST_CHECK( child.configure() );
+        BOOST_CHECK( child.start() );
+        BOOST_CHECK( task.getActivity()->execute() );
+        BOOST_CHECK_EQUAL( getCount("updateHook"), 2 );
+        BOOST_CHECK_EQUAL( getCount("child.prepareUpdateHook"), 1 );
+        BOOST_CHECK_EQUAL( getCount("child.updateHook"), 1 );
+        BOOST_CHECK_EQUAL( getCount("child.errorHook"), 0 );
+        BOOST_CHECK( child.stop() );
+    }
+    BOOST_CHECK_EQUAL( getEntries().size(), (size_t)internal::ExecutionProfiler::FixedEntries );
+
+    // Nothing is measured while disabled.
+    setEnabled(false);
+    BOOST_CHECK( task.getActivity()->execute() );
+    BOOST_CHECK_EQUAL( getCount("updateHook"), 2 );
+    setEnabled(true);
+    BOOST_CHECK( task.stop() );
+}
+
 class calling_error_does_not_override_a_stop_transition_Task : public RTT::TaskContext
 {
 public:
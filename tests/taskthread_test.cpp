@@ -25,9 +25,15 @@
 
 #include <extras/Activities.hpp>
 #include <extras/TimerThread.hpp>
+#include <os/Atomic.hpp>
 #include <extras/SimulationThread.hpp>
 #include <os/MainThread.hpp>
+#include <os/MutexLock.hpp>
+#include <Port.hpp>
+#include <os/fosi_internal_interface.hpp>
 #include <Logger.hpp>
+#include <OperationCaller.hpp>
+#include <sstream>
 #include <rtt-config.h>
 
 using namespace std;
@@ -413,6 +419,266 @@ BOOST_AUTO_TEST_CASE( testSequential )
     BOOST_CHECK( mtask.start() == false );
 }
 
+/**
+ * Checks that its activity is never stepped by two threads at once.
+ */
+struct ExclusiveRunner
+    : public RunnableInterface
+{
+    os::AtomicInt inside, steps, overlaps;
+
+    bool initialize() { return true; }
+    void finalize() {}
+
+    void step() {
+        inside.inc();
+        if ( inside.read() != 1 )
+            overlaps.inc();
+        steps.inc();
+        usleep(100);
+        inside.dec();
+    }
+};
+
+BOOST_AUTO_TEST_CASE( testThreadPool )
+{
+    // Test thread pool activities
+    TestRunner r(true);
+
+    ThreadPoolPtr pool = ThreadPool::Instance(ORO_SCHED_OTHER, os::LowestPriority, 2);
+    BOOST_REQUIRE_EQUAL( pool->size(), 2u );
+    ThreadPoolActivity mtask(pool, &r);
+    BOOST_CHECK( mtask.getThreadPool() == pool );
+    BOOST_CHECK( mtask.isActive() == false );
+    BOOST_CHECK( mtask.isRunning() == false );
+    BOOST_CHECK( mtask.isPeriodic() == false );
+    BOOST_CHECK( mtask.getPeriod() == 0.0 );
+    BOOST_CHECK( mtask.execute() == false );
+    BOOST_CHECK( mtask.trigger() == false );
+    BOOST_CHECK( mtask.thread()->isSelf() == false );
+
+    // starting...
+    BOOST_CHECK( mtask.start() == true );
+    BOOST_CHECK( r.init == true );
+    BOOST_CHECK( mtask.isActive() == true );
+    BOOST_CHECK( mtask.isRunning() == false );
+    BOOST_CHECK( mtask.start() == false );
+
+    // a worker calls step()
+    BOOST_CHECK( mtask.trigger() );
+    for (int i = 0; i != 100 && !r.stepped; ++i)
+        usleep(10000);
+    BOOST_CHECK( r.stepped == true );
+    BOOST_CHECK( r.wasrunning );
+    BOOST_CHECK( r.wasactive );
+
+    // stopping...
+    BOOST_CHECK( mtask.stop() == true );
+    BOOST_CHECK( r.fini == true );
+    BOOST_CHECK( mtask.isRunning() == false );
+    BOOST_CHECK( mtask.isActive() == false );
+    BOOST_CHECK( mtask.stop() == false );
+    BOOST_CHECK( mtask.trigger() == false );
+
+    // Many activities, triggered many times, on fewer workers.
+    // There are more than the queues of both workers hold.
+    const int N = 200;
+    ExclusiveRunner runners[N];
+    ThreadPoolActivity* tasks[N];
+    for (int i = 0; i != N; ++i) {
+        tasks[i] = new ThreadPoolActivity(pool, &runners[i]);
+        BOOST_CHECK( tasks[i]->start() );
+    }
+    for (int j = 0; j != 50; ++j)
+        for (int i = 0; i != N; ++i)
+            tasks[i]->trigger();
+    for (int i = 0; i != N; ++i)
+        for (int k = 0; k != 500 && runners[i].steps.read() == 0; ++k)
+            usleep(10000);
+    for (int i = 0; i != N; ++i) {
+        BOOST_CHECK( tasks[i]->stop() );
+        delete tasks[i];
+        BOOST_CHECK( runners[i].steps.read() >= 1 );
+        BOOST_CHECK_EQUAL( runners[i].overlaps.read(), 0 );
+    }
+
+    // A component on the pool, which is started and stopped from this thread.
+    TaskContext tc("pooled");
+    tc.setActivity( new ThreadPoolActivity(pool) );
+    BOOST_CHECK( tc.start() );
+    BOOST_CHECK( tc.isRunning() );
+    BOOST_CHECK( tc.stop() );
+    BOOST_CHECK( !tc.isRunning() );
+}
+
+/**
+ * A component of a pipeline, which records the order in which
+ * the components of the pipeline are updated.
+ */
+struct PipelineTask
+    : public TaskContext
+{
+    OutputPort<int> out;
+    InputPort<int> in;
+    std::vector<std::string>& trace;
+    os::Mutex& lock;
+
+    PipelineTask(const std::string& name, std::vector<std::string>& t, os::Mutex& m)
+        : TaskContext(name), out("out"), in("in"), trace(t), lock(m)
+    {
+        ports()->addPort(out);
+        ports()->addPort(in);
+    }
+
+    void updateHook() {
+        usleep(100);
+        os::MutexLock locker(lock);
+        trace.push_back( getName() );
+    }
+};
+
+/**
+ * Marks the start of each period in the trace.
+ */
+struct TracingGraph
+    : public ExecutionGraph
+{
+    std::vector<std::string>& trace;
+    os::Mutex& lock;
+
+    TracingGraph(std::vector<std::string>& t, os::Mutex& m)
+        : ExecutionGraph(ORO_SCHED_OTHER, os::LowestPriority, 0.01, 2), trace(t), lock(m)
+    {}
+
+    void step() {
+        {
+            os::MutexLock locker(lock);
+            trace.push_back("|");
+        }
+        ExecutionGraph::step();
+    }
+};
+
+BOOST_AUTO_TEST_CASE( testExecutionGraph )
+{
+    std::vector<std::string> trace;
+    os::Mutex lock;
+    TracingGraph graph(trace, lock);
+    BOOST_CHECK_EQUAL( graph.getWorkerCount(), 2u );
+
+    // a -> b, a -> c, b -> d, c -> d
+    PipelineTask a("a", trace, lock), b("b", trace, lock), c("c", trace, lock), d("d", trace, lock);
+    BOOST_CHECK( a.out.connectTo(&b.in) );
+    BOOST_CHECK( a.out.connectTo(&c.in) );
+    BOOST_CHECK( b.out.connectTo(&d.in) );
+    BOOST_CHECK( c.out.connectTo(&d.in) );
+
+    BOOST_CHECK( graph.addComponent(&d) );
+    BOOST_CHECK( graph.addComponent(&c) );
+    BOOST_CHECK( graph.addComponent(&b) );
+    BOOST_CHECK( graph.addComponent(&a) );
+    BOOST_CHECK( !graph.addComponent(&a) );
+    BOOST_CHECK_EQUAL( graph.size(), 4u );
+    BOOST_CHECK( graph.deriveDependencies() );
+    BOOST_CHECK( !graph.addDependency(&d, &a) );
+
+    std::vector<TaskContext*> schedule = graph.getSchedule();
+    BOOST_REQUIRE_EQUAL( schedule.size(), 4u );
+    BOOST_CHECK( schedule[0] == &a );
+    BOOST_CHECK( schedule[3] == &d );
+
+    BOOST_CHECK( graph.start() );
+    TaskContext late("late");
+    BOOST_CHECK( !graph.addComponent(&late) );
+    BOOST_CHECK( a.start() && b.start() && c.start() && d.start() );
+    usleep(200000);
+    BOOST_CHECK( d.stop() && c.stop() && b.stop() && a.stop() );
+    BOOST_CHECK( graph.stop() );
+
+    // Each period in which all components were running updated a first and d last.
+    os::MutexLock locker(lock);
+    unsigned int periods = 0;
+    trace.push_back("|");
+    for (unsigned int i = 0; i + 6 <= trace.size(); ++i) {
+        if ( trace[i] != "|" || trace[i + 5] != "|" )
+            continue;
+        BOOST_CHECK_EQUAL( trace[i + 1], "a" );
+        BOOST_CHECK_EQUAL( trace[i + 4], "d" );
+        ++periods;
+    }
+    BOOST_CHECK( periods > 5 );
+    BOOST_CHECK( graph.getStatistics(&a).count >= periods );
+    BOOST_CHECK( graph.getStatistics(&d).max >= graph.getStatistics(&d).mean );
+    BOOST_CHECK( graph.getStatistics(&d).mean >= 100000 );
+}
+
+/**
+ * A component which sends an OwnThread operation to itself from
+ * updateHook() and waits for the result, which needs the thread
+ * that updates it to process its messages.
+ */
+struct SelfCallingTask
+    : public TaskContext
+{
+    OperationCaller<int(int)> twice;
+    os::ThreadInterface* graph;
+    // only used in updateHook() and read once the component is stopped.
+    int calls, failures, on_worker;
+
+    SelfCallingTask(const std::string& name, os::ThreadInterface* g)
+        : TaskContext(name), graph(g), calls(0), failures(0), on_worker(0)
+    {
+        addOperation("twice", &SelfCallingTask::doTwice, this, OwnThread);
+        twice = getOperation("twice");
+        twice.setCaller( engine() );
+    }
+
+    int doTwice(int i) { return 2 * i; }
+
+    void updateHook() {
+        usleep(1000);
+        if ( !getActivity()->thread()->isSelf() )
+            ++failures;
+        if ( getActivity()->thread() != graph )
+            ++on_worker;
+        SendHandle<int(int)> h = twice.send(21);
+        if ( h.collect() == SendSuccess && h.ret() == 42 )
+            ++calls;
+        else
+            ++failures;
+    }
+};
+
+BOOST_AUTO_TEST_CASE( testExecutionGraphOwnOperation )
+{
+    ExecutionGraph graph(ORO_SCHED_OTHER, os::LowestPriority, 0.01, 2);
+    const int N = 4;
+    SelfCallingTask* tasks[N];
+    for (int i = 0; i != N; ++i) {
+        std::stringstream name;
+        name << "self" << i;
+        tasks[i] = new SelfCallingTask( name.str(), &graph );
+        BOOST_CHECK( graph.addComponent(tasks[i]) );
+    }
+    BOOST_CHECK( graph.start() );
+    for (int i = 0; i != N; ++i)
+        BOOST_CHECK( tasks[i]->start() );
+    usleep(300000);
+    for (int i = 0; i != N; ++i)
+        BOOST_CHECK( tasks[i]->stop() );
+    BOOST_CHECK( graph.stop() );
+
+    // Independent components were also updated by the workers.
+    int on_worker = 0;
+    for (int i = 0; i != N; ++i) {
+        BOOST_CHECK( tasks[i]->calls > 5 );
+        BOOST_CHECK_EQUAL( tasks[i]->failures, 0 );
+        on_worker += tasks[i]->on_worker;
+        delete tasks[i];
+    }
+    BOOST_CHECK( on_worker > 0 );
+}
+
 BOOST_AUTO_TEST_CASE( testScheduler )
 {
     int rtsched = ORO_SCHED_OTHER;
@@ -460,6 +726,221 @@ BOOST_AUTO_TEST_CASE( testThreadPID )
 }
 #endif
 
+/**
+ * Checks that an Activity runs in a parked thread of the thread cache
+ * and that the thread is parked again when the Activity is destroyed.
+ */
+BOOST_AUTO_TEST_CASE( testThreadCache )
+{
+    if ( !os::Thread::setThreadCache(2) )
+        return; // not supported by this target
+    BOOST_CHECK_EQUAL( os::Thread::getCachedThreadCount(), 2u );
+
+    TestRunner runner(true);
+    Activity* a = new Activity(ORO_SCHED_OTHER, 0, 0.0, &runner, "Cached");
+    BOOST_CHECK_EQUAL( os::Thread::getCachedThreadCount(), 1u );
+    unsigned int pid = a->getPid();
+    BOOST_CHECK( pid );
+    BOOST_CHECK( a->start() );
+    for (int i = 0; i != 100 && !runner.looped; ++i)
+        usleep(10000);
+    BOOST_CHECK( runner.looped );
+    BOOST_CHECK( a->stop() );
+    delete a;
+    BOOST_CHECK_EQUAL( os::Thread::getCachedThreadCount(), 2u );
+
+    // The thread which was parked last is handed out first.
+    a = new Activity(ORO_SCHED_OTHER, 0, 0.0, 0, "Cached");
+    BOOST_CHECK_EQUAL( a->getPid(), pid );
+    delete a;
+
+    BOOST_CHECK( os::Thread::setThreadCache(0) );
+    BOOST_CHECK_EQUAL( os::Thread::getCachedThreadCount(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( testCpuSet )
+{
+    os::CpuSet cpus(0x5u);
+    BOOST_CHECK_EQUAL( cpus.count(), 2u );
+    BOOST_CHECK( cpus.isSet(0) && !cpus.isSet(1) && cpus.isSet(2) );
+    cpus.set(100);
+    BOOST_CHECK( cpus.isSet(100) );
+    BOOST_CHECK( !cpus.fitsMask() );
+    BOOST_CHECK_EQUAL( cpus.toMask(), 0x5u );
+    cpus.clear(100);
+    BOOST_CHECK( cpus.fitsMask() );
+    BOOST_CHECK( cpus == os::CpuSet(0x5u) );
+    BOOST_CHECK( os::CpuSet().empty() );
+
+    // Moving a thread to the CPUs it already runs on always works.
+    os::CpuSet current = t_task_a->getCpuSet();
+    BOOST_CHECK( !current.empty() );
+    BOOST_CHECK( t_task_a->setCpuSet(current) );
+    BOOST_CHECK( t_task_a->getCpuSet() == current );
+    BOOST_CHECK_EQUAL( t_task_a->getCpuSet().toMask(), t_task_a->getCpuAffinity() );
+
+    // NUMA placement
+    BOOST_CHECK_EQUAL( t_task_a->getNumaNode(), -1 );
+    BOOST_CHECK( !t_task_a->setNumaNode(100000) );
+    BOOST_CHECK_EQUAL( t_task_a->getNumaNode(), -1 );
+    os::CpuSet node0;
+    if ( os::rtos_numa_node_cpus(0, node0) == 0 ) {
+        BOOST_CHECK( t_task_a->setNumaNode(0) );
+        BOOST_CHECK_EQUAL( t_task_a->getNumaNode(), 0 );
+        BOOST_CHECK( t_task_a->getCpuSet() == node0 );
+        BOOST_CHECK( t_task_a->setNumaNode(-1) );
+        BOOST_CHECK_EQUAL( t_task_a->getNumaNode(), -1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testJitterStatistics )
+{
+    os::JitterHistogram histogram;
+    for (int i = 1; i <= 100; ++i)
+        histogram.record( i % 2 ? i : -i );
+    histogram.overrun();
+    os::JitterStatistics stats = histogram.getStatistics();
+    BOOST_CHECK_EQUAL( stats.samples, 100ul );
+    BOOST_CHECK_EQUAL( stats.overruns, 1ul );
+    BOOST_CHECK_EQUAL( stats.min, 1 );
+    BOOST_CHECK_EQUAL( stats.max, 100 );
+    BOOST_CHECK_EQUAL( stats.mean, 50 );
+    BOOST_CHECK( stats.p99 >= 99 && stats.p99 <= 100 );
+    histogram.reset();
+    BOOST_CHECK_EQUAL( histogram.getStatistics().samples, 0ul );
+    histogram.record( 1000000 );
+    stats = histogram.getStatistics();
+    BOOST_CHECK_EQUAL( stats.samples, 1ul );
+    BOOST_CHECK_EQUAL( stats.overruns, 0ul );
+    BOOST_CHECK_EQUAL( stats.p99, 1000000 );
+
+    // A periodic thread measures itself.
+    Activity periodic(ORO_SCHED_OTHER, 0, 0.01);
+    BOOST_CHECK_EQUAL( periodic.thread()->getJitterStatistics().samples, 0ul );
+    BOOST_CHECK( periodic.start() );
+    usleep(300000);
+    BOOST_CHECK( periodic.stop() );
+    stats = periodic.thread()->getJitterStatistics();
+    BOOST_CHECK( stats.samples + stats.overruns >= 10 );
+    BOOST_CHECK( stats.min <= stats.mean && stats.mean <= stats.max );
+    BOOST_CHECK( stats.p99 <= stats.max );
+    periodic.thread()->resetJitterStatistics();
+    BOOST_CHECK_EQUAL( periodic.thread()->getJitterStatistics().samples, 0ul );
+
+    // Non-periodic threads do not measure anything.
+    BOOST_CHECK_EQUAL( MainThread::Instance()->getJitterStatistics().samples, 0ul );
+}
+
+/**
+ * A periodic activity which takes longer than its deadline
+ * every other step.
+ */
+struct SlowStep : public Activity
+{
+    int steps;
+    SlowStep() : Activity(ORO_SCHED_OTHER, 0, 0.01), steps(0) {}
+    void step() {
+        if ( ++steps % 2 == 0 )
+            usleep(5000);
+    }
+};
+
+BOOST_AUTO_TEST_CASE( testDeadline )
+{
+    SlowStep periodic;
+    BOOST_CHECK_EQUAL( periodic.getDeadlineRuntime(), 0.0 );
+    BOOST_CHECK_EQUAL( periodic.getDeadline(), 0.01 );
+    BOOST_CHECK( periodic.isDeadlineScheduled() == false );
+
+    // the runtime must fit in the deadline, which must fit in the period.
+    BOOST_CHECK( periodic.setDeadline(0.003, 0.002) == false );
+    BOOST_CHECK( periodic.setDeadline(0.001, 0.02) == false );
+    BOOST_CHECK( periodic.setDeadline(0.02) == false );
+    BOOST_CHECK( periodic.setDeadline(0.001, 0.002) );
+    BOOST_CHECK_EQUAL( periodic.getDeadlineRuntime(), 0.001 );
+    BOOST_CHECK_EQUAL( periodic.getDeadline(), 0.002 );
+
+    // Whether the kernel accepts them depends on our privileges, but the
+    // misses are counted anyway.
+    BOOST_CHECK( periodic.start() );
+    usleep(200000);
+    BOOST_CHECK( periodic.stop() );
+    BOOST_CHECK( periodic.getDeadlineMisses() >= 1 );
+    BOOST_CHECK( int(periodic.getDeadlineMisses()) <= periodic.steps );
+    periodic.resetDeadlineMisses();
+    BOOST_CHECK_EQUAL( periodic.getDeadlineMisses(), 0u );
+
+    // back to the normal scheduler.
+    BOOST_CHECK( periodic.setDeadline(0.0) );
+    BOOST_CHECK( periodic.start() );
+    usleep(50000);
+    BOOST_CHECK( periodic.stop() );
+    BOOST_CHECK( periodic.isDeadlineScheduled() == false );
+}
+
+/**
+ * Records when it is stepped and optionally takes some time.
+ */
+struct PhaseRunner
+    : public RunnableInterface
+{
+    std::vector<nsecs> stamps;
+    useconds_t delay;
+    volatile bool inside;
+    PhaseRunner(useconds_t d = 0) : delay(d), inside(false) { stamps.reserve(100); }
+    bool initialize() { return true; }
+    void step() {
+        inside = true;
+        if ( stamps.size() != stamps.capacity() )
+            stamps.push_back( rtos_get_time_ns() );
+        if ( delay )
+            usleep(delay);
+        inside = false;
+    }
+    void finalize() {}
+};
+
+BOOST_AUTO_TEST_CASE( testTimerThreadPhases )
+{
+    TimerThreadPtr timer( new TimerThread(ORO_SCHED_OTHER, 0, "phased", 0.1) );
+    BOOST_CHECK_EQUAL( timer->getPhases(), 1u );
+    BOOST_CHECK( timer->setPhases(0) == false );
+    BOOST_CHECK( timer->setPhases(2) );
+    BOOST_CHECK( timer->setWorkers(1) );
+    BOOST_CHECK_EQUAL( timer->getWorkers(), 1u );
+
+    PhaseRunner first, second, slow(30000);
+    PeriodicActivity a1(timer, &first), a2(timer, &second), a3(timer, &slow);
+
+    // activities are spread over the phases.
+    BOOST_CHECK( a1.start() );
+    BOOST_CHECK( a2.start() );
+    BOOST_CHECK_EQUAL( timer->getPhase(&a1), 0 );
+    BOOST_CHECK_EQUAL( timer->getPhase(&a2), 1 );
+    BOOST_CHECK( timer->setWorkers(2) == false );
+    usleep(550000);
+    BOOST_CHECK( a2.stop() );
+    BOOST_CHECK( a1.stop() );
+    BOOST_CHECK_EQUAL( timer->getPhase(&a1), -1 );
+
+    // the second phase starts half a period later.
+    BOOST_REQUIRE( first.stamps.size() >= 3 && second.stamps.size() >= 3 );
+    nsecs offset = second.stamps[1] - first.stamps[1];
+    BOOST_CHECK( offset >= 30000000 && offset < 70000000 );
+
+    // removing an activity does not wait for a slow one.
+    first.stamps.clear();
+    BOOST_CHECK( a3.start() );
+    BOOST_CHECK( a1.start() );
+    BOOST_CHECK_EQUAL( timer->getPhase(&a3), 0 );
+    while ( !slow.inside )
+        usleep(1000);
+    BOOST_CHECK( a1.stop() );
+    BOOST_CHECK( slow.inside );
+    BOOST_CHECK( a3.stop() );
+    BOOST_CHECK( !slow.inside );
+}
+
 #if !defined( OROCOS_TARGET_WIN32 )
 BOOST_AUTO_TEST_CASE( testThreadConfig )
 {
@@ -0,0 +1,162 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 05:27:03 UTC 2026  thread_bench.cpp
+
+                        thread_bench.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/**
+ * Micro-benchmark of the life cycle of an Activity.
+ *
+ * An Activity is created, started, stopped and destroyed --iterations times,
+ * first with new threads only and then with a cache of --cache parked threads
+ * (see os::Thread::setThreadCache()). The mean and maximum latency of each
+ * step are printed on stdout as one JSON document, such that runs of
+ * different commits can be compared by a script.
+ *
+ * Usage: thread-bench [--iterations N] [--cache N]
+ */
+
+#include <os/main.h>
+#include <os/Thread.hpp>
+#include <os/TimeService.hpp>
+#include <Activity.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+using namespace RTT;
+using namespace RTT::os;
+
+namespace {
+
+    inline TimeService::nsecs now_ns() {
+        return TimeService::ticks2nsecs( TimeService::Instance()->getTicks() );
+    }
+
+    /**
+     * Mean and maximum of one step of the life cycle.
+     */
+    struct Step
+    {
+        TimeService::nsecs total;
+        TimeService::nsecs max;
+
+        Step() : total(0), max(0) {}
+
+        void record(TimeService::nsecs start)
+        {
+            TimeService::nsecs elapsed = now_ns() - start;
+            total += elapsed;
+            if ( elapsed > max )
+                max = elapsed;
+        }
+
+        string json(const char* name, int iterations) const
+        {
+            stringstream ss;
+            ss << "\"" << name << "_ns\": " << double(total) / iterations
+               << ", \"" << name << "_max_ns\": " << max;
+            return ss.str();
+        }
+    };
+
+    /**
+     * Measures create, start, stop and destroy of \a iterations
+     * non periodic Activities while \a cache threads are kept parked.
+     * @return the JSON object describing the result.
+     */
+    string run(int iterations, unsigned int cache)
+    {
+        if ( !Thread::setThreadCache(cache) && cache != 0 )
+            cerr << "No thread cache on this target, measuring new threads." << endl;
+
+        Step create, start, stop, destroy;
+        for (int i = 0; i != iterations; ++i) {
+            TimeService::nsecs t = now_ns();
+            Activity* a = new Activity(ORO_SCHED_OTHER, 0, 0.0, 0, "Bench");
+            create.record(t);
+
+            t = now_ns();
+            a->start();
+            start.record(t);
+
+            t = now_ns();
+            a->stop();
+            stop.record(t);
+
+            t = now_ns();
+            delete a;
+            destroy.record(t);
+        }
+        Thread::setThreadCache(0);
+
+        stringstream ss;
+        ss << "{\"cache\": " << cache << ", "
+           << create.json("create", iterations) << ", "
+           << start.json("start", iterations) << ", "
+           << stop.json("stop", iterations) << ", "
+           << destroy.json("destroy", iterations)
+           << "}";
+        return ss.str();
+    }
+
+    bool parseArgs(int argc, char** argv, int& iterations, int& cache)
+    {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if ( i + 1 >= argc ) {
+                cerr << "Missing value for " << arg << endl;
+                return false;
+            }
+            int value = atoi( argv[++i] );
+            if ( value <= 0 ) {
+                cerr << "Invalid value for " << arg << ": " << argv[i] << endl;
+                return false;
+            }
+            if ( arg == "--iterations" )
+                iterations = value;
+            else if ( arg == "--cache" )
+                cache = value;
+            else {
+                cerr << "Unknown option " << arg << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int ORO_main(int argc, char** argv)
+{
+    int iterations = 1000;
+    int cache = 8;
+    if ( !parseArgs(argc, argv, iterations, cache) ) {
+        cerr << "Usage: " << argv[0] << " [--iterations N] [--cache N]" << endl;
+        return 1;
+    }
+
+    string uncached = run(iterations, 0);
+    string cached = run(iterations, cache);
+
+    cout << "{\"benchmark\": \"thread\", \"iterations\": " << iterations
+         << ", \"results\": [" << endl;
+    cout << "  " << uncached << "," << endl;
+    cout << "  " << cached << endl;
+    cout << "]}" << endl;
+    return 0;
+}
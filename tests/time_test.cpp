@@ -297,6 +297,35 @@ BOOST_AUTO_TEST_CASE( testTimerPeriod )
     BOOST_CHECK( timer.occured.size() == 0 );
 }
 
+BOOST_AUTO_TEST_CASE( testTimerMany )
+{
+    TestTimer timer;
+    timer.setMaxTimers( 1000 );
+    // Arm in reverse order of expiry, at deadlines 1ms apart. The waits are
+    // computed from one start time, so the deadlines do not depend on how
+    // long the arming loop takes.
+    TimeService::nsecs start = TimeService::Instance()->getNSecs();
+    for (int i = 0; i != 1000; ++i) {
+        TimeService::nsecs deadline = start + Seconds_to_nsecs( 0.5 + (999 - i) * 0.001 );
+        BOOST_CHECK( timer.arm( i, nsecs_to_Seconds( deadline - TimeService::Instance()->getNSecs() ) ) );
+    }
+    BOOST_CHECK( timer.isArmed( 0 ) );
+    // Killed and re-armed timers must not fire at their old time.
+    for (int i = 0; i < 1000; i += 2)
+        BOOST_CHECK( timer.killTimer( i ) );
+    BOOST_CHECK( timer.arm( 1, 0.05 ) );
+    BOOST_CHECK( !timer.isArmed( 0 ) );
+    BOOST_CHECK( timer.isArmed( 999 ) );
+
+    sleep(2);
+
+    BOOST_REQUIRE_EQUAL( timer.occured.size(), 500u );
+    BOOST_CHECK_EQUAL( timer.occured[0].first, 1 );
+    for (int i = 1; i != 500; ++i)
+        BOOST_CHECK_EQUAL( timer.occured[i].first, 999 - 2 * (i - 1) );
+    BOOST_CHECK( !timer.isArmed( 999 ) );
+}
+
 BOOST_AUTO_TEST_CASE( testTimerWaitFor )
 {
     TestTimer timer;
@@ -0,0 +1,175 @@
+/***************************************************************************
+  tag: agent  Sun Oct 18 01:40:09 UTC 2026  timer_bench.cpp
+
+                        timer_bench.cpp -  description
+                           -------------------
+    begin                : Sun October 18 2026
+    copyright            : (C) 2026 agent
+    email                : agent@local
+
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/**
+ * Micro-benchmark of os::Timer.
+ *
+ * For 10, 1000 and 100000 timers (limited by --max-timers), the mean cost
+ * of arming a timer, re-arming an armed timer (as a watchdog does), killing
+ * it and of handling its expiry in the timer thread is measured. The results
+ * are printed on stdout as one JSON document, such that runs of different
+ * commits can be compared by a script.
+ *
+ * Usage: timer-bench [--max-timers N]
+ */
+
+#include <os/main.h>
+#include <os/Timer.hpp>
+#include <os/TimeService.hpp>
+#include <os/Atomic.hpp>
+#include <os/MainThread.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <vector>
+#include <string>
+
+using namespace std;
+using namespace RTT;
+using namespace RTT::os;
+
+namespace {
+
+    inline TimeService::nsecs now_ns() {
+        return TimeService::ticks2nsecs( TimeService::Instance()->getTicks() );
+    }
+
+    /**
+     * Counts the expired timers and remembers when the last one expired.
+     */
+    struct BenchTimer : public Timer
+    {
+        AtomicInt fired;
+        TimeService::nsecs last;
+
+        BenchTimer(TimerId max_timers, int scheduler)
+            : Timer(max_timers, scheduler, 0), fired(0), last(0)
+        {}
+
+        void timeout(TimerId)
+        {
+            last = now_ns();
+            fired.inc();
+        }
+    };
+
+    /** A cheap, reproducible pseudo-random wait time between \a min and 2 * \a min seconds. */
+    Seconds randomWait(unsigned int& seed, Seconds min)
+    {
+        seed = seed * 1103515245 + 12345;
+        return min + min * ( (seed >> 16) % 1000 ) / 1000.0;
+    }
+
+    double perTimer(TimeService::nsecs elapsed, int timers)
+    {
+        return double(elapsed) / timers;
+    }
+
+    /**
+     * Measures arm, re-arm, kill and expiry for \a timers timers.
+     * @return the JSON object describing the result.
+     */
+    string run(int timers)
+    {
+        unsigned int seed = 42;
+        TimeService::nsecs start;
+
+        // Arm, re-arm and kill without a timer thread, such that only
+        // the bookkeeping of the timer is measured.
+        BenchTimer idle(timers, -1);
+        start = now_ns();
+        for (int i = 0; i != timers; ++i)
+            idle.arm(i, randomWait(seed, 10.0));
+        double arm = perTimer( now_ns() - start, timers );
+
+        start = now_ns();
+        for (int i = 0; i != timers; ++i)
+            idle.arm(i, randomWait(seed, 10.0));
+        double rearm = perTimer( now_ns() - start, timers );
+
+        start = now_ns();
+        for (int i = 0; i != timers; ++i)
+            idle.killTimer(i);
+        double kill = perTimer( now_ns() - start, timers );
+
+        // Let all timers expire at the same moment and measure how long
+        // the timer thread takes to handle them.
+        BenchTimer active(timers, ORO_SCHED_OTHER);
+        TimeService::nsecs target = now_ns() + Seconds_to_nsecs( 0.1 ) + timers * 2000LL;
+        for (int i = 0; i != timers; ++i) {
+            TimeService::nsecs wait = target - now_ns();
+            active.arm(i, wait > 0 ? nsecs_to_Seconds( wait ) : 0.0);
+        }
+        while ( active.fired.read() != timers )
+            MainThread::Instance()->yield();
+        double expire = perTimer( active.last > target ? active.last - target : 0, timers );
+
+        stringstream ss;
+        ss << "{\"timers\": " << timers
+           << ", \"arm_ns\": " << arm
+           << ", \"rearm_ns\": " << rearm
+           << ", \"kill_ns\": " << kill
+           << ", \"expire_ns\": " << expire
+           << "}";
+        return ss.str();
+    }
+
+    bool parseArgs(int argc, char** argv, int& max_timers)
+    {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if ( i + 1 >= argc ) {
+                cerr << "Missing value for " << arg << endl;
+                return false;
+            }
+            int value = atoi( argv[++i] );
+            if ( value <= 0 ) {
+                cerr << "Invalid value for " << arg << ": " << argv[i] << endl;
+                return false;
+            }
+            if ( arg == "--max-timers" )
+                max_timers = value;
+            else {
+                cerr << "Unknown option " << arg << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int ORO_main(int argc, char** argv)
+{
+    int max_timers = 100000;
+    if ( !parseArgs(argc, argv, max_timers) ) {
+        cerr << "Usage: " << argv[0] << " [--max-timers N]" << endl;
+        return 1;
+    }
+
+    vector<string> results;
+    for (int timers = 10; timers <= max_timers; timers *= 100)
+        results.push_back( run(timers) );
+
+    cout << "{\"benchmark\": \"timer\", \"max_timers\": " << max_timers
+         << ", \"results\": [" << endl;
+    for (unsigned int i = 0; i != results.size(); ++i)
+        cout << "  " << results[i] << ( i + 1 != results.size() ? "," : "" ) << endl;
+    cout << "]}" << endl;
+    return 0;
+}